@@ -42,7 +42,8 @@ if(EXISTS "${LLVM_ROOT}")
   endif()
   
   # Use llvm_map_components_to_libnames to get the library list.
-  # We need: Core, IRReader, CodeGen, Support, Target, Linker, Analysis, Passes
+  # We need: Core, IRReader, CodeGen, Support, Target, Linker, Analysis, Passes,
+  # BitWriter (--lto objects)
   llvm_map_components_to_libnames(llvm_libs 
       core
       irreader 
@@ -51,6 +52,7 @@ if(EXISTS "${LLVM_ROOT}")
       native
       linker 
       analysis 
+      bitwriter
       passes
       support
       # Add more components as needed
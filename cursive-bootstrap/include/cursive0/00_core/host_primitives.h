@@ -21,6 +21,7 @@ enum class HostPrim {
   FSWriteFile,
   FSWriteStdout,
   FSWriteStderr,
+  FSFlushStd,
   FSExists,
   FSRemove,
   FSOpenDir,
@@ -43,6 +43,8 @@ struct LinkResult {
 };
 
 std::filesystem::path RuntimeLibPath(const Project& project);
+// Runtime compiled to bitcode (-flto=thin), used by --lto builds if present.
+std::filesystem::path RuntimeBitcodeLibPath(const Project& project);
 std::vector<std::string> RuntimeRequiredSyms();
 
 std::optional<std::filesystem::path> ResolveRuntimeLib(const Project& project);
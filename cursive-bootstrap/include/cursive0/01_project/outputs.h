@@ -31,6 +31,9 @@ std::filesystem::path IRPath(const Project& project,
                              std::string_view emit_ir);
 std::filesystem::path ExePath(const Project& project);
 
+// "none", "thin" or "full".
+std::string_view LtoMode(const Project& project);
+
 std::vector<std::filesystem::path> ObjPaths(const Project& project,
                                             const std::vector<ModuleInfo>& modules);
 std::vector<std::filesystem::path> IRPaths(const Project& project,
@@ -28,6 +28,8 @@ struct Assembly {
   std::string root;
   std::optional<std::string> out_dir;
   std::optional<std::string> emit_ir;
+  // "thin" or "full" when built with --lto; objects are then bitcode.
+  std::optional<std::string> lto;
   std::filesystem::path source_root;
   OutputPaths outputs;
   std::vector<ModuleInfo> modules;
@@ -146,4 +146,17 @@ syntax::ClassDecl BuildExecutionDomainClassDecl();
 bool IsReactorClassPath(const syntax::ClassPath& path);
 syntax::ClassDecl BuildReactorClassDecl();
 
+// Method signature for the Reactor I/O methods (read, write, open_read).
+// run and register are typed against their async argument instead.
+struct ReactorMethodSig {
+  Permission recv_perm;
+  std::vector<syntax::Param> params;
+  TypeRef ret;
+};
+
+std::optional<ReactorMethodSig> LookupReactorMethodSig(std::string_view name);
+
+// Future<T, E> spelled as its expansion Async<(), (), T, E>
+TypeRef MakeFutureType(const TypeRef& value_type, const TypeRef& err_type);
+
 }  // namespace cursive0::analysis
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "cursive0/03_analysis/types/types.h"
@@ -20,10 +24,66 @@ struct VerificationFact {
   std::size_t scope_id;
 };
 
+// Difference constraints x - y <= c over interned terms, with the
+// shortest-path closure kept up to date as constraints are added (O(n^2)
+// per constraint), so entailment queries are a single matrix lookup.
+// Push/Pop undo everything added since the matching Push.
+class DiffConstraintSolver {
+ public:
+  // Adds x - y <= c. Returns false once the constraints are inconsistent.
+  bool Add(std::string_view x, std::string_view y, std::int64_t c);
+  // True if x - y <= c follows from the constraints. Inconsistent
+  // constraint sets entail nothing.
+  bool Entails(std::string_view x, std::string_view y, std::int64_t c) const;
+  bool Consistent() const { return consistent_; }
+
+  void Push();
+  void Pop();
+
+ private:
+  struct Undo {
+    std::uint32_t from;
+    std::uint32_t to;
+    std::int64_t old;
+  };
+  struct Mark {
+    std::size_t undo;
+    std::size_t terms;
+    bool consistent;
+  };
+
+  std::uint32_t Intern(std::string_view term);
+  std::optional<std::uint32_t> Find(std::string_view term) const;
+  std::int64_t& At(std::uint32_t from, std::uint32_t to) {
+    return dist_[static_cast<std::size_t>(from) * stride_ + to];
+  }
+  std::int64_t At(std::uint32_t from, std::uint32_t to) const {
+    return dist_[static_cast<std::size_t>(from) * stride_ + to];
+  }
+
+  std::unordered_map<std::string, std::uint32_t> ids_;
+  std::vector<std::string> terms_;
+  std::vector<std::int64_t> dist_;  // stride_ x stride_, row = from
+  std::size_t stride_ = 0;
+  std::vector<Undo> undo_;
+  std::vector<Mark> marks_;
+  bool consistent_ = true;
+};
+
 // Static proof context
 struct StaticProofContext {
   std::vector<VerificationFact> facts;
   std::size_t current_scope = 0;
+  // Closure of the linear facts, fed by AddFact and used by Ent-Linear.
+  DiffConstraintSolver linear;
+  // Every fact dominates the next one (see FactDominates), so a query that
+  // the newest fact dominates is dominated by all of them.
+  bool facts_ordered = true;
+  struct ScopeMark {
+    std::size_t facts;
+    bool facts_ordered;
+  };
+  std::vector<ScopeMark> scope_marks;  // one per open PushFactScope
 };
 
 // Static proof result
@@ -96,6 +156,37 @@ void AddFact(StaticProofContext& ctx,
              const syntax::ExprPtr& predicate,
              const core::Span& location);
 
+// Adds each conjunct of `expr` (split on &&) as a fact at its own span
+void AddConjunctFacts(StaticProofContext& ctx, const syntax::ExprPtr& expr);
+
+// Scoped facts: PopFactScope drops every fact added since the matching
+// PushFactScope
+void PushFactScope(StaticProofContext& ctx);
+void PopFactScope(StaticProofContext& ctx);
+
+// The proof context of the procedure body being typed. TypeBlockForDecl
+// opens one per body and seeds it with the precondition, and every
+// postcondition check at a return is proved against it, so the linear
+// closure is built once per body instead of once per return. Sessions nest;
+// each thread has its own.
+class ProofSession {
+ public:
+  ProofSession();
+  ~ProofSession();
+
+  ProofSession(const ProofSession&) = delete;
+  ProofSession& operator=(const ProofSession&) = delete;
+
+  StaticProofContext& context() { return ctx_; }
+
+ private:
+  StaticProofContext ctx_;
+  StaticProofContext* prev_ = nullptr;
+};
+
+// Context of the innermost open ProofSession, or nullptr outside one.
+StaticProofContext* CurrentProofContext();
+
 // Check dominance (fact valid at location)
 bool FactDominates(const VerificationFact& fact, const core::Span& location);
 
@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cursive0/03_analysis/keys/key_context.h"
@@ -34,7 +35,29 @@ ConflictResult CheckAcquisitionConflict(const KeyContext& ctx,
                                         KeyAccessMode mode,
                                         const core::Span& span);
 
+// The keys of one block. Its canonical order and conflict index are built
+// on first use and kept, so checking a block against each of its siblings
+// in a parallel region does not redo them.
+class KeyBlock {
+ public:
+  using Keys = std::vector<std::pair<KeyPath, KeyAccessMode>>;
+
+  explicit KeyBlock(Keys keys) : keys_(std::move(keys)) {}
+
+  const Keys& keys() const { return keys_; }
+  const Keys& canonical() const;
+  const KeyPathTrie& index() const;
+
+ private:
+  Keys keys_;
+  mutable std::optional<Keys> canonical_;
+  mutable std::optional<KeyPathTrie> index_;
+};
+
 // Check if two key blocks have conflicting acquisitions
+ConflictResult CheckBlockConflict(const KeyBlock& block1,
+                                  const KeyBlock& block2,
+                                  const core::Span& span);
 ConflictResult CheckBlockConflict(const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys1,
                                   const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys2,
                                   const core::Span& span);
@@ -47,6 +70,7 @@ struct OrderValidation {
   std::vector<KeyPath> suggested_order;
 };
 
+OrderValidation ValidateAcquisitionOrder(const KeyBlock& block);
 OrderValidation ValidateAcquisitionOrder(
     const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys);
 
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cursive0/00_core/span.h"
@@ -44,6 +46,60 @@ struct HeldKey {
   KeyPath path;
   KeyAccessMode mode;
   KeyScopeId scope;
+  std::size_t id = 0;  // KeyPathTrie entry
+};
+
+// Index of keys for overlap queries in O(path length).
+//
+// Segments are interned and each key is inserted along its full path, with
+// per-node read/write counts for the subtree. A key is also anchored at the
+// node of its first boundary segment (or its end), since IsPrefix stops
+// comparing there. IsPrefix(K, P) then means an anchor on P's path with
+// |K| <= |P|, and IsPrefix(P, K) a key in the subtree of P's anchor node.
+class KeyPathTrie {
+ public:
+  using KeyId = std::size_t;
+
+  KeyPathTrie();
+
+  void Insert(KeyId id, const KeyPath& path, KeyAccessMode mode);
+  void Erase(KeyId id, const KeyPath& path, KeyAccessMode mode);
+
+  // Some key K with IsPrefix(K, path) whose mode covers `mode`
+  bool Covers(const KeyPath& path, KeyAccessMode mode) const;
+
+  // Some key K with KeysConflict(K, mode_K, path, mode)
+  bool Conflicts(const KeyPath& path, KeyAccessMode mode) const;
+
+  bool Empty() const { return nodes_[0].reads + nodes_[0].writes == 0; }
+
+ private:
+  struct Anchor {
+    KeyId id;
+    KeyAccessMode mode;
+    std::size_t length;  // |path.segs|
+  };
+  struct Node {
+    std::unordered_map<std::uint64_t, std::uint32_t> children;
+    std::vector<Anchor> anchors;
+    std::size_t depth = 0;   // segments below the root
+    std::size_t reads = 0;   // keys in this subtree
+    std::size_t writes = 0;
+  };
+
+  std::uint64_t Intern(const std::string& name, bool is_index);
+  std::optional<std::uint64_t> Lookup(const std::string& name,
+                                      bool is_index) const;
+  std::uint32_t ChildOrCreate(std::uint32_t node, std::uint64_t key,
+                              KeyAccessMode mode);
+  // Nodes along `path` from its root, stopping at the first missing one
+  std::vector<std::uint32_t> PathNodes(const KeyPath& path) const;
+  bool SubtreeConflicts(std::uint32_t node,
+                        std::size_t min_depth,
+                        KeyAccessMode mode) const;
+
+  std::vector<Node> nodes_;  // nodes_[0] holds the roots
+  std::unordered_map<std::string, std::uint64_t> names_;
 };
 
 // Key context - tracks held keys
@@ -64,6 +120,11 @@ class KeyContext {
   
   // Check if a path is covered by held keys
   bool Covers(const KeyPath& path, KeyAccessMode mode) const;
+
+  // Check if any held key conflicts with (path, mode)
+  bool ConflictsWith(const KeyPath& path, KeyAccessMode mode) const {
+    return index_.Conflicts(path, mode);
+  }
   
   // Get all held keys
   const std::vector<HeldKey>& HeldKeys() const { return held_keys_; }
@@ -73,6 +134,8 @@ class KeyContext {
   
  private:
   std::vector<HeldKey> held_keys_;
+  KeyPathTrie index_;
+  std::size_t next_key_id_ = 0;
   KeyScopeId current_scope_ = 0;
   std::vector<KeyScopeId> scope_stack_;
 };
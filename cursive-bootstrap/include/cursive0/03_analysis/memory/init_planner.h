@@ -22,6 +22,10 @@ struct InitPlan {
   InitGraph graph;
   std::vector<syntax::ModulePath> init_order;
   bool topo_ok = false;
+  // Per graph.modules entry: neither the module's static initializers nor
+  // those of any module it eagerly depends on can panic, so its poison flag
+  // is never set and accesses need no poison check.
+  std::vector<bool> poison_free;
 };
 
 struct InitPlanResult {
@@ -35,7 +35,9 @@ std::optional<std::string_view> DiscTypeName(std::uint64_t max_disc);
 std::optional<std::pair<std::uint64_t, std::uint64_t>> DiscTypeLayout(
     std::uint64_t max_disc);
 
-// Compute sizeof for a type
+// Compute sizeof for a type. Declared records and enums defer to
+// codegen::RecordDeclLayoutOf / EnumLayoutOf, so field reordering and enum
+// niches are seen here exactly as they are emitted.
 std::optional<std::uint64_t> SizeOf(const ScopeContext& ctx,
                                     const TypeRef& type);
 
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "cursive0/03_analysis/types/context.h"
+#include "cursive0/03_analysis/types/subtyping.h"
+#include "cursive0/03_analysis/types/type_equiv.h"
+#include "cursive0/03_analysis/types/types.h"
+
+namespace cursive0::analysis {
+
+// Memo tables for TypeEquiv and Subtyping, live while a session is open
+// (TypecheckModules opens one).
+//
+// Types are not interned, so results are keyed by structural fingerprints
+// of both operands: separately built copies of a type share an entry. A
+// fingerprint covers every field of the type (refinement predicates and
+// opaque origins by identity), so a hit answers exactly what the uncached
+// query would; Subtyping keys also include the Sigma it consulted, which
+// must stay fixed for the session. Each thread has its own tables.
+//
+// CURSIVE0_NO_TYPE_MEMO disables the tables, as does spec tracing (hits
+// skip the rules' trace records). CURSIVE0_TYPE_MEMO_STATS prints hit
+// counts when the session closes.
+class TypeMemoSession {
+ public:
+  TypeMemoSession();
+  ~TypeMemoSession();
+
+  TypeMemoSession(const TypeMemoSession&) = delete;
+  TypeMemoSession& operator=(const TypeMemoSession&) = delete;
+
+ private:
+  bool active_ = false;
+};
+
+using TypeEquivFn = TypeEquivResult (*)(const TypeRef&, const TypeRef&);
+using SubtypingFn = SubtypingResult (*)(const ScopeContext&,
+                                        const TypeRef&,
+                                        const TypeRef&);
+
+// compute(lhs, rhs), answered from the session tables when possible
+TypeEquivResult MemoTypeEquiv(const TypeRef& lhs,
+                              const TypeRef& rhs,
+                              TypeEquivFn compute);
+SubtypingResult MemoSubtyping(const ScopeContext& ctx,
+                              const TypeRef& lhs,
+                              const TypeRef& rhs,
+                              SubtypingFn compute);
+
+}  // namespace cursive0::analysis
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string_view>
 #include <string>
@@ -23,10 +26,85 @@ struct TypeBinding {
   TypeRef type;
 };
 
-using TypeScope = std::unordered_map<IdKey, TypeBinding>;
-
-struct TypeEnv {
-  std::vector<TypeScope> scopes;
+// Typing environment: a stack of lexical scopes mapping names to bindings.
+//
+// Bindings live on one flat stack with a name -> newest-entry index, so a
+// lookup is a hash probe instead of a walk over every open scope. Entries are
+// shared between copies: a copy is a (store, length, scope marks) view, so
+// the checkpoint-per-statement and per-branch copies made while typing are
+// O(depth) instead of O(bindings). The store counts its live views by
+// length; appending from a view that is not the tip (the normal state after
+// a scope pop) truncates the entries no live view can see, and forks the
+// store only when a longer view is still alive.
+class TypeEnv {
+ public:
+  TypeEnv() = default;
+  TypeEnv(const TypeEnv& other);
+  TypeEnv(TypeEnv&& other) noexcept;
+  TypeEnv& operator=(const TypeEnv& other);
+  TypeEnv& operator=(TypeEnv&& other) noexcept;
+  ~TypeEnv();
+
+  // Number of open scopes.
+  std::size_t Depth() const { return marks_.size(); }
+  bool Empty() const { return marks_.empty(); }
+
+  void PushScope();
+  void PopScope();
+
+  // Binds `key` in the innermost scope, replacing any binding it already
+  // has there. Opens a scope first if none is open.
+  void Bind(const IdKey& key, const TypeBinding& binding);
+  // Replaces the visible binding of `key` in whichever scope holds it.
+  // Returns false if `key` is unbound.
+  bool Rebind(const IdKey& key, const TypeBinding& binding);
+
+  // Newest visible binding for `key`, or nullptr.
+  const TypeBinding* Find(const IdKey& key) const;
+  // `key` is bound in the innermost scope.
+  bool InInnermost(const IdKey& key) const;
+  // `key` is bound in some scope other than the innermost one.
+  bool InOuter(const IdKey& key) const;
+  // Index (0 = outermost) of the scope holding the visible binding of `key`.
+  std::optional<std::size_t> ScopeOf(const IdKey& key) const;
+  // Visits the live bindings of scope `scope` (0 = outermost) oldest first.
+  void ForEachBinding(
+      std::size_t scope,
+      const std::function<void(const IdKey&, const TypeBinding&)>& fn) const;
+
+ private:
+  static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+  struct Entry {
+    IdKey key;
+    TypeBinding binding;
+    std::size_t prev = kNone;  // older entry with the same key
+  };
+
+  struct Store {
+    std::vector<Entry> entries;
+    std::unordered_map<IdKey, std::size_t> newest;
+    std::vector<std::uint32_t> views;  // live views by length
+  };
+
+  // Register / unregister this view at its current length.
+  void Attach();
+  void Detach();
+  // Moves this view to length `len`.
+  void SetLen(std::size_t len);
+  // Some other live view sees entries at or past len_.
+  bool TailObserved() const;
+  // Drops the entries at and past len_ (none may be observed).
+  void Truncate();
+  // Gives this view a store no other copy can observe.
+  void Unshare();
+  // Newest entry for `key` below `limit`, or kNone.
+  std::size_t EntryBelow(const IdKey& key, std::size_t limit) const;
+  std::size_t ScopeStart() const { return marks_.empty() ? 0 : marks_.back(); }
+
+  std::shared_ptr<Store> store_;
+  std::size_t len_ = 0;
+  std::vector<std::size_t> marks_;  // entry index where each scope begins
 };
 
 TypeEnv PushScope(const TypeEnv& env);
@@ -9,4 +9,27 @@ constexpr std::uint64_t kAsyncFrameResumeFnOffset = 8;
 constexpr std::uint64_t kAsyncFrameHeaderSize = 16;
 constexpr std::uint64_t kAsyncFrameHeaderAlign = 8;
 
+// Frame pool size classes. Class k holds frames of up to
+// kAsyncFrameClassMin << k bytes with alignment at most kAsyncFrameClassAlign.
+// Mirrored by C0_FRAME_CLASS_* in runtime/src/async.c.
+constexpr std::uint64_t kAsyncFrameClassMin = 64;
+constexpr std::uint64_t kAsyncFrameClassCount = 8;
+constexpr std::uint64_t kAsyncFrameClassAlign = 16;
+constexpr std::uint64_t kAsyncFrameNoClass = ~std::uint64_t{0};
+
+// Size-class hint passed to alloc_frame; kAsyncFrameNoClass when the frame is
+// too large or over-aligned for the pool.
+constexpr std::uint64_t AsyncFrameSizeClass(std::uint64_t size,
+                                            std::uint64_t align) {
+  if (align > kAsyncFrameClassAlign) {
+    return kAsyncFrameNoClass;
+  }
+  for (std::uint64_t k = 0; k < kAsyncFrameClassCount; ++k) {
+    if (size <= (kAsyncFrameClassMin << k)) {
+      return k;
+    }
+  }
+  return kAsyncFrameNoClass;
+}
+
 }  // namespace cursive0::codegen
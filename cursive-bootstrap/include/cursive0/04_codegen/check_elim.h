@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+#include "cursive0/04_codegen/ir_model.h"
+#include "cursive0/02_syntax/ast.h"
+
+namespace cursive0::codegen {
+
+struct LowerCtx;
+
+// Counts for one procedure, printed when CURSIVE0_CHECK_ELIM_STATS is set.
+struct CheckElimStats {
+  std::size_t checks = 0;         // IRCheckIndex/Range/SliceLen/Op visited
+  std::size_t removed = 0;        // checks proven and dropped
+  std::size_t unchecked_ops = 0;  // IRBinaryOp marked unchecked
+};
+
+// Check elimination over a lowered procedure body, run before LLVM emission.
+//
+// Tracks integer intervals for stable values (immediates, non-escaping
+// locals and single-assignment temps) from literals, branch and loop
+// conditions, the procedure precondition and earlier checks. Checks the
+// facts prove are removed together with their PanicCheck, repeated checks on
+// the same operands are removed, and +, -, * whose result range fits the
+// operand type are marked IRBinaryOp::unchecked.
+//
+// The precondition is only assumed once control has passed `entry_check`, the
+// [[dynamic]] entry check emitted for it; callers pass null for both when the
+// procedure has no such check, since nothing else enforces the precondition
+// inside the callee.
+CheckElimStats EliminateChecks(ProcIR& proc,
+                               const LowerCtx& ctx,
+                               const syntax::ExprPtr& precondition,
+                               const IR* entry_check);
+
+}  // namespace cursive0::codegen
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "cursive0/04_codegen/ir_model.h"
+#include "cursive0/03_analysis/types/context.h"
+#include "cursive0/02_syntax/ast.h"
+
+namespace cursive0::codegen {
+
+struct LowerCtx;
+
+// Compile-time evaluation of a static initializer in scope.current_module.
+//
+// Returns the layout bytes of `type` when the initializer is built only from
+// literals, integer/bool operators on constants, tuples, arrays (including
+// repeats), records, unit enum variants and earlier statics of the same
+// module that were themselves evaluated (LowerCtx::const_statics). Every
+// type involved must be plain data: no pointers, strings, Drop or generic
+// types, and no unique or shared permission. Operations that would panic at
+// runtime (overflow, division by zero, oversized shifts) are not folded, so
+// such initializers keep their runtime behavior.
+std::optional<std::vector<std::uint8_t>> ConstEvalStatic(
+    const syntax::Expr& expr,
+    const analysis::TypeRef& type,
+    const analysis::ScopeContext& scope,
+    const LowerCtx& ctx);
+
+}  // namespace cursive0::codegen
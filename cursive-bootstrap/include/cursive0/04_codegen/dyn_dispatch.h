@@ -107,6 +107,18 @@ DynPackResult DynPack(const analysis::TypeRef& type,
                       const syntax::ClassDecl& class_decl,
                       LowerCtx& ctx);
 
+// ============================================================================
+// Devirtualization
+// ============================================================================
+
+// DispatchSym(T, Cl, method) when T is the only type in the assembly that
+// implements Cl (directly or through a subclass) and T is not generic;
+// empty otherwise.
+std::string SoleDispatchSym(const analysis::TypePath& class_path,
+                            const syntax::ClassDecl& class_decl,
+                            const std::string& method_name,
+                            LowerCtx& ctx);
+
 // ============================================================================
 // §6.10 LowerDynCall - Dynamic dispatch call lowering
 // ============================================================================
@@ -114,8 +126,10 @@ DynPackResult DynPack(const analysis::TypeRef& type,
 // (Lower-DynCall)
 // VSlot(Cl, name) ⇓ i
 // LowerDynCall(base, name, args) ⇓ SeqIR(CallVTable(base, i, args), PanicCheck)
+// The CallVTable carries SoleDispatchSym(Cl, name) as a devirtualization hint.
 LowerResult LowerDynCall(const IRValue& base_ptr,
                          const std::string& vtable_sym,
+                         const analysis::TypePath& class_path,
                          const syntax::ClassDecl& class_decl,
                          const std::string& method_name,
                          const std::vector<IRValue>& args,
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+#include "cursive0/04_codegen/ir_model.h"
+
+namespace cursive0::codegen {
+
+struct LowerCtx;
+
+// Counts for one procedure, printed when CURSIVE0_ESCAPE_STATS is set.
+struct EscapeStats {
+  std::size_t region_allocs = 0;    // IRAlloc and region-provenance bindings seen
+  std::size_t promoted = 0;         // rewritten to entry-block stack slots
+};
+
+// Region allocations whose region is opened by an IRRegion in this same
+// procedure cannot outlive the procedure: region provenance keeps every
+// reference inside the region's scope. When such an allocation also runs at
+// most once per region instance (no loop between the region and the
+// allocation) and is small, it is marked IRAlloc::stack /
+// IRBindVar::stack_slot and emitted as an entry-block alloca instead of a
+// region::alloc call. Region release never drops individual allocations,
+// so the promoted slot needs no cleanup entry.
+//
+// A stack slot carries no region tag and never expires, so nothing is
+// promoted inside an IRFrame, or in a region whose body may mark, reset or
+// free it early; there a deref after the reset must still raise ExpiredDeref.
+EscapeStats PromoteNonEscapingAllocs(ProcIR& proc, const LowerCtx& ctx);
+
+}  // namespace cursive0::codegen
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstddef>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
@@ -19,6 +23,71 @@ namespace cursive0::codegen {
 struct IR;
 using IRPtr = std::shared_ptr<IR>;
 
+// Immediate payload bytes. Payloads up to kInlineSize bytes (every scalar)
+// are stored inline; longer ones (string literals) spill to the heap.
+class IRBytes {
+ public:
+  static constexpr std::size_t kInlineSize = 16;
+
+  IRBytes() = default;
+  IRBytes(std::initializer_list<std::uint8_t> init) { assign(init.begin(), init.end()); }
+  IRBytes(const std::vector<std::uint8_t>& bytes) { assign(bytes.begin(), bytes.end()); }
+
+  IRBytes& operator=(std::initializer_list<std::uint8_t> init) {
+    assign(init.begin(), init.end());
+    return *this;
+  }
+  IRBytes& operator=(std::vector<std::uint8_t> bytes) {
+    if (bytes.size() > kInlineSize) {
+      size_ = bytes.size();
+      heap_ = std::move(bytes);
+    } else {
+      assign(bytes.begin(), bytes.end());
+    }
+    return *this;
+  }
+
+  template <typename It>
+  void assign(It first, It last) {
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    size_ = count;
+    if (count > kInlineSize) {
+      heap_.assign(first, last);
+    } else {
+      heap_.clear();
+      std::copy(first, last, inline_.begin());
+    }
+  }
+  void clear() {
+    size_ = 0;
+    heap_.clear();
+  }
+
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+  const std::uint8_t* data() const {
+    return size_ > kInlineSize ? heap_.data() : inline_.data();
+  }
+  const std::uint8_t* begin() const { return data(); }
+  const std::uint8_t* end() const { return data() + size_; }
+  std::reverse_iterator<const std::uint8_t*> rbegin() const {
+    return std::reverse_iterator<const std::uint8_t*>(end());
+  }
+  std::reverse_iterator<const std::uint8_t*> rend() const {
+    return std::reverse_iterator<const std::uint8_t*>(begin());
+  }
+  std::uint8_t operator[](std::size_t i) const { return data()[i]; }
+
+  operator std::vector<std::uint8_t>() const {
+    return std::vector<std::uint8_t>(begin(), end());
+  }
+
+ private:
+  std::array<std::uint8_t, kInlineSize> inline_{};
+  std::size_t size_ = 0;
+  std::vector<std::uint8_t> heap_;
+};
+
 struct IRValue {
   enum class Kind {
     Opaque,
@@ -28,10 +97,19 @@ struct IRValue {
   };
 
   Kind kind = Kind::Opaque;
-  std::string name;
-  std::vector<std::uint8_t> bytes;
+  std::string name;  // Named (non-temp) values only; empty for temps
+  IRBytes bytes;
+  // Dense temp number from LowerCtx::FreshTempValue (0 = none). Side tables
+  // for temps (value types, derived values, emitted llvm::Value*) are
+  // indexed by it.
+  std::uint32_t id = 0;
+  // Static prefix of a temp; its display name is built by IRValueName.
+  const char* prefix = nullptr;
 };
 
+// Display name of a value: `name`, or "<prefix>_<n>" for temps.
+std::string IRValueName(const IRValue& value);
+
 struct IRPlace {
   std::string repr;
 };
@@ -57,6 +135,7 @@ struct IRCallVTable {
   std::size_t slot = 0;
   std::vector<IRValue> args;
   IRValue result;
+  std::string devirt_sym;  // Sole implementation in the assembly, if any
 };
 
 struct IRStoreGlobal {
@@ -79,6 +158,7 @@ struct IRBindVar {
   analysis::TypeRef type;
   analysis::ProvenanceKind prov = analysis::ProvenanceKind::Bottom;
   std::optional<std::string> prov_region;
+  bool stack_slot = false;  // region slot promoted to the stack (escape.h)
 };
 
 struct IRStoreVar {
@@ -126,6 +206,7 @@ struct IRBinaryOp {
   IRValue lhs;
   IRValue rhs;
   IRValue result;
+  bool unchecked = false;  // +, -, * proven in range by EliminateChecks
 };
 
 struct IRCast {
@@ -174,6 +255,7 @@ struct IRAlloc {
   IRValue value;
   IRValue result;
   analysis::TypeRef type;
+  bool stack = false;  // non-escaping; emitted as an entry-block alloca (escape.h)
 };
 
 struct IRReturn {
@@ -372,6 +454,7 @@ struct IRSync {
   analysis::TypeRef async_type;      // Type of async value
   analysis::TypeRef result_type;     // Result type
   analysis::TypeRef error_type;      // Error type
+  IRPtr wait_ir;                     // Run before each resume (Reactor::run)
 };
 
 // §19.3.4 Race expression IR (first-completion mode)
@@ -494,6 +577,7 @@ struct ProcIR {
 struct GlobalConst {
   std::string symbol;
   std::vector<std::uint8_t> bytes;
+  bool read_only = false;  // immutable static: emitted as an LLVM constant
 };
 
 struct GlobalZero {
@@ -29,9 +29,22 @@ struct RecordLayout {
 
 struct EnumLayout {
   Layout layout;
-  std::string disc_type;
+  std::string disc_type;  // empty for niche layouts
   std::uint64_t payload_size = 0;
   std::uint64_t payload_align = 1;
+  // Offset of each variant's payload, in declaration order.
+  std::vector<std::uint64_t> payload_offsets;
+  // Layout-Enum-Niche: there is no discriminant. Variant niche_variant
+  // holds a valid value in the niche_type field at niche_offset of its
+  // payload; every other variant stores EnumNicheValue there instead. The
+  // niche_variant payload never holds a value in
+  // [niche_start, niche_start + niche_count).
+  bool niche = false;
+  std::size_t niche_variant = 0;
+  std::uint64_t niche_offset = 0;
+  std::string niche_type;
+  std::uint64_t niche_start = 0;
+  std::uint64_t niche_count = 0;
 };
 
 struct UnionLayout {
@@ -79,6 +92,22 @@ std::optional<RecordLayout> RecordLayoutOf(
     const cursive0::analysis::ScopeContext& ctx,
     const std::vector<cursive0::analysis::TypeRef>& fields);
 
+// Whether a declaration keeps the layout its source spells out: built-in
+// declarations (shared with the runtime) and [[layout]], [[packed]],
+// [[align]] or [[ffi_pass_by_value]] ones.
+bool KeepsDeclaredLayout(const cursive0::syntax::AttributeList& attrs,
+                         const cursive0::core::Span& span);
+
+// Layout of a declared record whose field types, in declaration order, are
+// `fields`. When placing the fields by decreasing alignment makes the
+// record smaller, that order is used, unless the record keeps its declared
+// layout or implements FfiSafe (or CURSIVE0_NO_FIELD_REORDER is set).
+// Offsets stay indexed by declaration order either way.
+std::optional<RecordLayout> RecordDeclLayoutOf(
+    const cursive0::analysis::ScopeContext& ctx,
+    const cursive0::syntax::RecordDecl& decl,
+    const std::vector<cursive0::analysis::TypeRef>& fields);
+
 std::optional<RecordLayout> RangeLayoutOf(
     const cursive0::analysis::ScopeContext& ctx);
 
@@ -86,6 +115,13 @@ std::optional<EnumLayout> EnumLayoutOf(
     const cursive0::analysis::ScopeContext& ctx,
     const cursive0::syntax::EnumDecl& decl);
 
+// Niche field value of a variant other than layout.niche_variant.
+std::uint64_t EnumNicheValue(const EnumLayout& layout, std::size_t variant);
+// Variant a niche field value stands for.
+std::size_t EnumVariantOfNiche(const EnumLayout& layout,
+                               std::size_t variant_count,
+                               std::uint64_t value);
+
 std::optional<UnionLayout> UnionLayoutOf(
     const cursive0::analysis::ScopeContext& ctx,
     const cursive0::analysis::TypeUnion& uni);
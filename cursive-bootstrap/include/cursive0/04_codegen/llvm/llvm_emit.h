@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 #include <system_error>
@@ -27,6 +31,9 @@ namespace llvm {
   class FunctionType;
   class AttributeList;
   class SwitchInst;
+  class GlobalVariable;
+  class LoadInst;
+  class MDNode;
 }
 
 namespace cursive0::codegen {
@@ -93,7 +100,14 @@ public:
   std::unique_ptr<llvm::Module> ReleaseModule();
   
   // T-LLVM-011: Call ABI
+  // Results are cached per (param modes, param type refs, return type ref),
+  // so declarations and every call site of a callee share one classification.
   ABICallResult ComputeCallABI(const std::vector<IRParam>& params, analysis::TypeRef ret_type);
+  struct CallABICacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+  };
+  const CallABICacheStats& GetCallABICacheStats() const { return call_abi_stats_; }
 
 
 
@@ -109,20 +123,39 @@ public:
   void RemoveLocal(const std::string& name) { locals_.erase(name); }
   void ClearLocals() { locals_.clear(); }
 
-  // Temporary IRValue materialization cache
+  // Temporary IRValue materialization cache. Numbered temps use a dense
+  // array whose entries are invalidated by bumping the generation.
   void SetTempValue(const IRValue& value, llvm::Value* llvm_value) {
-    if (value.kind == IRValue::Kind::Opaque) {
+    if (value.kind != IRValue::Kind::Opaque) {
+      return;
+    }
+    if (value.id == 0) {
       values_[value.name] = llvm_value;
+      return;
     }
+    if (value.id >= values_by_id_.size()) {
+      values_by_id_.resize(static_cast<std::size_t>(value.id) + 1);
+    }
+    values_by_id_[value.id] = {values_generation_, llvm_value};
   }
   llvm::Value* GetTempValue(const IRValue& value) const {
     if (value.kind != IRValue::Kind::Opaque) {
       return nullptr;
     }
+    if (value.id != 0) {
+      if (value.id >= values_by_id_.size()) {
+        return nullptr;
+      }
+      const auto& slot = values_by_id_[value.id];
+      return slot.first == values_generation_ ? slot.second : nullptr;
+    }
     auto it = values_.find(value.name);
     return it != values_.end() ? it->second : nullptr;
   }
-  void ClearTempValues() { values_.clear(); }
+  void ClearTempValues() {
+    values_.clear();
+    ++values_generation_;
+  }
 
   // Async lowering state (active only while emitting async resume proc)
   void SetAsyncState(AsyncEmitState* state) { async_state_ = state; }
@@ -165,6 +198,24 @@ public:
   llvm::Value* EmitCheckedShl(llvm::Value* lhs, llvm::Value* rhs);
   llvm::Value* EmitCheckedShr(llvm::Value* lhs, llvm::Value* rhs, bool is_signed);
 
+  // T-LLVM-004: Cold panic paths (on by default). Check failure edges get
+  // unlikely branch weights, panic-and-return paths share one block per
+  // function and panic code, and panic records are written out of line.
+  void SetColdPanicPaths(bool enabled) { cold_panic_paths_ = enabled; }
+  bool ColdPanicPaths() const { return cold_panic_paths_; }
+  // Branch weights for a check branch whose failure successor is the true
+  // (fail_on_true) or false edge; nullptr when cold panic paths are off.
+  llvm::MDNode* CheckBranchWeights(bool fail_on_true);
+  // Shared block in the current function that records `code` and returns.
+  llvm::BasicBlock* PanicReturnBlock(std::uint16_t code);
+  // Internal cold, noinline void(ptr panic_out, i32 code) that writes a
+  // panic record.
+  llvm::Function* PanicRecordHelper();
+  // Value of a module poison flag in the current function. Flags are only
+  // written on init-failure paths, which return, so a flag read more than
+  // once in a function is loaded once in its entry block.
+  llvm::Value* PoisonFlagValue(llvm::GlobalVariable* flag);
+
   // T-LLVM-005: Memory Intrinsics
   void EmitMemCpy(llvm::Value* dst, llvm::Value* src, llvm::Value* size, uint64_t align = 1);
   void EmitMemSet(llvm::Value* dst, llvm::Value* val, llvm::Value* size, uint64_t align = 1);
@@ -185,15 +236,41 @@ private:
   std::unordered_map<std::string, llvm::Value*> locals_;
 
   std::unordered_map<std::string, llvm::Value*> values_;
+  std::vector<std::pair<std::uint32_t, llvm::Value*>> values_by_id_;
+  std::uint32_t values_generation_ = 1;
   AsyncEmitState* async_state_ = nullptr;
   std::unordered_map<std::string, std::string> symbol_aliases_;
   std::vector<IRValue> active_regions_;
   std::vector<IRValue> parallel_contexts_;  // C0X Extension: §18 parallel context stack
 
+  bool cold_panic_paths_ = true;
+  std::map<std::pair<llvm::Function*, std::uint16_t>, llvm::BasicBlock*>
+      panic_return_blocks_;
+  llvm::Function* panic_record_helper_ = nullptr;
+  std::map<std::pair<llvm::Function*, llvm::GlobalVariable*>, llvm::LoadInst*>
+      poison_flag_loads_;
+
 
   // Type cache
   std::unordered_map<analysis::TypeRef, llvm::Type*> type_cache_;
 
+  // Call ABI cache, keyed like type_cache_ by TypeRef identity: callers pass
+  // the same ProcSigInfo / ProcIR types for every use of a callee. The key
+  // holds the refs, so their addresses cannot be reused by other types.
+  struct CallABIKey {
+    std::vector<std::pair<std::optional<analysis::ParamMode>, analysis::TypeRef>>
+        params;
+    analysis::TypeRef ret;
+    bool operator==(const CallABIKey& other) const = default;
+  };
+  struct CallABIKeyHash {
+    std::size_t operator()(const CallABIKey& key) const;
+  };
+  std::unordered_map<CallABIKey, ABICallResult, CallABIKeyHash> call_abi_cache_;
+  CallABICacheStats call_abi_stats_;
+  ABICallResult ComputeCallABIUncached(const std::vector<IRParam>& params,
+                                       const analysis::TypeRef& ret_type);
+
   // Internal helpers
 public:
   void EmitDecl(const IRDecl& decl);
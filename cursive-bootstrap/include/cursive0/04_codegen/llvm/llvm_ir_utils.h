@@ -30,6 +30,7 @@ namespace cursive0::codegen {
 // Forward declarations
 class LLVMEmitter;
 struct LowerCtx;
+struct EnumLayout;
 
 // Build a ScopeContext from a LowerCtx
 analysis::ScopeContext BuildScope(const LowerCtx* ctx);
@@ -98,6 +99,57 @@ void StoreAtOffset(LLVMEmitter& emitter,
                    std::uint64_t offset,
                    llvm::Value* value);
 
+// Member index of `agg_ty` that starts at `offset` and has type `field_ty`
+// (any type when null), if `agg_ty` is a struct with such a member
+std::optional<unsigned> StructElementAt(LLVMEmitter& emitter,
+                                        llvm::Type* agg_ty,
+                                        std::uint64_t offset,
+                                        llvm::Type* field_ty);
+
+// Address of the field at a byte offset into an aggregate of `agg_ty`:
+// a typed struct GEP when a member starts there, a byte GEP otherwise
+llvm::Value* FieldGEP(LLVMEmitter& emitter,
+                      llvm::IRBuilder<>* builder,
+                      llvm::Type* agg_ty,
+                      llvm::Value* ptr,
+                      std::uint64_t offset);
+
+// Aggregates with at most this many scalar leaves stay in SSA registers
+inline constexpr std::size_t kMaxSSAAggregateFields = 4;
+
+// True if `ty` is a struct whose scalar leaves (padding excluded) number
+// at most kMaxSSAAggregateFields
+bool IsSmallScalarAggregate(llvm::Type* ty);
+
+// Build a value of `agg_ty` with insertvalue from (offset, value) pairs.
+// Returns nullptr unless `agg_ty` is a small scalar aggregate with a member
+// of matching type at every offset.
+llvm::Value* BuildSmallAggregate(
+    LLVMEmitter& emitter,
+    llvm::IRBuilder<>* builder,
+    llvm::Type* agg_ty,
+    const std::vector<std::pair<std::uint64_t, llvm::Value*>>& fields);
+
+// Write the tag of variant `index` (discriminant `disc`) into the enum at
+// `ptr`. A niche layout gets the variant's niche value instead, or nothing
+// for the niche variant, whose payload is its tag.
+void StoreEnumTag(LLVMEmitter& emitter,
+                  llvm::IRBuilder<>* builder,
+                  llvm::Value* ptr,
+                  const EnumLayout& layout,
+                  std::size_t index,
+                  std::uint64_t disc);
+
+// i1 that is true when the enum at `ptr` holds variant `index` of
+// `variant_count`
+llvm::Value* EnumTagMatches(LLVMEmitter& emitter,
+                            llvm::IRBuilder<>* builder,
+                            llvm::Value* ptr,
+                            const EnumLayout& layout,
+                            std::size_t variant_count,
+                            std::size_t index,
+                            std::uint64_t disc);
+
 // Create an alloca in the entry block
 llvm::AllocaInst* CreateEntryAlloca(LLVMEmitter& emitter,
                                     llvm::IRBuilder<>* builder,
@@ -2,11 +2,13 @@
 
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <source_location>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cursive0/04_codegen/ir_model.h"
@@ -26,6 +28,13 @@ struct LowerResult {
   IRValue value;
 };
 
+// How a drop of a glue-backed type is emitted at scope exit.
+enum class DropGluePlan {
+  Trivial,  // glue body is empty; the drop is elided
+  Inline,   // glue body is small; expanded in place of the call
+  Call,     // call the shared drop glue procedure
+};
+
 // ScopeInfo tracks variables declared in a scope for cleanup
 struct CleanupItem {
   enum class Kind {
@@ -132,6 +141,52 @@ struct DerivedValueInfo {
   IRValue repeat_count;
 };
 
+// Types of opaque IR values. Temps from FreshTempValue are looked up by
+// their dense id; other opaque values (fixed names like "unit") by name.
+class ValueTypeTable {
+ public:
+  void Set(const IRValue& value, analysis::TypeRef type);
+  analysis::TypeRef Get(const IRValue& value) const;
+  // Copies entries of `other` that are not set here.
+  void MergeMissing(const ValueTypeTable& other);
+  void clear();
+
+ private:
+  std::vector<analysis::TypeRef> by_id_;
+  std::unordered_map<std::string, analysis::TypeRef> by_name_;
+};
+
+// Derived-value infos keyed like ValueTypeTable. Infos are stored densely
+// and indexed through a per-temp slot so copying a table (snapshots, the
+// per-module codegen cache) costs only the values actually registered.
+class DerivedValueTable {
+ public:
+  void Set(const IRValue& value, const DerivedValueInfo& info);
+  const DerivedValueInfo* Find(const IRValue& value) const;
+  // Copies entries of `other` that are not set here.
+  void MergeMissing(const DerivedValueTable& other);
+  // Copies every entry of `other`, replacing existing ones.
+  void Overwrite(const DerivedValueTable& other);
+  void clear();
+
+  template <typename Fn>
+  void ForEach(Fn&& fn) const {
+    for (const auto& info : infos_) {
+      fn(info);
+    }
+    for (const auto& [name, info] : by_name_) {
+      fn(info);
+    }
+  }
+
+ private:
+  void Merge(const DerivedValueTable& other, bool overwrite);
+
+  std::vector<std::uint32_t> slot_by_id_;  // 1-based index into infos_
+  std::vector<DerivedValueInfo> infos_;
+  std::unordered_map<std::string, DerivedValueInfo> by_name_;
+};
+
 // LowerCtx - context for lowering operations
 // Contains type information and scope state needed during lowering
 struct LowerCtx {
@@ -168,10 +223,26 @@ struct LowerCtx {
   bool dynamic_checks = false;
 
   // IR value and symbol type tracking.
-  std::unordered_map<std::string, analysis::TypeRef> value_types;
+  ValueTypeTable value_types;
   std::unordered_map<std::string, analysis::TypeRef> static_types;
   std::unordered_map<std::string, analysis::TypeRef> drop_glue_types;
+  // Drop glue cost class per dropped type, shared by every module.
+  std::unordered_map<std::string, DropGluePlan> drop_glue_plans;
+  // Class -> sole non-generic implementor (nullopt when several types or a
+  // generic type implement it). Built by the first SoleDispatchSym query and
+  // shared by every copy of the context, since sigma is fixed per session.
+  struct ClassImplementors {
+    bool built = false;
+    std::map<analysis::PathKey, std::optional<analysis::TypePath>> sole;
+  };
+  std::shared_ptr<ClassImplementors> class_implementors =
+      std::make_shared<ClassImplementors>();
+  // Glue this module calls but whose definition is emitted by its owner.
+  std::unordered_set<std::string> drop_glue_external;
   std::unordered_map<std::string, std::vector<std::string>> static_modules;
+  // Statics whose initializer was evaluated at compile time (keyed by
+  // StaticSymPath); they have no init or deinit code.
+  std::unordered_map<std::string, std::vector<std::uint8_t>> const_statics;
   std::unordered_map<std::string, std::vector<std::string>> record_ctor_paths;
 
   struct ProcSigInfo {
@@ -181,9 +252,16 @@ struct LowerCtx {
   std::unordered_map<std::string, ProcSigInfo> proc_sigs;
   std::unordered_map<std::string, std::vector<std::string>> proc_modules;
   std::optional<std::string> main_symbol;
+
+  // Generic procedures by symbol. Codegen is type-erased, so one body
+  // serves every instantiation; it is emitted linkonce_odr in a comdat.
+  std::unordered_set<std::string> generic_procs;
   std::vector<syntax::ModulePath> init_order;
   std::vector<syntax::ModulePath> init_modules;
   std::vector<std::pair<std::size_t, std::size_t>> init_eager_edges;
+  // Modules ("a::b") whose initialization provably cannot poison them
+  // (InitPlan::poison_free); their poison checks and flags are omitted.
+  std::unordered_set<std::string> poison_free_modules;
 
   // Async procedure lowering metadata
   struct AsyncFrameSlot {
@@ -231,6 +309,8 @@ struct LowerCtx {
   const ProcSigInfo* LookupProcSig(const std::string& sym) const;
   void RegisterProcModule(const std::string& sym, const syntax::ModulePath& module_path);
   const std::vector<std::string>* LookupProcModule(const std::string& sym) const;
+  bool PoisonFree(const std::string& module) const;
+  bool PoisonFree(const std::vector<std::string>& module) const;
   const AsyncProcInfo* LookupAsyncProc(const std::string& sym) const;
   
   // =========================================================================
@@ -244,7 +324,7 @@ struct LowerCtx {
   std::unordered_map<std::string, std::vector<BindingState>> binding_states;
 
   // Map from temporary value names to derived value info
-  std::unordered_map<std::string, DerivedValueInfo> derived_values;
+  DerivedValueTable derived_values;
 
   // Current temp sink for statement-scoped temporaries
   std::vector<TempValue>* temp_sink = nullptr;
@@ -315,7 +395,7 @@ struct LowerCtx {
   IRValue CaptureFieldPtr(const CaptureAccess& access);
 
   // Generate a unique temporary value placeholder.
-  IRValue FreshTempValue(std::string_view prefix);
+  IRValue FreshTempValue(const char* prefix);
 
   // Generate a unique internal alias for an implicit region.
   std::string FreshRegionAlias();
@@ -108,6 +108,9 @@ std::string BuiltinSymFileSystemWriteStdout();
 // (BuiltinSym-FileSystem-WriteStderr)
 std::string BuiltinSymFileSystemWriteStderr();
 
+// (BuiltinSym-FileSystem-FlushStd)
+std::string BuiltinSymFileSystemFlushStd();
+
 // (BuiltinSym-FileSystem-Exists)
 std::string BuiltinSymFileSystemExists();
 
@@ -184,6 +187,24 @@ std::string BuiltinSymReactorRun();
 // Reactor::register - registers a handler with the reactor
 std::string BuiltinSymReactorRegister();
 
+// (BuiltinSym-Reactor-Read)
+// Reactor::read - Future<bytes@Managed, IoError> reading up to max bytes
+std::string BuiltinSymReactorRead();
+
+// (BuiltinSym-Reactor-Write)
+// Reactor::write - Future<(), IoError> writing data to a File@Write
+std::string BuiltinSymReactorWrite();
+
+// (BuiltinSym-Reactor-OpenRead)
+// Reactor::open_read - Future<File@Read, IoError> opening path through fs
+std::string BuiltinSymReactorOpenRead();
+
+// (BuiltinSym-Reactor-Wait)
+// Blocks until an outstanding reactor operation completes; emitted by
+// Reactor::run before each resume of a suspended async
+// Signature: (self: dyn Reactor) -> ()
+std::string BuiltinSymReactorWait();
+
 // ============================================================================
 // §19 Async builtins
 // ============================================================================
@@ -230,8 +251,8 @@ std::string BuiltinSymAsyncCreateFailed();
 std::string BuiltinSymAsyncCreateSuspended();
 
 // (BuiltinSym-Async-AllocFrame)
-// Allocates async frame storage
-// Signature: (size: usize, align: usize) -> *mut u8
+// Allocates async frame storage; size_class is the AsyncFrameSizeClass hint
+// Signature: (size: usize, align: usize, size_class: usize) -> *mut u8
 std::string BuiltinSymAsyncAllocFrame();
 
 // (BuiltinSym-Async-FreeFrame)
@@ -280,6 +301,13 @@ std::string RuntimePanicSym();
 
 std::string ContextInitSym();
 
+// ============================================================================
+// Runtime shutdown symbol
+// ============================================================================
+
+// Drains buffered File and std stream writes before process exit.
+std::string RuntimeShutdownSym();
+
 // ============================================================================
 // Spec trace emission symbol
 // ============================================================================
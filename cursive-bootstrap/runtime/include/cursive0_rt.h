@@ -90,6 +90,12 @@ typedef struct C0SliceU8 {
   uint64_t len;
 } C0SliceU8;
 
+// Slice layout for [bytes@View]
+typedef struct C0SliceBytesView {
+  const C0BytesView* data;
+  uint64_t len;
+} C0SliceBytesView;
+
 // File/DirIter state payloads (handle: usize)
 typedef struct C0FileHandle {
   uint64_t handle;
@@ -184,6 +190,24 @@ typedef struct C0Union_BytesManaged_IoError {
   } payload;
 } C0Union_BytesManaged_IoError;
 
+typedef struct C0Union_StringView_IoError {
+  uint8_t disc;
+  uint8_t _pad[7];
+  union {
+    uint8_t io_error;
+    C0StringView value;
+  } payload;
+} C0Union_StringView_IoError;
+
+typedef struct C0Union_BytesView_IoError {
+  uint8_t disc;
+  uint8_t _pad[7];
+  union {
+    uint8_t io_error;
+    C0BytesView value;
+  } payload;
+} C0Union_BytesView_IoError;
+
 typedef struct C0Union_File_IoError {
   uint8_t disc;
   uint8_t _pad[7];
@@ -221,6 +245,38 @@ typedef struct C0Union_DirEntry_Unit_IoError {
   } payload;
 } C0Union_DirEntry_Unit_IoError;
 
+// Future<T, IoError> = Async<(), (), T, IoError> layouts returned by the
+// reactor. disc: 0 = @Suspended (payload: frame), 1 = @Completed (payload:
+// value), 2 = @Failed (payload: io_error).
+typedef struct C0Future_BytesManaged_IoError {
+  uint8_t disc;
+  uint8_t _pad[7];
+  union {
+    void* frame;
+    C0BytesManaged value;
+    uint8_t io_error;
+  } payload;
+} C0Future_BytesManaged_IoError;
+
+typedef struct C0Future_File_IoError {
+  uint8_t disc;
+  uint8_t _pad[7];
+  union {
+    void* frame;
+    uint64_t handle;
+    uint8_t io_error;
+  } payload;
+} C0Future_File_IoError;
+
+typedef struct C0Future_Unit_IoError {
+  uint8_t disc;
+  uint8_t _pad[7];
+  union {
+    void* frame;
+    uint8_t io_error;
+  } payload;
+} C0Future_Unit_IoError;
+
 // -----------------------------------------------------------------------------
 // Runtime functions (mangled symbol names)
 // -----------------------------------------------------------------------------
@@ -236,6 +292,10 @@ void cursive_x3a_x3aruntime_x3a_x3aspec_x5ftrace_x3a_x3aemit(
 // Context initialization
 void cursive_x3a_x3aruntime_x3a_x3acontext_x5finit(C0Context* out);
 
+// Runtime shutdown (drains buffered output; called on return from main and
+// before a panic terminates the process)
+void cursive_x3a_x3aruntime_x3a_x3ashutdown(void);
+
 // String/bytes drop
 void cursive_x3a_x3aruntime_x3a_x3astring_x3a_x3adrop_x5fmanaged(C0StringManaged* value);
 void cursive_x3a_x3aruntime_x3a_x3abytes_x3a_x3adrop_x5fmanaged(C0BytesManaged* value);
@@ -253,9 +313,32 @@ uint8_t cursive_x3a_x3aruntime_x3a_x3aregion_x3a_x3aaddr_x5fis_x5factive(const v
 void cursive_x3a_x3aruntime_x3a_x3aregion_x3a_x3aaddr_x5ftag_x5ffrom(const void* addr, const void* base);
 
 // Async frame allocation
-void* cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3aalloc_x5fframe(uint64_t size, uint64_t align);
+void* cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3aalloc_x5fframe(uint64_t size,
+                                                               uint64_t align,
+                                                               uint64_t size_class);
 void cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3afree_x5fframe(void* frame);
 
+// Reactor I/O. Each call returns a future whose frame is resumed like a
+// compiled async frame; the file must stay open until the future completes.
+C0Future_BytesManaged_IoError cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3aread(
+  const C0DynObject* self,
+  const C0FileHandle* file,
+  const uint64_t* max);
+
+C0Future_Unit_IoError cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3awrite(
+  const C0DynObject* self,
+  const C0FileHandle* file,
+  const C0BytesView* data);
+
+C0Future_File_IoError cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3aopen_x5fread(
+  const C0DynObject* self,
+  const C0DynObject* fs,
+  const C0StringView* path);
+
+// Blocks until an outstanding reactor operation completes (returns at once
+// when none are pending). Emitted by Reactor::run before each resume.
+void cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3await(const C0DynObject* self);
+
 // String builtins
 void cursive_x3a_x3aruntime_x3a_x3astring_x3a_x3afrom(
   C0Union_StringManaged_AllocError* out,
@@ -366,6 +449,8 @@ C0Union_Unit_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3awrite_x5fstdout(
 C0Union_Unit_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3awrite_x5fstderr(
   const C0DynObject* self,
   const C0StringView* data);
+C0Union_Unit_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aflush_x5fstd(
+  const C0DynObject* self);
 
 uint8_t cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aexists(
   const C0DynObject* self,
@@ -476,6 +561,17 @@ C0Union_StringManaged_IoError File_x3a_x3aRead_x3a_x3aread_x5fall(
 C0Union_BytesManaged_IoError File_x3a_x3aRead_x3a_x3aread_x5fall_x5fbytes(
   const C0FileHandle* self);
 
+// Zero-copy views over a read-only mapping of the file. Each successful call
+// takes a reference that unmap releases; the last release unmaps.
+C0Union_BytesView_IoError File_x3a_x3aRead_x3a_x3amap_x5fbytes(
+  const C0FileHandle* self);
+
+C0Union_StringView_IoError File_x3a_x3aRead_x3a_x3amap_x5ftext(
+  const C0FileHandle* self);
+
+C0Union_Unit_IoError File_x3a_x3aRead_x3a_x3aunmap(
+  const C0FileHandle* self);
+
 void File_x3a_x3aRead_x3a_x3aclose(
   C0FileHandle self);
 
@@ -483,9 +579,17 @@ C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3awrite(
   C0FileHandle* self,
   const C0BytesView* data);
 
+C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3awrite_x5fvectored(
+  C0FileHandle* self,
+  const C0SliceBytesView* parts);
+
 C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3aflush(
   C0FileHandle* self);
 
+C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3aset_x5fbuffer_x5fsize(
+  C0FileHandle* self,
+  const uint64_t* size);
+
 void File_x3a_x3aWrite_x3a_x3aclose(
   C0FileHandle self);
 
@@ -493,9 +597,17 @@ C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3awrite(
   C0FileHandle* self,
   const C0BytesView* data);
 
+C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3awrite_x5fvectored(
+  C0FileHandle* self,
+  const C0SliceBytesView* parts);
+
 C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3aflush(
   C0FileHandle* self);
 
+C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3aset_x5fbuffer_x5fsize(
+  C0FileHandle* self,
+  const uint64_t* size);
+
 void File_x3a_x3aAppend_x3a_x3aclose(
   C0FileHandle self);
 
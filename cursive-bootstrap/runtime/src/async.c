@@ -1,14 +1,142 @@
 #include "rt_internal.h"
 
-void* cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3aalloc_x5fframe(uint64_t size,
-                                                               uint64_t align) {
-  c0_trace_emit_rule("BuiltinSym-Async-AllocFrame");
-  if (size == 0) {
+// -----------------------------------------------------------------------------
+// Async frame pool
+//
+// Frames up to C0_FRAME_CLASS_MIN << (C0_FRAME_CLASS_COUNT - 1) bytes with
+// alignment <= C0_FRAME_CLASS_ALIGN are recycled through per-thread free lists,
+// one per power-of-two size class. Codegen passes the class as a hint
+// (AsyncFrameSizeClass in include/cursive0/04_codegen/async_frame.h), so the
+// common path is a free-list pop. Larger or over-aligned frames go straight to
+// the process heap.
+//
+// Every frame is preceded by a C0FrameHeader. A frame may be freed on a
+// different thread than the one that allocated it; it then joins that thread's
+// cache, which is fine because all blocks come from the same process heap.
+//
+// The caches live in fiber-local storage rather than plain TLS so that the FLS
+// destructor returns a thread's cached frames to the heap when it exits.
+// -----------------------------------------------------------------------------
+
+// Keep in sync with kAsyncFrameClass* in async_frame.h.
+#define C0_FRAME_CLASS_MIN 64u
+#define C0_FRAME_CLASS_COUNT 8u
+#define C0_FRAME_CLASS_ALIGN 16u
+#define C0_FRAME_NO_CLASS UINT64_MAX
+
+// Frames kept per class per thread before returning blocks to the heap.
+#define C0_FRAME_CACHE_MAX 64u
+
+typedef struct C0FrameHeader {
+  void* base;  // heap block for unpooled frames, NULL for pooled ones
+  uint32_t size_class;
+  uint32_t _pad;
+} C0FrameHeader;
+
+_Static_assert(sizeof(C0FrameHeader) == C0_FRAME_CLASS_ALIGN,
+               "frame header must preserve pooled frame alignment");
+
+typedef struct C0FrameCache {
+  void* head[C0_FRAME_CLASS_COUNT];
+  uint32_t count[C0_FRAME_CLASS_COUNT];
+} C0FrameCache;
+
+static INIT_ONCE c0_frame_tls_once = INIT_ONCE_STATIC_INIT;
+static DWORD c0_frame_tls_index = FLS_OUT_OF_INDEXES;
+
+// Runs on thread exit with that thread's cache.
+static VOID WINAPI c0_frame_cache_drain(PVOID data) {
+  C0FrameCache* cache = (C0FrameCache*)data;
+  if (!cache) {
+    return;
+  }
+  for (uint32_t i = 0; i < C0_FRAME_CLASS_COUNT; ++i) {
+    void* frame = cache->head[i];
+    while (frame) {
+      void* next = *(void**)frame;
+      c0_heap_free_raw((C0FrameHeader*)frame - 1);
+      frame = next;
+    }
+    cache->head[i] = NULL;
+    cache->count[i] = 0;
+  }
+  c0_heap_free_raw(cache);
+}
+
+static BOOL CALLBACK c0_frame_tls_init(PINIT_ONCE init_once, PVOID param,
+                                       PVOID* context) {
+  (void)init_once;
+  (void)param;
+  (void)context;
+  DWORD idx = FlsAlloc(c0_frame_cache_drain);
+  if (idx == FLS_OUT_OF_INDEXES) {
+    return FALSE;
+  }
+  c0_frame_tls_index = idx;
+  return TRUE;
+}
+
+// Returns NULL when TLS is unavailable; callers then bypass the pool.
+static C0FrameCache* c0_frame_cache(void) {
+  if (!InitOnceExecuteOnce(&c0_frame_tls_once, c0_frame_tls_init, NULL, NULL)) {
     return NULL;
   }
-  if (align == 0) {
-    align = 1;
+  C0FrameCache* cache = (C0FrameCache*)FlsGetValue(c0_frame_tls_index);
+  if (!cache) {
+    cache = (C0FrameCache*)c0_heap_alloc_raw(sizeof(C0FrameCache));
+    if (!cache) {
+      return NULL;
+    }
+    for (uint32_t i = 0; i < C0_FRAME_CLASS_COUNT; ++i) {
+      cache->head[i] = NULL;
+      cache->count[i] = 0;
+    }
+    if (!FlsSetValue(c0_frame_tls_index, cache)) {
+      c0_heap_free_raw(cache);
+      return NULL;
+    }
+  }
+  return cache;
+}
+
+static __inline uint64_t c0_frame_class_bytes(uint64_t size_class) {
+  return (uint64_t)C0_FRAME_CLASS_MIN << size_class;
+}
+
+static uint64_t c0_frame_class_of(uint64_t size, uint64_t align) {
+  if (align > C0_FRAME_CLASS_ALIGN) {
+    return C0_FRAME_NO_CLASS;
+  }
+  for (uint64_t k = 0; k < C0_FRAME_CLASS_COUNT; ++k) {
+    if (size <= c0_frame_class_bytes(k)) {
+      return k;
+    }
+  }
+  return C0_FRAME_NO_CLASS;
+}
+
+static void* c0_frame_alloc_pooled(uint64_t size_class) {
+  C0FrameCache* cache = c0_frame_cache();
+  if (cache && cache->head[size_class]) {
+    void* frame = cache->head[size_class];
+    cache->head[size_class] = *(void**)frame;
+    cache->count[size_class] -= 1;
+    return frame;
+  }
+  // HeapAlloc returns 16-byte aligned blocks, so the frame after the header is
+  // C0_FRAME_CLASS_ALIGN-aligned.
+  const uint64_t total = sizeof(C0FrameHeader) + c0_frame_class_bytes(size_class);
+  C0FrameHeader* header = (C0FrameHeader*)c0_heap_alloc_raw((size_t)total);
+  if (!header) {
+    return NULL;
   }
+  header->base = NULL;
+  header->size_class = (uint32_t)size_class;
+  header->_pad = 0;
+  return header + 1;
+}
+
+static void* c0_frame_alloc_unpooled(uint64_t size, uint64_t align) {
   if (align < (uint64_t)sizeof(void*)) {
     align = (uint64_t)sizeof(void*);
   }
@@ -20,7 +148,7 @@ void* cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3aalloc_x5fframe(uint64_t size,
     align = pow2;
   }
 
-  uint64_t total = size + align - 1 + (uint64_t)sizeof(void*);
+  uint64_t total = size + align - 1 + (uint64_t)sizeof(C0FrameHeader);
   if (total < size) {
     return NULL;
   }
@@ -30,17 +158,66 @@ void* cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3aalloc_x5fframe(uint64_t size,
     return NULL;
   }
 
-  uintptr_t raw = (uintptr_t)base + (uintptr_t)sizeof(void*);
+  uintptr_t raw = (uintptr_t)base + (uintptr_t)sizeof(C0FrameHeader);
   uintptr_t aligned = (raw + (uintptr_t)(align - 1)) & ~(uintptr_t)(align - 1);
-  ((void**)aligned)[-1] = base;
+  C0FrameHeader* header = (C0FrameHeader*)aligned - 1;
+  header->base = base;
+  header->size_class = (uint32_t)C0_FRAME_CLASS_COUNT;
+  header->_pad = 0;
   return (void*)aligned;
 }
 
-void cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3afree_x5fframe(void* frame) {
-  c0_trace_emit_rule("BuiltinSym-Async-FreeFrame");
+static void* c0_frame_alloc(uint64_t size, uint64_t align, uint64_t size_class) {
+  if (size == 0) {
+    return NULL;
+  }
+  if (align == 0) {
+    align = 1;
+  }
+  // Trust the codegen hint when it covers the request; otherwise classify here.
+  if (size_class >= C0_FRAME_CLASS_COUNT ||
+      size > c0_frame_class_bytes(size_class) ||
+      align > C0_FRAME_CLASS_ALIGN) {
+    size_class = c0_frame_class_of(size, align);
+  }
+  if (size_class != C0_FRAME_NO_CLASS) {
+    return c0_frame_alloc_pooled(size_class);
+  }
+  return c0_frame_alloc_unpooled(size, align);
+}
+
+void* c0_async_frame_alloc(uint64_t size, uint64_t align) {
+  return c0_frame_alloc(size, align, C0_FRAME_NO_CLASS);
+}
+
+void c0_async_frame_free(void* frame) {
   if (!frame) {
     return;
   }
-  void* base = ((void**)frame)[-1];
-  c0_heap_free_raw(base);
+  C0FrameHeader* header = (C0FrameHeader*)frame - 1;
+  if (header->base) {
+    c0_heap_free_raw(header->base);
+    return;
+  }
+  const uint32_t size_class = header->size_class;
+  C0FrameCache* cache = c0_frame_cache();
+  if (cache && cache->count[size_class] < C0_FRAME_CACHE_MAX) {
+    *(void**)frame = cache->head[size_class];
+    cache->head[size_class] = frame;
+    cache->count[size_class] += 1;
+    return;
+  }
+  c0_heap_free_raw(header);
+}
+
+void* cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3aalloc_x5fframe(uint64_t size,
+                                                               uint64_t align,
+                                                               uint64_t size_class) {
+  c0_trace_emit_rule("BuiltinSym-Async-AllocFrame");
+  return c0_frame_alloc(size, align, size_class);
+}
+
+void cursive_x3a_x3aruntime_x3a_x3aasync_x3a_x3afree_x5fframe(void* frame) {
+  c0_trace_emit_rule("BuiltinSym-Async-FreeFrame");
+  c0_async_frame_free(frame);
 }
@@ -1,10 +1,20 @@
 #include "rt_internal.h"
 
+// Buffered output would otherwise be lost when the process dies on an
+// unhandled exception (access violation, a panic escaping a worker, ...).
+static LONG WINAPI c0_unhandled_exception_filter(EXCEPTION_POINTERS* info) {
+  (void)info;
+  c0_io_flush_abnormal();
+  return EXCEPTION_CONTINUE_SEARCH;
+}
+
 void cursive_x3a_x3aruntime_x3a_x3acontext_x5finit(C0Context* out) {
   if (!out) {
     return;
   }
 
+  SetUnhandledExceptionFilter(c0_unhandled_exception_filter);
+
   out->fs.data = NULL;
   out->fs.vtable = NULL;
   out->heap.data = NULL;
@@ -34,6 +44,14 @@ void cursive_x3a_x3aruntime_x3a_x3acontext_x5finit(C0Context* out) {
   out->fs.vtable = NULL;
   out->heap.data = heap;
   out->heap.vtable = NULL;
+  // Worker threads and the event queue start on the first submitted op.
+  out->reactor.data = c0_reactor_default();
+  out->reactor.vtable = NULL;
+}
+
+void cursive_x3a_x3aruntime_x3a_x3ashutdown(void) {
+  c0_io_flush_all();
+  c0_spec_trace_flush();
 }
 
 static C0ExecutionDomain g_cpu_domain = {C0_DOMAIN_CPU, {0}, 4};
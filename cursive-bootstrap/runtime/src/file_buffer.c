@@ -0,0 +1,484 @@
+#include "rt_internal.h"
+#include "rt_os.h"
+
+// Userspace write buffering for File@Write/@Append and write_stdout/stderr.
+//
+// Each writable handle owns a buffer of buf_cap bytes, allocated on first
+// write. Data is handed to the OS when the buffer would overflow, on flush, on
+// close and at runtime shutdown. A capacity of 0 means write-through.
+//
+// stderr is write-through so diagnostics are never held back. stdout is
+// buffered, and line-buffered when it is a console.
+
+#define C0_WRITE_BUFFER_DEFAULT (16u * 1024u)
+#define C0_WRITE_BUFFER_MAX (64u * 1024u * 1024u)
+#define C0_WRITE_BUFFER_ENV "CURSIVE_IO_BUFFER_SIZE"
+
+// Parts gathered on the stack before falling back to a heap array.
+#define C0_GATHER_INLINE 8
+
+static C0OsLock c0_files_lock = C0_OS_LOCK_INIT;
+static C0FileState* c0_files_head = NULL;
+
+static C0OsLock c0_std_lock = C0_OS_LOCK_INIT;
+static C0FileState c0_std_files[2];
+static int c0_std_ready = 0;
+
+static uint64_t c0_default_cap = 0;
+static int c0_default_cap_ready = 0;
+
+static uint64_t c0_clamp_cap(uint64_t size) {
+  return size > C0_WRITE_BUFFER_MAX ? C0_WRITE_BUFFER_MAX : size;
+}
+
+static uint64_t c0_write_buffer_default(void) {
+  if (!c0_default_cap_ready) {
+    uint64_t size = C0_WRITE_BUFFER_DEFAULT;
+    uint64_t env = 0;
+    if (c0_os_env_u64(C0_WRITE_BUFFER_ENV, &env)) {
+      size = c0_clamp_cap(env);
+    }
+    c0_default_cap = size;
+    c0_default_cap_ready = 1;
+  }
+  return c0_default_cap;
+}
+
+static void c0_file_lock_init(C0FileState* file) {
+  const C0OsLock init = C0_OS_LOCK_INIT;
+  file->io_lock = init;
+}
+
+static int c0_has_newline(const uint8_t* data, uint64_t len) {
+  for (uint64_t i = len; i > 0; --i) {
+    if (data[i - 1] == '\n') {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int c0_buf_ensure(C0FileState* file) {
+  if (file->buf) {
+    return 1;
+  }
+  if (file->buf_cap == 0 || file->buf_cap > (uint64_t)SIZE_MAX) {
+    return 0;
+  }
+  file->buf = (uint8_t*)c0_heap_alloc_raw((size_t)file->buf_cap);
+  return file->buf != NULL;
+}
+
+// Drops the first sent bytes of the buffer, keeping the unsent tail at the
+// front so a later flush retries it.
+static void c0_buf_consume(C0FileState* file, uint64_t sent) {
+  if (sent >= file->buf_len) {
+    file->buf_len = 0;
+    return;
+  }
+  if (sent != 0) {
+    c0_memmove(file->buf, file->buf + sent, (size_t)(file->buf_len - sent));
+    file->buf_len -= sent;
+  }
+}
+
+static int c0_buf_drain(C0FileState* file, C0IoError* out_err) {
+  if (file->buf_len == 0) {
+    return 1;
+  }
+  uint64_t sent = 0;
+  const int ok = c0_os_write_counted(file->os_handle, file->buf, file->buf_len,
+                                     &sent, out_err);
+  c0_buf_consume(file, ok ? file->buf_len : sent);
+  return ok;
+}
+
+// Sends the pending buffer followed by parts in one gather call. On failure
+// the unsent part of the buffer is kept; the caller's parts are reported as
+// not written even if a prefix of them reached the OS.
+static int c0_buf_gather(C0FileState* file,
+                         const C0BytesView* parts,
+                         uint64_t count,
+                         C0IoError* out_err) {
+  if (file->buf_len == 0) {
+    return c0_os_writev_all(file->os_handle, parts, count, out_err);
+  }
+  C0BytesView inline_parts[C0_GATHER_INLINE];
+  C0BytesView* all = inline_parts;
+  if (count + 1 > C0_GATHER_INLINE) {
+    const uint64_t bytes = (count + 1) * (uint64_t)sizeof(C0BytesView);
+    all = bytes <= (uint64_t)SIZE_MAX
+        ? (C0BytesView*)c0_heap_alloc_raw((size_t)bytes)
+        : NULL;
+    if (!all) {
+      if (!c0_buf_drain(file, out_err)) {
+        return 0;
+      }
+      return c0_os_writev_all(file->os_handle, parts, count, out_err);
+    }
+  }
+  all[0].data = file->buf;
+  all[0].len = file->buf_len;
+  for (uint64_t i = 0; i < count; ++i) {
+    all[i + 1] = parts[i];
+  }
+  uint64_t sent = 0;
+  const int ok = c0_os_writev_counted(file->os_handle, all, count + 1, &sent,
+                                      out_err);
+  c0_buf_consume(file, ok ? file->buf_len : sent);
+  if (all != inline_parts) {
+    c0_heap_free_raw(all);
+  }
+  return ok;
+}
+
+static int c0_buf_writev(C0FileState* file,
+                         const C0BytesView* parts,
+                         uint64_t count,
+                         C0IoError* out_err) {
+  uint64_t total = 0;
+  for (uint64_t i = 0; i < count; ++i) {
+    if (!parts[i].data && parts[i].len != 0) {
+      *out_err = C0_IO_FAILURE;
+      return 0;
+    }
+    if (parts[i].len > UINT64_MAX - total) {
+      *out_err = C0_IO_FAILURE;
+      return 0;
+    }
+    total += parts[i].len;
+  }
+  if (total == 0) {
+    return 1;
+  }
+
+  if (total < file->buf_cap && c0_buf_ensure(file)) {
+    if (total > file->buf_cap - file->buf_len) {
+      if (!c0_buf_drain(file, out_err)) {
+        return 0;
+      }
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+      if (parts[i].len == 0) {
+        continue;
+      }
+      c0_memcpy(file->buf + file->buf_len, parts[i].data, (size_t)parts[i].len);
+      file->buf_len += parts[i].len;
+    }
+    if (file->buf_len == file->buf_cap) {
+      return c0_buf_drain(file, out_err);
+    }
+    return 1;
+  }
+
+  // Too large to buffer (or buffering disabled): one gather call covering the
+  // pending bytes and the new data.
+  return c0_buf_gather(file, parts, count, out_err);
+}
+
+static void c0_files_link(C0FileState* file) {
+  c0_os_lock(&c0_files_lock);
+  file->prev = NULL;
+  file->next = c0_files_head;
+  if (c0_files_head) {
+    c0_files_head->prev = file;
+  }
+  c0_files_head = file;
+  c0_os_unlock(&c0_files_lock);
+}
+
+static void c0_files_unlink(C0FileState* file) {
+  c0_os_lock(&c0_files_lock);
+  if (file->prev) {
+    file->prev->next = file->next;
+  } else if (c0_files_head == file) {
+    c0_files_head = file->next;
+  }
+  if (file->next) {
+    file->next->prev = file->prev;
+  }
+  file->prev = NULL;
+  file->next = NULL;
+  c0_os_unlock(&c0_files_lock);
+}
+
+C0FileState* c0_file_open_state(uintptr_t os_handle, int writable) {
+  C0FileState* file = (C0FileState*)c0_heap_alloc_raw(sizeof(C0FileState));
+  if (!file) {
+    return NULL;
+  }
+  file->os_handle = os_handle;
+  file->buf = NULL;
+  file->buf_len = 0;
+  file->buf_cap = writable ? c0_write_buffer_default() : 0;
+  file->writable = writable;
+  file->line_buffered = 0;
+  file->prev = NULL;
+  file->next = NULL;
+  file->map_base = NULL;
+  file->map_len = 0;
+  file->map_refs = 0;
+  file->mapped = 0;
+  file->map_utf8 = 0;
+  file->refs = 1;
+  c0_file_lock_init(file);
+  if (writable) {
+    // Tracked so shutdown can drain handles the program never closed.
+    c0_files_link(file);
+  }
+  return file;
+}
+
+void c0_file_lock(C0FileState* file) {
+  c0_os_lock(&file->io_lock);
+}
+
+void c0_file_unlock(C0FileState* file) {
+  c0_os_unlock(&file->io_lock);
+}
+
+void c0_file_retain(C0FileState* file) {
+  InterlockedIncrement(&file->refs);
+}
+
+void c0_file_release(C0FileState* file) {
+  if (InterlockedDecrement(&file->refs) != 0) {
+    return;
+  }
+  c0_os_close(file->os_handle);
+  c0_heap_free_raw(file->buf);
+  c0_heap_free_raw(file);
+}
+
+// Ends the File value's use of the handle. Reactor ops still in flight keep
+// the OS handle open until they release their reference.
+void c0_file_close_state(C0FileState* file) {
+  if (!file) {
+    return;
+  }
+  if (file->writable) {
+    C0IoError ignored = C0_IO_FAILURE;
+    c0_file_lock(file);
+    (void)c0_buf_drain(file, &ignored);
+    c0_file_unlock(file);
+    c0_files_unlink(file);
+  }
+  c0_file_lock(file);
+  c0_file_detach_map(file);
+  c0_file_unlock(file);
+  c0_file_release(file);
+}
+
+int c0_file_read_through(C0FileState* file,
+                         uint8_t* data,
+                         uint64_t len,
+                         uint64_t* out_read,
+                         C0IoError* out_err) {
+  c0_file_lock(file);
+  const int ok = c0_os_read_full(file->os_handle, data, len, out_read, out_err);
+  c0_file_unlock(file);
+  return ok;
+}
+
+int c0_file_write_through(C0FileState* file,
+                          const uint8_t* data,
+                          uint64_t len,
+                          C0IoError* out_err) {
+  c0_file_lock(file);
+  int ok = c0_buf_drain(file, out_err);
+  if (ok) {
+    ok = c0_os_write_all(file->os_handle, data, len, out_err);
+  }
+  c0_file_unlock(file);
+  return ok;
+}
+
+int c0_file_write(C0FileState* file,
+                  const uint8_t* data,
+                  uint64_t len,
+                  C0IoError* out_err) {
+  C0BytesView part;
+  part.data = data;
+  part.len = len;
+  return c0_file_writev(file, &part, 1, out_err);
+}
+
+int c0_file_writev(C0FileState* file,
+                   const C0BytesView* parts,
+                   uint64_t count,
+                   C0IoError* out_err) {
+  if (!file || !file->writable || !c0_os_handle_valid(file->os_handle)) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  if (!parts && count != 0) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  c0_file_lock(file);
+  const int ok = c0_buf_writev(file, parts, count, out_err);
+  c0_file_unlock(file);
+  return ok;
+}
+
+int c0_file_flush(C0FileState* file, C0IoError* out_err) {
+  if (!file || !c0_os_handle_valid(file->os_handle)) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  c0_file_lock(file);
+  int ok = c0_buf_drain(file, out_err);
+  if (ok) {
+    ok = c0_os_sync(file->os_handle, out_err);
+  }
+  c0_file_unlock(file);
+  return ok;
+}
+
+int c0_file_drain(C0FileState* file, C0IoError* out_err) {
+  if (!file || !c0_os_handle_valid(file->os_handle)) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  c0_file_lock(file);
+  const int ok = c0_buf_drain(file, out_err);
+  c0_file_unlock(file);
+  return ok;
+}
+
+int c0_file_set_buffer_size(C0FileState* file,
+                            uint64_t size,
+                            C0IoError* out_err) {
+  if (!file || !file->writable) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  size = c0_clamp_cap(size);
+  c0_file_lock(file);
+  int ok = 1;
+  if (size != file->buf_cap) {
+    ok = c0_buf_drain(file, out_err);
+    if (ok) {
+      c0_heap_free_raw(file->buf);
+      file->buf = NULL;
+      file->buf_cap = size;
+    }
+  }
+  c0_file_unlock(file);
+  return ok;
+}
+
+static void c0_std_init_locked(void) {
+  if (c0_std_ready) {
+    return;
+  }
+  for (int i = 0; i < 2; ++i) {
+    const uintptr_t handle = c0_os_std_handle(i);
+    const int is_out = i == C0_STD_OUT;
+    c0_std_files[i].os_handle = handle;
+    c0_std_files[i].buf = NULL;
+    c0_std_files[i].buf_len = 0;
+    c0_std_files[i].buf_cap = is_out ? c0_write_buffer_default() : 0;
+    c0_std_files[i].writable = 1;
+    c0_std_files[i].line_buffered =
+        is_out && c0_os_handle_valid(handle) && c0_os_handle_is_char(handle);
+    c0_std_files[i].prev = NULL;
+    c0_std_files[i].next = NULL;
+    c0_std_files[i].map_base = NULL;
+    c0_std_files[i].map_len = 0;
+    c0_std_files[i].map_refs = 0;
+    c0_std_files[i].mapped = 0;
+    c0_std_files[i].map_utf8 = 0;
+    c0_std_files[i].refs = 1;
+    c0_file_lock_init(&c0_std_files[i]);
+  }
+  c0_std_ready = 1;
+}
+
+int c0_std_write(int stream,
+                 const uint8_t* data,
+                 uint64_t len,
+                 C0IoError* out_err) {
+  if (stream != C0_STD_OUT && stream != C0_STD_ERR) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  c0_os_lock(&c0_std_lock);
+  c0_std_init_locked();
+  C0FileState* file = &c0_std_files[stream];
+  C0FileState* other = &c0_std_files[stream == C0_STD_OUT ? C0_STD_ERR
+                                                          : C0_STD_OUT];
+  int ok = 0;
+  if (!c0_os_handle_valid(file->os_handle)) {
+    *out_err = C0_IO_FAILURE;
+  } else {
+    // Keep stdout/stderr interleaving in program order.
+    C0IoError ignored = C0_IO_FAILURE;
+    (void)c0_buf_drain(other, &ignored);
+    C0BytesView part;
+    part.data = data;
+    part.len = len;
+    ok = c0_buf_writev(file, &part, 1, out_err);
+    if (ok && file->line_buffered && c0_has_newline(data, len)) {
+      ok = c0_buf_drain(file, out_err);
+    }
+  }
+  c0_os_unlock(&c0_std_lock);
+  return ok;
+}
+
+int c0_std_flush(C0IoError* out_err) {
+  int ok = 1;
+  c0_os_lock(&c0_std_lock);
+  if (c0_std_ready) {
+    for (int i = C0_STD_OUT; i <= C0_STD_ERR; ++i) {
+      C0IoError err = C0_IO_FAILURE;
+      if (!c0_buf_drain(&c0_std_files[i], &err) && ok) {
+        *out_err = err;
+        ok = 0;
+      }
+    }
+  }
+  c0_os_unlock(&c0_std_lock);
+  return ok;
+}
+
+void c0_io_flush_all(void) {
+  C0IoError ignored = C0_IO_FAILURE;
+  c0_os_lock(&c0_std_lock);
+  if (c0_std_ready) {
+    (void)c0_buf_drain(&c0_std_files[C0_STD_OUT], &ignored);
+    (void)c0_buf_drain(&c0_std_files[C0_STD_ERR], &ignored);
+  }
+  c0_os_unlock(&c0_std_lock);
+
+  c0_os_lock(&c0_files_lock);
+  for (C0FileState* file = c0_files_head; file; file = file->next) {
+    c0_file_lock(file);
+    (void)c0_buf_drain(file, &ignored);
+    c0_file_unlock(file);
+  }
+  c0_os_unlock(&c0_files_lock);
+}
+
+// Crash-path variant of c0_io_flush_all: the faulting thread may hold either
+// lock, so buffers whose lock is taken are skipped instead of waited on.
+void c0_io_flush_abnormal(void) {
+  C0IoError ignored = C0_IO_FAILURE;
+  if (c0_os_try_lock(&c0_std_lock)) {
+    if (c0_std_ready) {
+      (void)c0_buf_drain(&c0_std_files[C0_STD_OUT], &ignored);
+      (void)c0_buf_drain(&c0_std_files[C0_STD_ERR], &ignored);
+    }
+    c0_os_unlock(&c0_std_lock);
+  }
+  if (c0_os_try_lock(&c0_files_lock)) {
+    for (C0FileState* file = c0_files_head; file; file = file->next) {
+      if (c0_os_try_lock(&file->io_lock)) {
+        (void)c0_buf_drain(file, &ignored);
+        c0_file_unlock(file);
+      }
+    }
+    c0_os_unlock(&c0_files_lock);
+  }
+}
@@ -0,0 +1,106 @@
+#include "rt_internal.h"
+#include "rt_os.h"
+
+// Read-only file mappings for File@Read::map_bytes/map_text.
+//
+// A handle is mapped at most once; later calls return the same view. Views
+// are plain bytes@View/string@View values with no drop, so the program
+// releases them explicitly: every successful map call takes a reference and
+// unmap() drops one, and the last one unmaps. A mapping still referenced at
+// close() is detached instead and stays mapped until the process exits, so
+// its views stay readable.
+
+// Called with the file's io_lock held.
+static int c0_file_map_locked(C0FileState* file,
+                              const uint8_t** out_data,
+                              uint64_t* out_len,
+                              C0IoError* out_err) {
+  if (!file->mapped) {
+    if (!c0_os_map_read(file->os_handle, &file->map_base, &file->map_len,
+                        out_err)) {
+      return 0;
+    }
+    file->mapped = 1;
+    file->map_refs = 0;
+    file->map_utf8 = 0;
+  }
+  ++file->map_refs;
+  *out_data = file->map_base;
+  *out_len = file->map_len;
+  return 1;
+}
+
+int c0_file_map(C0FileState* file,
+                const uint8_t** out_data,
+                uint64_t* out_len,
+                C0IoError* out_err) {
+  if (!file || file->writable || !c0_os_handle_valid(file->os_handle)) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  c0_file_lock(file);
+  const int ok = c0_file_map_locked(file, out_data, out_len, out_err);
+  c0_file_unlock(file);
+  return ok;
+}
+
+int c0_file_map_utf8(C0FileState* file,
+                     const uint8_t** out_data,
+                     uint64_t* out_len,
+                     C0IoError* out_err) {
+  if (!file || file->writable || !c0_os_handle_valid(file->os_handle)) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  c0_file_lock(file);
+  int ok = c0_file_map_locked(file, out_data, out_len, out_err);
+  if (ok && file->map_utf8 == 0) {
+    file->map_utf8 = c0_utf8_valid(file->map_base, file->map_len) ? 1 : -1;
+  }
+  if (ok && file->map_utf8 < 0) {
+    // No view is handed out, so the reference is not either.
+    --file->map_refs;
+    *out_err = C0_IO_FAILURE;
+    ok = 0;
+  }
+  c0_file_unlock(file);
+  return ok;
+}
+
+static void c0_file_forget_map(C0FileState* file) {
+  file->map_base = NULL;
+  file->map_len = 0;
+  file->map_refs = 0;
+  file->mapped = 0;
+  file->map_utf8 = 0;
+}
+
+int c0_file_unmap(C0FileState* file, C0IoError* out_err) {
+  if (!file || file->writable || !c0_os_handle_valid(file->os_handle)) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  c0_file_lock(file);
+  int ok = 1;
+  if (!file->mapped || file->map_refs == 0) {
+    *out_err = C0_IO_FAILURE;
+    ok = 0;
+  } else if (--file->map_refs == 0) {
+    c0_os_unmap(file->map_base);
+    c0_file_forget_map(file);
+  }
+  c0_file_unlock(file);
+  return ok;
+}
+
+// Called from close with the file's io_lock held. A mapping nobody has
+// released is leaked on purpose: its views may still be live.
+void c0_file_detach_map(C0FileState* file) {
+  if (!file || !file->mapped) {
+    return;
+  }
+  if (file->map_refs == 0) {
+    c0_os_unmap(file->map_base);
+  }
+  c0_file_forget_map(file);
+}
@@ -1,4 +1,5 @@
 #include "rt_internal.h"
+#include "rt_os.h"
 
 // C-compatible SPEC_RULE macro (no-op, tracing done via c0_trace_emit_rule)
 #ifndef SPEC_RULE
@@ -355,42 +356,6 @@ static wchar_t* c0_path_utf8_to_wide(const uint8_t* utf8,
   return wide;
 }
 
-static C0IoError c0_map_win_error(DWORD err) {
-  switch (err) {
-    case ERROR_FILE_NOT_FOUND:
-    case ERROR_PATH_NOT_FOUND:
-    case ERROR_INVALID_DRIVE:
-      return C0_IO_NOTFOUND;
-    case ERROR_ACCESS_DENIED:
-    case ERROR_PRIVILEGE_NOT_HELD:
-      return C0_IO_PERMISSION_DENIED;
-    case ERROR_FILE_EXISTS:
-    case ERROR_ALREADY_EXISTS:
-      return C0_IO_ALREADY_EXISTS;
-    case ERROR_INVALID_NAME:
-    case ERROR_BAD_PATHNAME:
-    case ERROR_FILENAME_EXCED_RANGE:
-    case ERROR_DIRECTORY:
-    case ERROR_INVALID_PARAMETER:
-      return C0_IO_INVALID_PATH;
-    case ERROR_BUSY:
-    case ERROR_SHARING_VIOLATION:
-    case ERROR_LOCK_VIOLATION:
-    case ERROR_PIPE_BUSY:
-      return C0_IO_BUSY;
-    default:
-      return C0_IO_FAILURE;
-  }
-}
-
-static C0IoError c0_last_io_error(void) {
-  DWORD err = GetLastError();
-  if (err == 0) {
-    return C0_IO_FAILURE;
-  }
-  return c0_map_win_error(err);
-}
-
 static C0FsState* c0_fs_state(const C0DynObject* fs) {
   if (!fs) {
     return NULL;
@@ -478,6 +443,26 @@ static C0Union_File_IoError c0_file_err(C0IoError err) {
   return out;
 }
 
+// Wraps a freshly opened OS handle in its File state. Closes h on failure.
+static C0Union_File_IoError c0_file_ok(HANDLE h, int writable) {
+  C0FileState* file = c0_file_open_state((uintptr_t)h, writable);
+  if (!file) {
+    CloseHandle(h);
+    return c0_file_err(C0_IO_FAILURE);
+  }
+  C0Union_File_IoError out;
+  out.disc = 1;
+  out.payload.handle = (uint64_t)(uintptr_t)file;
+  return out;
+}
+
+static C0FileState* c0_file_state(uint64_t handle) {
+  if (handle == 0) {
+    return NULL;
+  }
+  return (C0FileState*)(uintptr_t)handle;
+}
+
 static C0Union_DirIter_IoError c0_dir_err(C0IoError err) {
   C0Union_DirIter_IoError out;
   out.disc = 0;
@@ -626,10 +611,7 @@ C0Union_File_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aopen_x5fread(
   if (h == INVALID_HANDLE_VALUE) {
     return c0_file_err(c0_last_io_error());
   }
-  C0Union_File_IoError out;
-  out.disc = 1;
-  out.payload.handle = (uint64_t)(uintptr_t)h;
-  return out;
+  return c0_file_ok(h, 0);
 }
 
 C0Union_File_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aopen_x5fwrite(
@@ -656,10 +638,7 @@ C0Union_File_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aopen_x5fwrite(
   if (h == INVALID_HANDLE_VALUE) {
     return c0_file_err(c0_last_io_error());
   }
-  C0Union_File_IoError out;
-  out.disc = 1;
-  out.payload.handle = (uint64_t)(uintptr_t)h;
-  return out;
+  return c0_file_ok(h, 1);
 }
 
 C0Union_File_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aopen_x5fappend(
@@ -686,10 +665,7 @@ C0Union_File_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aopen_x5fappend(
   if (h == INVALID_HANDLE_VALUE) {
     return c0_file_err(c0_last_io_error());
   }
-  C0Union_File_IoError out;
-  out.disc = 1;
-  out.payload.handle = (uint64_t)(uintptr_t)h;
-  return out;
+  return c0_file_ok(h, 1);
 }
 
 C0Union_File_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3acreate_x5fwrite(
@@ -716,10 +692,7 @@ C0Union_File_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3acreate_x5fwrite(
   if (h == INVALID_HANDLE_VALUE) {
     return c0_file_err(c0_last_io_error());
   }
-  C0Union_File_IoError out;
-  out.disc = 1;
-  out.payload.handle = (uint64_t)(uintptr_t)h;
-  return out;
+  return c0_file_ok(h, 1);
 }
 void cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aread_x5ffile(
     C0Union_StringManaged_IoError* out,
@@ -735,9 +708,9 @@ void cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aread_x5ffile(
     *out = c0_string_io_err(file.payload.io_error);
     return;
   }
-  HANDLE h = (HANDLE)(uintptr_t)file.payload.handle;
-  C0Union_StringManaged_IoError result = c0_read_all_string_handle(h);
-  CloseHandle(h);
+  C0FileState* state = c0_file_state(file.payload.handle);
+  C0Union_StringManaged_IoError result = c0_read_all_string_handle((HANDLE)state->os_handle);
+  c0_file_close_state(state);
   *out = result;
 }
 
@@ -755,9 +728,9 @@ void cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aread_x5fbytes(
     *out = c0_bytes_io_err(file.payload.io_error);
     return;
   }
-  HANDLE h = (HANDLE)(uintptr_t)file.payload.handle;
-  C0Union_BytesManaged_IoError result = c0_read_all_bytes_handle(h);
-  CloseHandle(h);
+  C0FileState* state = c0_file_state(file.payload.handle);
+  C0Union_BytesManaged_IoError result = c0_read_all_bytes_handle((HANDLE)state->os_handle);
+  c0_file_close_state(state);
   *out = result;
 }
 
@@ -823,25 +796,9 @@ C0Union_Unit_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3awrite_x5fstdout(
   SPEC_RULE("Prim-FS-WriteStdout");
   c0_trace_emit_rule("Prim-FS-WriteStdout");
   (void)self;
-  uint64_t len = data ? data->len : 0;
-  HANDLE h = GetStdHandle(STD_OUTPUT_HANDLE);
-  if (!h || h == INVALID_HANDLE_VALUE) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  uint64_t written = 0;
-  while (written < len) {
-    DWORD chunk = 0;
-    DWORD to_write = (DWORD)c0_min_u64(len - written, 0x7FFFFFFF);
-    if (!WriteFile(h, data->data + written, to_write, &chunk, NULL)) {
-      return c0_unit_err(c0_last_io_error());
-    }
-    if (chunk == 0) {
-      break;
-    }
-    written += (uint64_t)chunk;
-  }
-  if (written != len) {
-    return c0_unit_err(C0_IO_FAILURE);
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_std_write(C0_STD_OUT, data ? data->data : NULL, data ? data->len : 0, &err)) {
+    return c0_unit_err(err);
   }
   return c0_unit_ok();
 }
@@ -852,25 +809,21 @@ C0Union_Unit_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3awrite_x5fstderr(
   SPEC_RULE("Prim-FS-WriteStderr");
   c0_trace_emit_rule("Prim-FS-WriteStderr");
   (void)self;
-  HANDLE h = GetStdHandle(STD_ERROR_HANDLE);
-  if (!h || h == INVALID_HANDLE_VALUE) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  uint64_t len = data ? data->len : 0;
-  uint64_t written = 0;
-  while (written < len) {
-    DWORD chunk = 0;
-    DWORD to_write = (DWORD)c0_min_u64(len - written, 0x7FFFFFFF);
-    if (!WriteFile(h, data->data + written, to_write, &chunk, NULL)) {
-      return c0_unit_err(c0_last_io_error());
-    }
-    if (chunk == 0) {
-      break;
-    }
-    written += (uint64_t)chunk;
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_std_write(C0_STD_ERR, data ? data->data : NULL, data ? data->len : 0, &err)) {
+    return c0_unit_err(err);
   }
-  if (written != len) {
-    return c0_unit_err(C0_IO_FAILURE);
+  return c0_unit_ok();
+}
+
+C0Union_Unit_IoError cursive_x3a_x3aruntime_x3a_x3afs_x3a_x3aflush_x5fstd(
+    const C0DynObject* self) {
+  SPEC_RULE("Prim-FS-FlushStd");
+  c0_trace_emit_rule("Prim-FS-FlushStd");
+  (void)self;
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_std_flush(&err)) {
+    return c0_unit_err(err);
   }
   return c0_unit_ok();
 }
@@ -1499,53 +1452,125 @@ C0Union_StringManaged_IoError File_x3a_x3aRead_x3a_x3aread_x5fall(
     const C0FileHandle* self) {
   SPEC_RULE("Prim-File-ReadAll");
   c0_trace_emit_rule("Prim-File-ReadAll");
-  if (!self) {
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  if (!file) {
     return c0_string_io_err(C0_IO_FAILURE);
   }
-  HANDLE h = (HANDLE)(uintptr_t)self->handle;
-  return c0_read_all_string_handle(h);
+  c0_file_lock(file);
+  C0Union_StringManaged_IoError out =
+      c0_read_all_string_handle((HANDLE)file->os_handle);
+  c0_file_unlock(file);
+  return out;
 }
 
 C0Union_BytesManaged_IoError File_x3a_x3aRead_x3a_x3aread_x5fall_x5fbytes(
     const C0FileHandle* self) {
   SPEC_RULE("Prim-File-ReadAllBytes");
   c0_trace_emit_rule("Prim-File-ReadAllBytes");
-  if (!self) {
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  if (!file) {
     return c0_bytes_io_err(C0_IO_FAILURE);
   }
-  HANDLE h = (HANDLE)(uintptr_t)self->handle;
-  return c0_read_all_bytes_handle(h);
+  c0_file_lock(file);
+  C0Union_BytesManaged_IoError out =
+      c0_read_all_bytes_handle((HANDLE)file->os_handle);
+  c0_file_unlock(file);
+  return out;
+}
+
+C0Union_BytesView_IoError File_x3a_x3aRead_x3a_x3amap_x5fbytes(
+    const C0FileHandle* self) {
+  SPEC_RULE("Prim-File-MapBytes");
+  c0_trace_emit_rule("Prim-File-MapBytes");
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  C0Union_BytesView_IoError out;
+  C0IoError err = C0_IO_FAILURE;
+  const uint8_t* data = NULL;
+  uint64_t len = 0;
+  if (!c0_file_map(file, &data, &len, &err)) {
+    out.disc = 0;
+    out.payload.io_error = err;
+    return out;
+  }
+  out.disc = 1;
+  out.payload.value.data = data;
+  out.payload.value.len = len;
+  return out;
+}
+
+C0Union_StringView_IoError File_x3a_x3aRead_x3a_x3amap_x5ftext(
+    const C0FileHandle* self) {
+  SPEC_RULE("Prim-File-MapText");
+  c0_trace_emit_rule("Prim-File-MapText");
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  C0Union_StringView_IoError out;
+  C0IoError err = C0_IO_FAILURE;
+  const uint8_t* data = NULL;
+  uint64_t len = 0;
+  if (!c0_file_map_utf8(file, &data, &len, &err)) {
+    out.disc = 0;
+    out.payload.io_error = err;
+    return out;
+  }
+  out.disc = 1;
+  out.payload.value.data = data;
+  out.payload.value.len = len;
+  return out;
+}
+
+C0Union_Unit_IoError File_x3a_x3aRead_x3a_x3aunmap(
+    const C0FileHandle* self) {
+  SPEC_RULE("Prim-File-Unmap");
+  c0_trace_emit_rule("Prim-File-Unmap");
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_file_unmap(file, &err)) {
+    return c0_unit_err(err);
+  }
+  return c0_unit_ok();
 }
 
 void File_x3a_x3aRead_x3a_x3aclose(C0FileHandle self) {
   SPEC_RULE("Prim-File-Close-Read");
   c0_trace_emit_rule("Prim-File-Close-Read");
-  HANDLE h = (HANDLE)(uintptr_t)self.handle;
-  if (h && h != INVALID_HANDLE_VALUE) {
-    CloseHandle(h);
+  c0_file_close_state(c0_file_state(self.handle));
+}
+
+static C0Union_Unit_IoError c0_file_write_view(C0FileHandle* self,
+                                               const C0BytesView* data) {
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_file_write(file, data ? data->data : NULL, data ? data->len : 0, &err)) {
+    return c0_unit_err(err);
   }
+  return c0_unit_ok();
 }
 
-static C0Union_Unit_IoError c0_file_write_handle(HANDLE h,
-                                                 const C0BytesView* data) {
-  if (!h || h == INVALID_HANDLE_VALUE) {
-    return c0_unit_err(C0_IO_FAILURE);
+static C0Union_Unit_IoError c0_file_write_parts(C0FileHandle* self,
+                                                const C0SliceBytesView* parts) {
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_file_writev(file, parts ? parts->data : NULL, parts ? parts->len : 0, &err)) {
+    return c0_unit_err(err);
   }
-  uint64_t len = data ? data->len : 0;
-  uint64_t written = 0;
-  while (written < len) {
-    DWORD chunk = 0;
-    DWORD to_write = (DWORD)c0_min_u64(len - written, 0x7FFFFFFF);
-    if (!WriteFile(h, data->data + written, to_write, &chunk, NULL)) {
-      return c0_unit_err(c0_last_io_error());
-    }
-    if (chunk == 0) {
-      break;
-    }
-    written += (uint64_t)chunk;
+  return c0_unit_ok();
+}
+
+static C0Union_Unit_IoError c0_file_flush_handle(C0FileHandle* self) {
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_file_flush(file, &err)) {
+    return c0_unit_err(err);
   }
-  if (written != len) {
-    return c0_unit_err(C0_IO_FAILURE);
+  return c0_unit_ok();
+}
+
+static C0Union_Unit_IoError c0_file_set_buffer_handle(C0FileHandle* self,
+                                                      const uint64_t* size) {
+  C0FileState* file = self ? c0_file_state(self->handle) : NULL;
+  C0IoError err = C0_IO_FAILURE;
+  if (!size || !c0_file_set_buffer_size(file, *size, &err)) {
+    return c0_unit_err(err);
   }
   return c0_unit_ok();
 }
@@ -1555,37 +1580,36 @@ C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3awrite(
     const C0BytesView* data) {
   SPEC_RULE("Prim-File-Write");
   c0_trace_emit_rule("Prim-File-Write");
-  if (!self) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  HANDLE h = (HANDLE)(uintptr_t)self->handle;
-  return c0_file_write_handle(h, data);
+  return c0_file_write_view(self, data);
+}
+
+C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3awrite_x5fvectored(
+    C0FileHandle* self,
+    const C0SliceBytesView* parts) {
+  SPEC_RULE("Prim-File-WriteVectored");
+  c0_trace_emit_rule("Prim-File-WriteVectored");
+  return c0_file_write_parts(self, parts);
 }
 
 C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3aflush(
     C0FileHandle* self) {
   SPEC_RULE("Prim-File-Flush");
   c0_trace_emit_rule("Prim-File-Flush");
-  if (!self) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  HANDLE h = (HANDLE)(uintptr_t)self->handle;
-  if (!h || h == INVALID_HANDLE_VALUE) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  if (!FlushFileBuffers(h)) {
-    return c0_unit_err(c0_last_io_error());
-  }
-  return c0_unit_ok();
+  return c0_file_flush_handle(self);
+}
+
+C0Union_Unit_IoError File_x3a_x3aWrite_x3a_x3aset_x5fbuffer_x5fsize(
+    C0FileHandle* self,
+    const uint64_t* size) {
+  SPEC_RULE("Prim-File-SetBufferSize");
+  c0_trace_emit_rule("Prim-File-SetBufferSize");
+  return c0_file_set_buffer_handle(self, size);
 }
 
 void File_x3a_x3aWrite_x3a_x3aclose(C0FileHandle self) {
   SPEC_RULE("Prim-File-Close-Write");
   c0_trace_emit_rule("Prim-File-Close-Write");
-  HANDLE h = (HANDLE)(uintptr_t)self.handle;
-  if (h && h != INVALID_HANDLE_VALUE) {
-    CloseHandle(h);
-  }
+  c0_file_close_state(c0_file_state(self.handle));
 }
 
 C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3awrite(
@@ -1593,37 +1617,36 @@ C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3awrite(
     const C0BytesView* data) {
   SPEC_RULE("Prim-File-Write-Append");
   c0_trace_emit_rule("Prim-File-Write-Append");
-  if (!self) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  HANDLE h = (HANDLE)(uintptr_t)self->handle;
-  return c0_file_write_handle(h, data);
+  return c0_file_write_view(self, data);
+}
+
+C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3awrite_x5fvectored(
+    C0FileHandle* self,
+    const C0SliceBytesView* parts) {
+  SPEC_RULE("Prim-File-WriteVectored-Append");
+  c0_trace_emit_rule("Prim-File-WriteVectored-Append");
+  return c0_file_write_parts(self, parts);
 }
 
 C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3aflush(
     C0FileHandle* self) {
   SPEC_RULE("Prim-File-Flush-Append");
   c0_trace_emit_rule("Prim-File-Flush-Append");
-  if (!self) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  HANDLE h = (HANDLE)(uintptr_t)self->handle;
-  if (!h || h == INVALID_HANDLE_VALUE) {
-    return c0_unit_err(C0_IO_FAILURE);
-  }
-  if (!FlushFileBuffers(h)) {
-    return c0_unit_err(c0_last_io_error());
-  }
-  return c0_unit_ok();
+  return c0_file_flush_handle(self);
+}
+
+C0Union_Unit_IoError File_x3a_x3aAppend_x3a_x3aset_x5fbuffer_x5fsize(
+    C0FileHandle* self,
+    const uint64_t* size) {
+  SPEC_RULE("Prim-File-SetBufferSize-Append");
+  c0_trace_emit_rule("Prim-File-SetBufferSize-Append");
+  return c0_file_set_buffer_handle(self, size);
 }
 
 void File_x3a_x3aAppend_x3a_x3aclose(C0FileHandle self) {
   SPEC_RULE("Prim-File-Close-Append");
   c0_trace_emit_rule("Prim-File-Close-Append");
-  HANDLE h = (HANDLE)(uintptr_t)self.handle;
-  if (h && h != INVALID_HANDLE_VALUE) {
-    CloseHandle(h);
-  }
+  c0_file_close_state(c0_file_state(self.handle));
 }
 C0Union_DirEntry_Unit_IoError DirIter_x3a_x3aOpen_x3a_x3anext(
     C0DirIterHandle* self) {
@@ -1768,3 +1791,296 @@ void DirIter_x3a_x3aOpen_x3a_x3aclose(C0DirIterHandle self) {
   }
   c0_heap_free_raw(state);
 }
+
+// -----------------------------------------------------------------------------
+// Reactor I/O futures
+//
+// Each entry point submits one reactor op and returns Async@Suspended over a
+// runtime-built frame. The frame starts with the same header as compiled async
+// frames (resume state at offset 0, resume fn at offset 8), so `sync`,
+// `yield from` and Reactor::run drive it like any other async value: each
+// resume polls the reactor and either re-suspends on the same frame or
+// completes and frees it. Read and write ops hold a reference on the File
+// state until they complete, so closing the File meanwhile does not close
+// the OS handle under the worker.
+// -----------------------------------------------------------------------------
+
+typedef struct C0IoFrame {
+  uint64_t resume_state;
+  void* resume_fn;
+  C0Reactor* reactor;
+  C0ReactorOp op;
+} C0IoFrame;
+
+_Static_assert(offsetof(C0IoFrame, resume_fn) == 8,
+               "reactor frames share the async frame header");
+
+enum {
+  C0_ASYNC_SUSPENDED = 0,
+  C0_ASYNC_COMPLETED = 1,
+  C0_ASYNC_FAILED = 2,
+};
+
+static C0IoFrame* c0_io_frame_new(C0Reactor* reactor,
+                                  void* resume_fn,
+                                  C0ReactorWorkFn work) {
+  C0IoFrame* frame = (C0IoFrame*)c0_async_frame_alloc(
+      sizeof(C0IoFrame), (uint64_t)_Alignof(C0IoFrame));
+  if (!frame) {
+    return NULL;
+  }
+  frame->resume_state = 0;
+  frame->resume_fn = resume_fn;
+  frame->reactor = reactor;
+  frame->op.work = work;
+  frame->op.next = NULL;
+  frame->op.done = 0;
+  frame->op.ok = 0;
+  frame->op.err = C0_IO_FAILURE;
+  frame->op.os_handle = 0;
+  frame->op.data = NULL;
+  frame->op.len = 0;
+  frame->op.result = 0;
+  frame->op.arg = NULL;
+  return frame;
+}
+
+// Worker side.
+
+static void c0_io_work_read(C0ReactorOp* op) {
+  uint64_t got = 0;
+  op->ok = (uint8_t)c0_file_read_through((C0FileState*)op->arg, op->data,
+                                         op->len, &got, &op->err);
+  op->result = got;
+}
+
+static void c0_io_work_write(C0ReactorOp* op) {
+  op->ok = (uint8_t)c0_file_write_through((C0FileState*)op->arg, op->data,
+                                          op->len, &op->err);
+  op->result = op->ok ? op->len : 0;
+}
+
+static void c0_io_work_open_read(C0ReactorOp* op) {
+  HANDLE h = CreateFileW((const wchar_t*)op->arg, GENERIC_READ,
+                         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                         NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (h == INVALID_HANDLE_VALUE) {
+    op->ok = 0;
+    op->err = c0_last_io_error();
+    return;
+  }
+  op->ok = 1;
+  op->result = (uint64_t)(uintptr_t)h;
+}
+
+// Resume side. `input` is always () and reactor ops never panic.
+
+static C0Future_BytesManaged_IoError c0_io_read_resume(void* frame_ptr,
+                                                       void* input,
+                                                       void* panic_out) {
+  (void)input;
+  (void)panic_out;
+  C0IoFrame* frame = (C0IoFrame*)frame_ptr;
+  C0Future_BytesManaged_IoError out;
+  if (!c0_reactor_poll(frame->reactor, &frame->op)) {
+    out.disc = C0_ASYNC_SUSPENDED;
+    out.payload.frame = frame;
+    return out;
+  }
+  c0_file_release((C0FileState*)frame->op.arg);
+  if (!frame->op.ok) {
+    c0_free_managed_bytes(frame->op.data);
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = frame->op.err;
+  } else {
+    out.disc = C0_ASYNC_COMPLETED;
+    out.payload.value.data = frame->op.result != 0 ? frame->op.data : NULL;
+    out.payload.value.len = frame->op.result;
+    out.payload.value.cap = frame->op.result != 0 ? frame->op.len : 0;
+    if (frame->op.result == 0) {
+      c0_free_managed_bytes(frame->op.data);
+    }
+  }
+  c0_async_frame_free(frame);
+  return out;
+}
+
+static C0Future_Unit_IoError c0_io_write_resume(void* frame_ptr,
+                                                void* input,
+                                                void* panic_out) {
+  (void)input;
+  (void)panic_out;
+  C0IoFrame* frame = (C0IoFrame*)frame_ptr;
+  C0Future_Unit_IoError out;
+  if (!c0_reactor_poll(frame->reactor, &frame->op)) {
+    out.disc = C0_ASYNC_SUSPENDED;
+    out.payload.frame = frame;
+    return out;
+  }
+  c0_file_release((C0FileState*)frame->op.arg);
+  if (frame->op.ok) {
+    out.disc = C0_ASYNC_COMPLETED;
+    out.payload.frame = NULL;
+  } else {
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = frame->op.err;
+  }
+  c0_heap_free_raw(frame->op.data);
+  c0_async_frame_free(frame);
+  return out;
+}
+
+static C0Future_File_IoError c0_io_open_read_resume(void* frame_ptr,
+                                                    void* input,
+                                                    void* panic_out) {
+  (void)input;
+  (void)panic_out;
+  C0IoFrame* frame = (C0IoFrame*)frame_ptr;
+  C0Future_File_IoError out;
+  if (!c0_reactor_poll(frame->reactor, &frame->op)) {
+    out.disc = C0_ASYNC_SUSPENDED;
+    out.payload.frame = frame;
+    return out;
+  }
+  c0_heap_free_raw(frame->op.arg);
+  C0Union_File_IoError opened = frame->op.ok
+      ? c0_file_ok((HANDLE)(uintptr_t)frame->op.result, 0)
+      : c0_file_err(frame->op.err);
+  if (opened.disc == 1) {
+    out.disc = C0_ASYNC_COMPLETED;
+    out.payload.handle = opened.payload.handle;
+  } else {
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = opened.payload.io_error;
+  }
+  c0_async_frame_free(frame);
+  return out;
+}
+
+C0Future_BytesManaged_IoError cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3aread(
+    const C0DynObject* self,
+    const C0FileHandle* file,
+    const uint64_t* max) {
+  SPEC_RULE("Prim-Reactor-Read");
+  c0_trace_emit_rule("Prim-Reactor-Read");
+  C0Future_BytesManaged_IoError out;
+  C0FileState* state = file ? c0_file_state(file->handle) : NULL;
+  if (!state || !max || !c0_os_handle_valid(state->os_handle)) {
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = C0_IO_FAILURE;
+    return out;
+  }
+  if (*max == 0) {
+    out.disc = C0_ASYNC_COMPLETED;
+    out.payload.value.data = NULL;
+    out.payload.value.len = 0;
+    out.payload.value.cap = 0;
+    return out;
+  }
+  C0IoFrame* frame = c0_io_frame_new(c0_reactor_of(self),
+                                     (void*)c0_io_read_resume,
+                                     c0_io_work_read);
+  uint8_t* buf = frame ? c0_alloc_managed_bytes(NULL, *max, NULL) : NULL;
+  if (!buf) {
+    c0_async_frame_free(frame);
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = C0_IO_FAILURE;
+    return out;
+  }
+  c0_file_retain(state);
+  frame->op.os_handle = state->os_handle;
+  frame->op.data = buf;
+  frame->op.len = *max;
+  frame->op.arg = state;
+  c0_reactor_submit(frame->reactor, &frame->op);
+  out.disc = C0_ASYNC_SUSPENDED;
+  out.payload.frame = frame;
+  return out;
+}
+
+C0Future_Unit_IoError cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3awrite(
+    const C0DynObject* self,
+    const C0FileHandle* file,
+    const C0BytesView* data) {
+  SPEC_RULE("Prim-Reactor-Write");
+  c0_trace_emit_rule("Prim-Reactor-Write");
+  C0Future_Unit_IoError out;
+  C0FileState* state = file ? c0_file_state(file->handle) : NULL;
+  C0IoError err = C0_IO_FAILURE;
+  if (!state || !state->writable || !data || (!data->data && data->len != 0)) {
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = C0_IO_FAILURE;
+    return out;
+  }
+  // Bytes already buffered by File@Write::write go out first; the worker
+  // drains again under the handle lock before its own write.
+  if (!c0_file_drain(state, &err)) {
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = err;
+    return out;
+  }
+  if (data->len == 0) {
+    out.disc = C0_ASYNC_COMPLETED;
+    out.payload.frame = NULL;
+    return out;
+  }
+  // The view only lives for this call, so the op owns a copy.
+  C0IoFrame* frame = data->len <= (uint64_t)SIZE_MAX
+      ? c0_io_frame_new(c0_reactor_of(self), (void*)c0_io_write_resume,
+                        c0_io_work_write)
+      : NULL;
+  uint8_t* copy = frame ? (uint8_t*)c0_heap_alloc_raw((size_t)data->len) : NULL;
+  if (!copy) {
+    c0_async_frame_free(frame);
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = C0_IO_FAILURE;
+    return out;
+  }
+  c0_memcpy(copy, data->data, (size_t)data->len);
+  c0_file_retain(state);
+  frame->op.os_handle = state->os_handle;
+  frame->op.data = copy;
+  frame->op.len = data->len;
+  frame->op.arg = state;
+  c0_reactor_submit(frame->reactor, &frame->op);
+  out.disc = C0_ASYNC_SUSPENDED;
+  out.payload.frame = frame;
+  return out;
+}
+
+C0Future_File_IoError cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3aopen_x5fread(
+    const C0DynObject* self,
+    const C0DynObject* fs,
+    const C0StringView* path) {
+  SPEC_RULE("Prim-Reactor-OpenRead");
+  c0_trace_emit_rule("Prim-Reactor-OpenRead");
+  C0Future_File_IoError out;
+  uint8_t* canon = NULL;
+  uint32_t canon_len = 0;
+  if (!c0_fs_resolve_path(c0_fs_state(fs), path, &canon, &canon_len)) {
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = C0_IO_INVALID_PATH;
+    return out;
+  }
+  wchar_t* wide = c0_path_utf8_to_wide(canon, canon_len, NULL);
+  c0_heap_free_raw(canon);
+  if (!wide) {
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = C0_IO_INVALID_PATH;
+    return out;
+  }
+  C0IoFrame* frame = c0_io_frame_new(c0_reactor_of(self),
+                                     (void*)c0_io_open_read_resume,
+                                     c0_io_work_open_read);
+  if (!frame) {
+    c0_heap_free_raw(wide);
+    out.disc = C0_ASYNC_FAILED;
+    out.payload.io_error = C0_IO_FAILURE;
+    return out;
+  }
+  frame->op.arg = wide;
+  c0_reactor_submit(frame->reactor, &frame->op);
+  out.disc = C0_ASYNC_SUSPENDED;
+  out.payload.frame = frame;
+  return out;
+}
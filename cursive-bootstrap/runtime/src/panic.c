@@ -6,6 +6,7 @@ void cursive_x3a_x3aruntime_x3a_x3apanic(uint32_t code) {
     c0_parallel_raise_panic(code);
     return;
   }
+  cursive_x3a_x3aruntime_x3a_x3ashutdown();
   ExitProcess(code);
 }
 
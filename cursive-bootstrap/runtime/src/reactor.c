@@ -0,0 +1,225 @@
+#include "rt_internal.h"
+#include "rt_os.h"
+
+// Reactor behind Context.reactor.
+//
+// This is a thread-pool offload, not overlapped I/O: File handles are opened
+// for synchronous I/O and shared with the blocking File methods, so the
+// reads, writes and opens themselves run as blocking calls on a small pool of
+// worker threads. Workers post each finished op to an I/O completion port as
+// the completion key, and polling or waiting drains that port.
+//
+// An op is only marked done by the thread that drains its completion, which
+// may not be the thread waiting for it; a drain that completes ops while other
+// threads are blocked wakes them so they can re-check their own. If the pool
+// cannot be started, ops run inline at submit time.
+
+#define C0_REACTOR_WORKERS_DEFAULT 4u
+#define C0_REACTOR_WORKERS_MAX 64u
+#define C0_REACTOR_WORKERS_ENV "CURSIVE_IO_THREADS"
+
+struct C0Reactor {
+  C0OsLock lock;
+  C0OsCond work_ready;
+  C0ReactorOp* queue_head;
+  C0ReactorOp* queue_tail;
+  uint64_t pending;  // submitted and not yet observed complete
+  uint32_t waiters;  // threads blocked in c0_reactor_drain
+  int state;         // C0_REACTOR_IDLE / RUNNING / INLINE
+  HANDLE port;
+};
+
+enum {
+  C0_REACTOR_IDLE = 0,
+  C0_REACTOR_RUNNING = 1,
+  C0_REACTOR_INLINE = 2,
+};
+
+static C0Reactor c0_default_reactor = {
+  C0_OS_LOCK_INIT,
+  C0_OS_COND_INIT,
+  NULL,
+  NULL,
+  0,
+  0,
+  C0_REACTOR_IDLE,
+  NULL,
+};
+
+C0Reactor* c0_reactor_default(void) {
+  return &c0_default_reactor;
+}
+
+C0Reactor* c0_reactor_of(const C0DynObject* self) {
+  if (self && self->data) {
+    return (C0Reactor*)self->data;
+  }
+  return c0_reactor_default();
+}
+
+// Hands a finished op back to the submitting side. Runs on a worker.
+static void c0_reactor_post(C0Reactor* reactor, C0ReactorOp* op) {
+  PostQueuedCompletionStatus(reactor->port, 0, (ULONG_PTR)op, NULL);
+}
+
+// Wakes blocked waiters without completing anything.
+static void c0_reactor_wake(C0Reactor* reactor) {
+  PostQueuedCompletionStatus(reactor->port, 0, 0, NULL);
+}
+
+static void c0_reactor_worker(C0Reactor* reactor) {
+  for (;;) {
+    c0_os_lock(&reactor->lock);
+    while (!reactor->queue_head) {
+      c0_os_cond_wait(&reactor->work_ready, &reactor->lock);
+    }
+    C0ReactorOp* op = reactor->queue_head;
+    reactor->queue_head = op->next;
+    if (!reactor->queue_head) {
+      reactor->queue_tail = NULL;
+    }
+    op->next = NULL;
+    c0_os_unlock(&reactor->lock);
+
+    op->work(op);
+    c0_reactor_post(reactor, op);
+  }
+}
+
+static DWORD WINAPI c0_reactor_worker_main(LPVOID arg) {
+  c0_reactor_worker((C0Reactor*)arg);
+  return 0;
+}
+
+static uint32_t c0_reactor_worker_count(void) {
+  uint64_t count = C0_REACTOR_WORKERS_DEFAULT;
+  uint64_t env = 0;
+  if (c0_os_env_u64(C0_REACTOR_WORKERS_ENV, &env) && env != 0) {
+    count = env > C0_REACTOR_WORKERS_MAX ? C0_REACTOR_WORKERS_MAX : env;
+  }
+  return (uint32_t)count;
+}
+
+static int c0_reactor_open_queue(C0Reactor* reactor) {
+  reactor->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+  return reactor->port != NULL;
+}
+
+// Called with reactor->lock held.
+static void c0_reactor_start_locked(C0Reactor* reactor) {
+  if (reactor->state != C0_REACTOR_IDLE) {
+    return;
+  }
+  reactor->state = C0_REACTOR_INLINE;
+  if (!c0_reactor_open_queue(reactor)) {
+    return;
+  }
+  const uint32_t workers = c0_reactor_worker_count();
+  uint32_t started = 0;
+  for (uint32_t i = 0; i < workers; ++i) {
+    if (c0_os_thread_start(c0_reactor_worker_main, reactor)) {
+      ++started;
+    }
+  }
+  if (started != 0) {
+    reactor->state = C0_REACTOR_RUNNING;
+  }
+}
+
+void c0_reactor_submit(C0Reactor* reactor, C0ReactorOp* op) {
+  op->next = NULL;
+  op->done = 0;
+  c0_os_lock(&reactor->lock);
+  c0_reactor_start_locked(reactor);
+  if (reactor->state != C0_REACTOR_RUNNING) {
+    c0_os_unlock(&reactor->lock);
+    op->work(op);
+    op->done = 1;
+    return;
+  }
+  reactor->pending += 1;
+  if (reactor->queue_tail) {
+    reactor->queue_tail->next = op;
+  } else {
+    reactor->queue_head = op;
+  }
+  reactor->queue_tail = op;
+  c0_os_cond_signal(&reactor->work_ready);
+  c0_os_unlock(&reactor->lock);
+}
+
+// Drains available completions and returns how many ops it marked done. With
+// block set, first waits for a completion or a wake-up.
+static uint64_t c0_reactor_collect(C0Reactor* reactor, int block) {
+  uint64_t completed = 0;
+  DWORD timeout = block ? INFINITE : 0;
+  for (;;) {
+    DWORD bytes = 0;
+    ULONG_PTR key = 0;
+    LPOVERLAPPED overlapped = NULL;
+    if (!GetQueuedCompletionStatus(reactor->port, &bytes, &key, &overlapped,
+                                   timeout)) {
+      break;
+    }
+    timeout = 0;
+    if (!key) {
+      continue;
+    }
+    C0ReactorOp* op = (C0ReactorOp*)key;
+    c0_os_lock(&reactor->lock);
+    op->done = 1;
+    reactor->pending -= 1;
+    c0_os_unlock(&reactor->lock);
+    ++completed;
+  }
+  return completed;
+}
+
+static void c0_reactor_drain(C0Reactor* reactor, int block) {
+  if (block) {
+    c0_os_lock(&reactor->lock);
+    reactor->waiters += 1;
+    c0_os_unlock(&reactor->lock);
+  }
+  const uint64_t completed = c0_reactor_collect(reactor, block);
+  c0_os_lock(&reactor->lock);
+  if (block) {
+    reactor->waiters -= 1;
+  }
+  const int others = reactor->waiters != 0;
+  c0_os_unlock(&reactor->lock);
+  // Ops completed here may belong to a blocked thread.
+  if (completed != 0 && others) {
+    c0_reactor_wake(reactor);
+  }
+}
+
+int c0_reactor_poll(C0Reactor* reactor, C0ReactorOp* op) {
+  c0_os_lock(&reactor->lock);
+  int done = op->done;
+  const int running = reactor->state == C0_REACTOR_RUNNING;
+  c0_os_unlock(&reactor->lock);
+  if (done || !running) {
+    return done;
+  }
+  c0_reactor_drain(reactor, 0);
+  c0_os_lock(&reactor->lock);
+  done = op->done;
+  c0_os_unlock(&reactor->lock);
+  return done;
+}
+
+void c0_reactor_wait(C0Reactor* reactor) {
+  c0_os_lock(&reactor->lock);
+  const int idle = reactor->state != C0_REACTOR_RUNNING || reactor->pending == 0;
+  c0_os_unlock(&reactor->lock);
+  if (idle) {
+    return;
+  }
+  c0_reactor_drain(reactor, 1);
+}
+
+void cursive_x3a_x3aruntime_x3a_x3areactor_x3a_x3await(const C0DynObject* self) {
+  c0_trace_emit_rule("BuiltinSym-Reactor-Wait");
+  c0_reactor_wait(c0_reactor_of(self));
+}
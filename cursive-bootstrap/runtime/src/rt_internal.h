@@ -8,6 +8,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define C0_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define C0_SIMD_NEON 1
+#endif
+
 // -----------------------------------------------------------------------------
 // Internal runtime state
 // -----------------------------------------------------------------------------
@@ -42,6 +50,32 @@ typedef struct C0DirIterState {
   uint32_t index;
 } C0DirIterState;
 
+// File@Read/@Write/@Append payload: `handle` points at one of these.
+typedef struct C0FileState {
+  uintptr_t os_handle;
+  uint8_t* buf;
+  uint64_t buf_len;
+  uint64_t buf_cap;
+  int writable;
+  int line_buffered;  // drain after a write that contains '\n'
+  struct C0FileState* prev;
+  struct C0FileState* next;
+  // Read-only mapping backing map_bytes/map_text, with one reference per
+  // successful map call. unmap releases one; close detaches a mapping that
+  // is still referenced but never unmaps it (see file_map.c).
+  const uint8_t* map_base;
+  uint64_t map_len;
+  uint64_t map_refs;
+  int mapped;
+  int map_utf8;  // 0 = not checked, 1 = valid, -1 = invalid
+  // One reference for the File value plus one per in-flight reactor op; the
+  // OS handle is closed when the last is released.
+  volatile LONG refs;
+  // Serializes every operation on os_handle and the buffer between File
+  // methods and reactor workers.
+  SRWLOCK io_lock;
+} C0FileState;
+
 // -----------------------------------------------------------------------------
 // Utility helpers (no CRT)
 // -----------------------------------------------------------------------------
@@ -137,8 +171,21 @@ static __inline uint64_t c0_cstr_len(const char* s) {
   return n;
 }
 
+// Runtime spec trace (spec_trace.c). The state is read without
+// synchronization on the hot path; it only ever moves away from UNINIT once.
+enum {
+  C0_TRACE_UNINIT = 0,
+  C0_TRACE_OFF = 1,
+  C0_TRACE_ON = 2,
+};
+
+extern volatile int c0_spec_trace_state;
+
+// Writes out all buffered trace records. Called at shutdown.
+void c0_spec_trace_flush(void);
+
 static __inline void c0_trace_emit_rule(const char* rule_id) {
-  if (!rule_id) {
+  if (!rule_id || c0_spec_trace_state == C0_TRACE_OFF) {
     return;
   }
   C0StringView rule_view;
@@ -266,12 +313,71 @@ static __inline void c0_free_managed_bytes(uint8_t* data) {
 // UTF-8 helpers
 // -----------------------------------------------------------------------------
 
+// Length of the all-ASCII prefix of data[0..len). Scans 64 bytes per step
+// while the input stays ASCII, then narrows to 16-byte lanes and bytes.
+static __inline uint64_t c0_ascii_prefix_len(const uint8_t* data, uint64_t len) {
+  uint64_t i = 0;
+#if defined(C0_SIMD_SSE2)
+  while (i + 64 <= len) {
+    const __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 16));
+    const __m128i c = _mm_loadu_si128((const __m128i*)(data + i + 32));
+    const __m128i d = _mm_loadu_si128((const __m128i*)(data + i + 48));
+    const __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+    if (_mm_movemask_epi8(any) != 0) {
+      break;
+    }
+    i += 64;
+  }
+  while (i + 16 <= len) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+    if (_mm_movemask_epi8(v) != 0) {
+      break;
+    }
+    i += 16;
+  }
+#elif defined(C0_SIMD_NEON)
+  while (i + 64 <= len) {
+    const uint8x16_t a = vld1q_u8(data + i);
+    const uint8x16_t b = vld1q_u8(data + i + 16);
+    const uint8x16_t c = vld1q_u8(data + i + 32);
+    const uint8x16_t d = vld1q_u8(data + i + 48);
+    const uint8x16_t any = vorrq_u8(vorrq_u8(a, b), vorrq_u8(c, d));
+    if (vmaxvq_u8(any) >= 0x80) {
+      break;
+    }
+    i += 64;
+  }
+  while (i + 16 <= len) {
+    if (vmaxvq_u8(vld1q_u8(data + i)) >= 0x80) {
+      break;
+    }
+    i += 16;
+  }
+#else
+  while (i + 8 <= len) {
+    uint64_t word;
+    c0_memcpy(&word, data + i, 8);
+    if ((word & 0x8080808080808080ull) != 0) {
+      break;
+    }
+    i += 8;
+  }
+#endif
+  while (i < len && data[i] < 0x80) {
+    ++i;
+  }
+  return i;
+}
+
+// Single pass: ASCII runs are skipped a vector at a time, multi-byte
+// sequences are checked byte-wise.
 static __inline int c0_utf8_valid(const uint8_t* data, uint64_t len) {
   uint64_t i = 0;
   while (i < len) {
     uint8_t c = data[i];
     if (c < 0x80) {
-      ++i;
+      i += c0_ascii_prefix_len(data + i, len - i);
       continue;
     }
     if (c >= 0xC2 && c <= 0xDF) {
@@ -421,6 +527,104 @@ static __inline uint8_t* c0_wide_to_utf8(
   return out;
 }
 
+// -----------------------------------------------------------------------------
+// Buffered file and std stream writes (see file_buffer.c)
+// -----------------------------------------------------------------------------
+// The int-returning helpers return 1 on success and store the mapped error in
+// *out_err on failure.
+C0FileState* c0_file_open_state(uintptr_t os_handle, int writable);
+void c0_file_close_state(C0FileState* file);
+int c0_file_write(C0FileState* file,
+                  const uint8_t* data,
+                  uint64_t len,
+                  C0IoError* out_err);
+int c0_file_writev(C0FileState* file,
+                   const C0BytesView* parts,
+                   uint64_t count,
+                   C0IoError* out_err);
+int c0_file_flush(C0FileState* file, C0IoError* out_err);
+int c0_file_set_buffer_size(C0FileState* file,
+                            uint64_t size,
+                            C0IoError* out_err);
+// Hands buffered bytes to the OS without syncing the device.
+int c0_file_drain(C0FileState* file, C0IoError* out_err);
+void c0_file_retain(C0FileState* file);
+void c0_file_release(C0FileState* file);
+void c0_file_lock(C0FileState* file);
+void c0_file_unlock(C0FileState* file);
+// Unbuffered reads and writes for reactor workers, serialized with the File
+// methods on the same handle. The write drains pending buffered bytes first.
+int c0_file_read_through(C0FileState* file,
+                         uint8_t* data,
+                         uint64_t len,
+                         uint64_t* out_read,
+                         C0IoError* out_err);
+int c0_file_write_through(C0FileState* file,
+                          const uint8_t* data,
+                          uint64_t len,
+                          C0IoError* out_err);
+int c0_std_write(int stream,
+                 const uint8_t* data,
+                 uint64_t len,
+                 C0IoError* out_err);
+// Drains the stdout and stderr buffers; reports the first failure.
+int c0_std_flush(C0IoError* out_err);
+void c0_io_flush_all(void);
+// Best-effort drain for crash paths; never blocks on a held lock.
+void c0_io_flush_abnormal(void);
+
+// -----------------------------------------------------------------------------
+// Read-only file mappings (see file_map.c)
+// -----------------------------------------------------------------------------
+
+int c0_file_map(C0FileState* file,
+                const uint8_t** out_data,
+                uint64_t* out_len,
+                C0IoError* out_err);
+int c0_file_map_utf8(C0FileState* file,
+                     const uint8_t** out_data,
+                     uint64_t* out_len,
+                     C0IoError* out_err);
+int c0_file_unmap(C0FileState* file, C0IoError* out_err);
+void c0_file_detach_map(C0FileState* file);
+
+// -----------------------------------------------------------------------------
+// Async frames (see async.c)
+// -----------------------------------------------------------------------------
+// Untraced entry points for frames the runtime builds itself.
+void* c0_async_frame_alloc(uint64_t size, uint64_t align);
+void c0_async_frame_free(void* frame);
+
+// -----------------------------------------------------------------------------
+// Reactor (see reactor.c)
+// -----------------------------------------------------------------------------
+// An operation is submitted once, runs `work` on an I/O worker, and is marked
+// done when the reactor observes its completion. The submitter owns the op
+// and must keep it alive until c0_reactor_poll reports it done.
+typedef struct C0ReactorOp C0ReactorOp;
+typedef void (*C0ReactorWorkFn)(C0ReactorOp* op);
+
+struct C0ReactorOp {
+  C0ReactorWorkFn work;
+  C0ReactorOp* next;
+  uint8_t done;
+  uint8_t ok;
+  C0IoError err;
+  uintptr_t os_handle;
+  uint8_t* data;
+  uint64_t len;
+  uint64_t result;  // bytes transferred, or the opened OS handle
+  void* arg;        // the File state for reads/writes, the wide path for opens
+};
+
+typedef struct C0Reactor C0Reactor;
+
+C0Reactor* c0_reactor_default(void);
+C0Reactor* c0_reactor_of(const C0DynObject* self);
+void c0_reactor_submit(C0Reactor* reactor, C0ReactorOp* op);
+int c0_reactor_poll(C0Reactor* reactor, C0ReactorOp* op);
+void c0_reactor_wait(C0Reactor* reactor);
+
 // -----------------------------------------------------------------------------
 // Parallel panic integration (see parallel.c / panic.c)
 // -----------------------------------------------------------------------------
@@ -436,6 +640,7 @@ _Static_assert(sizeof(C0StringView) == 16, "string@View layout");
 _Static_assert(sizeof(C0StringManaged) == 24, "string@Managed layout");
 _Static_assert(sizeof(C0BytesView) == 16, "bytes@View layout");
 _Static_assert(sizeof(C0BytesManaged) == 24, "bytes@Managed layout");
+_Static_assert(sizeof(C0SliceBytesView) == 16, "[bytes@View] layout");
 _Static_assert(sizeof(C0DynObject) == 16, "dynamic object layout");
 _Static_assert(sizeof(C0Context) == 48, "Context layout");
 _Static_assert(sizeof(C0ExecutionDomain) == 16, "ExecutionDomain layout");
@@ -0,0 +1,321 @@
+#ifndef CURSIVE0_RT_OS_H
+#define CURSIVE0_RT_OS_H
+
+#include "cursive0_rt.h"
+
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// OS layer for buffered writes, read-only mappings and the reactor (see
+// file_buffer.c, file_map.c and reactor.c)
+//
+// The runtime targets Win32 only. OS handles are carried as uintptr_t holding
+// a HANDLE; only the primitives those paths need live here, the rest of the
+// runtime talks to Win32 directly.
+// -----------------------------------------------------------------------------
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+enum {
+  C0_STD_OUT = 0,
+  C0_STD_ERR = 1,
+};
+
+// Largest chunk handed to a single write call.
+#define C0_OS_WRITE_CHUNK 0x7FFFF000u
+
+typedef SRWLOCK C0OsLock;
+#define C0_OS_LOCK_INIT SRWLOCK_INIT
+
+static __inline void c0_os_lock(C0OsLock* lock) {
+  AcquireSRWLockExclusive(lock);
+}
+
+static __inline int c0_os_try_lock(C0OsLock* lock) {
+  return TryAcquireSRWLockExclusive(lock) != 0;
+}
+
+static __inline void c0_os_unlock(C0OsLock* lock) {
+  ReleaseSRWLockExclusive(lock);
+}
+
+typedef CONDITION_VARIABLE C0OsCond;
+#define C0_OS_COND_INIT CONDITION_VARIABLE_INIT
+
+static __inline void c0_os_cond_wait(C0OsCond* cond, C0OsLock* lock) {
+  SleepConditionVariableSRW(cond, lock, INFINITE, 0);
+}
+
+static __inline void c0_os_cond_signal(C0OsCond* cond) {
+  WakeConditionVariable(cond);
+}
+
+static __inline void c0_os_cond_broadcast(C0OsCond* cond) {
+  WakeAllConditionVariable(cond);
+}
+
+typedef LPTHREAD_START_ROUTINE C0OsThreadProc;
+
+// Starts a detached thread running proc(arg).
+static __inline int c0_os_thread_start(C0OsThreadProc proc, void* arg) {
+  HANDLE h = CreateThread(NULL, 0, proc, arg, 0, NULL);
+  if (!h) {
+    return 0;
+  }
+  CloseHandle(h);
+  return 1;
+}
+
+static __inline C0IoError c0_map_win_error(DWORD err) {
+  switch (err) {
+    case ERROR_FILE_NOT_FOUND:
+    case ERROR_PATH_NOT_FOUND:
+    case ERROR_INVALID_DRIVE:
+      return C0_IO_NOTFOUND;
+    case ERROR_ACCESS_DENIED:
+    case ERROR_PRIVILEGE_NOT_HELD:
+      return C0_IO_PERMISSION_DENIED;
+    case ERROR_FILE_EXISTS:
+    case ERROR_ALREADY_EXISTS:
+      return C0_IO_ALREADY_EXISTS;
+    case ERROR_INVALID_NAME:
+    case ERROR_BAD_PATHNAME:
+    case ERROR_FILENAME_EXCED_RANGE:
+    case ERROR_DIRECTORY:
+    case ERROR_INVALID_PARAMETER:
+      return C0_IO_INVALID_PATH;
+    case ERROR_BUSY:
+    case ERROR_SHARING_VIOLATION:
+    case ERROR_LOCK_VIOLATION:
+    case ERROR_PIPE_BUSY:
+      return C0_IO_BUSY;
+    default:
+      return C0_IO_FAILURE;
+  }
+}
+
+static __inline C0IoError c0_last_io_error(void) {
+  DWORD err = GetLastError();
+  if (err == 0) {
+    return C0_IO_FAILURE;
+  }
+  return c0_map_win_error(err);
+}
+
+static __inline int c0_os_handle_valid(uintptr_t h) {
+  return h != 0 && (HANDLE)h != INVALID_HANDLE_VALUE;
+}
+
+// Whether the handle is a character device (a console).
+static __inline int c0_os_handle_is_char(uintptr_t h) {
+  return GetFileType((HANDLE)h) == FILE_TYPE_CHAR;
+}
+
+static __inline uintptr_t c0_os_std_handle(int stream) {
+  HANDLE h = GetStdHandle(stream == C0_STD_ERR ? STD_ERROR_HANDLE
+                                               : STD_OUTPUT_HANDLE);
+  if (!h || h == INVALID_HANDLE_VALUE) {
+    return 0;
+  }
+  return (uintptr_t)h;
+}
+
+// Writes data[0..len) to h. Returns 1 on success; on failure stores the
+// mapped error in *out_err and returns 0. Either way *out_written receives the
+// number of bytes the OS accepted, so callers can keep the unsent tail.
+static __inline int c0_os_write_counted(uintptr_t h,
+                                        const uint8_t* data,
+                                        uint64_t len,
+                                        uint64_t* out_written,
+                                        C0IoError* out_err) {
+  uint64_t written = 0;
+  *out_written = 0;
+  while (written < len) {
+    uint64_t remaining = len - written;
+    uint32_t to_write = remaining > C0_OS_WRITE_CHUNK
+        ? C0_OS_WRITE_CHUNK
+        : (uint32_t)remaining;
+    DWORD chunk = 0;
+    if (!WriteFile((HANDLE)h, data + written, (DWORD)to_write, &chunk, NULL)) {
+      *out_err = c0_last_io_error();
+      *out_written = written + (uint64_t)chunk;
+      return 0;
+    }
+    if (chunk == 0) {
+      *out_err = C0_IO_FAILURE;
+      *out_written = written;
+      return 0;
+    }
+    written += (uint64_t)chunk;
+  }
+  *out_written = written;
+  return 1;
+}
+
+static __inline int c0_os_write_all(uintptr_t h,
+                                    const uint8_t* data,
+                                    uint64_t len,
+                                    C0IoError* out_err) {
+  uint64_t written = 0;
+  return c0_os_write_counted(h, data, len, &written, out_err);
+}
+
+// Reads up to len bytes from the current position of h, retrying short reads
+// until len bytes arrive or the file ends. *out_read receives the count.
+static __inline int c0_os_read_full(uintptr_t h,
+                                    uint8_t* data,
+                                    uint64_t len,
+                                    uint64_t* out_read,
+                                    C0IoError* out_err) {
+  uint64_t total = 0;
+  *out_read = 0;
+  while (total < len) {
+    uint64_t remaining = len - total;
+    uint32_t to_read = remaining > C0_OS_WRITE_CHUNK
+        ? C0_OS_WRITE_CHUNK
+        : (uint32_t)remaining;
+    DWORD chunk = 0;
+    if (!ReadFile((HANDLE)h, data + total, (DWORD)to_read, &chunk, NULL)) {
+      *out_err = c0_last_io_error();
+      return 0;
+    }
+    if (chunk == 0) {
+      break;
+    }
+    total += (uint64_t)chunk;
+  }
+  *out_read = total;
+  return 1;
+}
+
+// Writes parts[0..count) in order. *out_written receives the total number of
+// bytes accepted across all parts, on failure as well as on success.
+//
+// Win32 has no general-purpose gather write (WriteFileGather requires
+// unbuffered, sector-aligned page buffers), so parts are written in sequence;
+// callers coalesce small parts in the userspace buffer first.
+static __inline int c0_os_writev_counted(uintptr_t h,
+                                         const C0BytesView* parts,
+                                         uint64_t count,
+                                         uint64_t* out_written,
+                                         C0IoError* out_err) {
+  uint64_t total = 0;
+  *out_written = 0;
+  for (uint64_t i = 0; i < count; ++i) {
+    if (parts[i].len == 0) {
+      continue;
+    }
+    uint64_t written = 0;
+    const int ok = c0_os_write_counted(h, parts[i].data, parts[i].len,
+                                       &written, out_err);
+    total += written;
+    if (!ok) {
+      *out_written = total;
+      return 0;
+    }
+  }
+  *out_written = total;
+  return 1;
+}
+
+static __inline int c0_os_writev_all(uintptr_t h,
+                                     const C0BytesView* parts,
+                                     uint64_t count,
+                                     C0IoError* out_err) {
+  uint64_t written = 0;
+  return c0_os_writev_counted(h, parts, count, &written, out_err);
+}
+
+// Pushes OS-level buffers for h to the device.
+static __inline int c0_os_sync(uintptr_t h, C0IoError* out_err) {
+  if (!FlushFileBuffers((HANDLE)h)) {
+    *out_err = c0_last_io_error();
+    return 0;
+  }
+  return 1;
+}
+
+static __inline void c0_os_close(uintptr_t h) {
+  if (!c0_os_handle_valid(h)) {
+    return;
+  }
+  CloseHandle((HANDLE)h);
+}
+
+// Maps the whole of h read-only. An empty file yields a NULL base and zero
+// length without creating a mapping. The section handle is closed before
+// returning; the view keeps the section (and the file) alive on its own, so
+// the view stays readable after h itself is closed.
+static __inline int c0_os_map_read(uintptr_t h,
+                                   const uint8_t** out_base,
+                                   uint64_t* out_len,
+                                   C0IoError* out_err) {
+  *out_base = NULL;
+  *out_len = 0;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx((HANDLE)h, &size)) {
+    *out_err = c0_last_io_error();
+    return 0;
+  }
+  if (size.QuadPart < 0 || (uint64_t)size.QuadPart > (uint64_t)SIZE_MAX) {
+    *out_err = C0_IO_FAILURE;
+    return 0;
+  }
+  if (size.QuadPart == 0) {
+    return 1;
+  }
+  HANDLE section = CreateFileMappingW((HANDLE)h, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!section) {
+    *out_err = c0_last_io_error();
+    return 0;
+  }
+  void* base = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+  if (!base) {
+    *out_err = c0_last_io_error();
+    CloseHandle(section);
+    return 0;
+  }
+  CloseHandle(section);
+  *out_base = (const uint8_t*)base;
+  *out_len = (uint64_t)size.QuadPart;
+  return 1;
+}
+
+static __inline void c0_os_unmap(const uint8_t* base) {
+  if (base) {
+    UnmapViewOfFile(base);
+  }
+}
+
+// Reads a decimal environment variable. Returns 1 and stores the value when
+// the variable is set and well-formed.
+static __inline int c0_os_env_u64(const char* name, uint64_t* out) {
+  char buf[32];
+  uint64_t len = 0;
+  DWORD got = GetEnvironmentVariableA(name, buf, (DWORD)sizeof(buf));
+  if (got == 0 || got >= sizeof(buf)) {
+    return 0;
+  }
+  len = got;
+  if (len == 0) {
+    return 0;
+  }
+  uint64_t v = 0;
+  for (uint64_t i = 0; i < len; ++i) {
+    if (buf[i] < '0' || buf[i] > '9') {
+      return 0;
+    }
+    uint64_t digit = (uint64_t)(buf[i] - '0');
+    if (v > (UINT64_MAX - digit) / 10) {
+      return 0;
+    }
+    v = v * 10 + digit;
+  }
+  *out = v;
+  return 1;
+}
+
+#endif  // CURSIVE0_RT_OS_H
@@ -1,97 +1,494 @@
 #include "rt_internal.h"
+#include "rt_os.h"
+
+// Runtime spec trace.
+//
+// When CURSIVE_SPEC_TRACE_RUNTIME names a file, every emitted rule is
+// appended as a fixed-size binary record to a per-thread buffer. Buffers are
+// written out in bulk by a background writer every CURSIVE_SPEC_TRACE_FLUSH_MS
+// milliseconds (0 disables it), when a buffer fills up, when its thread
+// exits, and at shutdown.
+// tools/spec_trace_decode.py turns the file back into spec_trace_v1 text.
+//
+// Rule ids and payloads are interned once into a process-wide string table; a
+// record carries only their indices, the emitting thread id and a
+// QueryPerformanceCounter timestamp. Interned strings are written to the file
+// as they are created, so every index appears before the first record that
+// uses it.
+//
+// File layout (little-endian):
+//   header   "C0RTRACE", u32 version, u32 record size, u64 tick frequency
+//   string   u32 C0_TRACE_BLOCK_STRING, u32 index, u32 len, u32 0, bytes[len]
+//   records  u32 C0_TRACE_BLOCK_RECORDS, u32 count, u64 0,
+//            C0TraceRecord[count]
 
 #define C0_SPEC_TRACE_ENV L"CURSIVE_SPEC_TRACE_RUNTIME"
+#define C0_SPEC_TRACE_FLUSH_ENV "CURSIVE_SPEC_TRACE_FLUSH_MS"
+#define C0_SPEC_TRACE_FLUSH_DEFAULT_MS 100u
+
+#define C0_TRACE_VERSION 1u
+#define C0_TRACE_BLOCK_STRING 1u
+#define C0_TRACE_BLOCK_RECORDS 2u
+
+// Records per thread buffer (24 KiB).
+#define C0_TRACE_BUFFER_RECORDS 1024u
+// Per-thread string cache slots; must be a power of two.
+#define C0_TRACE_CACHE_SLOTS 64u
+// Initial string table capacity; must be a power of two.
+#define C0_TRACE_TABLE_MIN 256u
+
+#define C0_TRACE_NO_PAYLOAD UINT32_MAX
+
+typedef struct C0TraceRecord {
+  uint32_t rule;     // string index
+  uint32_t payload;  // string index, or C0_TRACE_NO_PAYLOAD
+  uint32_t thread;
+  uint32_t _pad;
+  uint64_t ticks;
+} C0TraceRecord;
+
+_Static_assert(sizeof(C0TraceRecord) == 24, "trace record layout is fixed");
+
+typedef struct C0TraceString {
+  const uint8_t* data;  // owned copy
+  uint64_t len;
+  uint64_t hash;
+  uint32_t index;
+} C0TraceString;
+
+typedef struct C0TraceCacheSlot {
+  const C0TraceString* entry;
+} C0TraceCacheSlot;
+
+typedef struct C0TraceBuffer {
+  C0OsLock lock;
+  struct C0TraceBuffer* prev;
+  struct C0TraceBuffer* next;
+  uint32_t thread;
+  uint32_t count;
+  C0TraceRecord records[C0_TRACE_BUFFER_RECORDS];
+  C0TraceCacheSlot cache[C0_TRACE_CACHE_SLOTS];
+} C0TraceBuffer;
+
+volatile int c0_spec_trace_state = C0_TRACE_UNINIT;
 
-static HANDLE c0_trace_handle = NULL;
 static LONG c0_trace_init = 0;
-static int c0_trace_enabled = 0;
-static SRWLOCK c0_trace_lock = SRWLOCK_INIT;
+static HANDLE c0_trace_handle = NULL;
+
+// Guards the file, the string table, the buffer list and c0_trace_scratch.
+// Lock order: c0_trace_lock before any C0TraceBuffer.lock.
+static C0OsLock c0_trace_lock = C0_OS_LOCK_INIT;
+static C0TraceBuffer* c0_trace_buffers = NULL;
+static C0TraceRecord c0_trace_scratch[C0_TRACE_BUFFER_RECORDS];
+
+static C0TraceString** c0_trace_table = NULL;  // open addressing by hash
+static uint64_t c0_trace_table_cap = 0;
+static uint32_t c0_trace_string_count = 0;
+
+static INIT_ONCE c0_trace_tls_once = INIT_ONCE_STATIC_INIT;
+static DWORD c0_trace_tls_index = FLS_OUT_OF_INDEXES;
+
+static uint64_t c0_trace_hash(const uint8_t* data, uint64_t len) {
+  uint64_t h = 1469598103934665603ull;
+  for (uint64_t i = 0; i < len; ++i) {
+    h ^= data[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+static int c0_trace_bytes_eq(const uint8_t* a, const uint8_t* b, uint64_t len) {
+  for (uint64_t i = 0; i < len; ++i) {
+    if (a[i] != b[i]) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static uint64_t c0_trace_ticks(void) {
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  return (uint64_t)now.QuadPart;
+}
+
+static void c0_trace_put_u32(uint8_t* out, uint32_t v) {
+  out[0] = (uint8_t)v;
+  out[1] = (uint8_t)(v >> 8);
+  out[2] = (uint8_t)(v >> 16);
+  out[3] = (uint8_t)(v >> 24);
+}
 
-static void c0_trace_write_bytes(const uint8_t* data, uint64_t len) {
-  if (!data || len == 0 || !c0_trace_handle) {
+static void c0_trace_put_u64(uint8_t* out, uint64_t v) {
+  c0_trace_put_u32(out, (uint32_t)v);
+  c0_trace_put_u32(out + 4, (uint32_t)(v >> 32));
+}
+
+// Called with c0_trace_lock held. A failed write disables tracing rather than
+// leaving a file with dangling string indices.
+static void c0_trace_write_locked(const uint8_t* data, uint64_t len) {
+  if (!c0_trace_handle || len == 0) {
+    return;
+  }
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_os_write_all((uintptr_t)c0_trace_handle, data, len, &err)) {
+    c0_spec_trace_state = C0_TRACE_OFF;
+  }
+}
+
+static void c0_trace_write_header_locked(void) {
+  LARGE_INTEGER freq;
+  if (!QueryPerformanceFrequency(&freq)) {
+    freq.QuadPart = 0;
+  }
+  uint8_t header[24];
+  c0_memcpy(header, "C0RTRACE", 8);
+  c0_trace_put_u32(header + 8, C0_TRACE_VERSION);
+  c0_trace_put_u32(header + 12, (uint32_t)sizeof(C0TraceRecord));
+  c0_trace_put_u64(header + 16, (uint64_t)freq.QuadPart);
+  c0_trace_write_locked(header, sizeof(header));
+}
+
+static void c0_trace_write_records_locked(const C0TraceRecord* records,
+                                          uint32_t count) {
+  if (count == 0) {
     return;
   }
-  uint64_t offset = 0;
-  while (offset < len) {
-    uint64_t remaining = len - offset;
-    DWORD chunk = remaining > 0xFFFFFFFFu ? 0xFFFFFFFFu : (DWORD)remaining;
-    DWORD written = 0;
-    if (!WriteFile(c0_trace_handle, data + offset, chunk, &written, NULL)) {
-      break;
+  uint8_t block[16];
+  c0_trace_put_u32(block, C0_TRACE_BLOCK_RECORDS);
+  c0_trace_put_u32(block + 4, count);
+  c0_trace_put_u64(block + 8, 0);
+  // Records are written in host order; the runtime only targets little-endian
+  // hosts.
+  C0BytesView parts[2];
+  parts[0].data = block;
+  parts[0].len = sizeof(block);
+  parts[1].data = (const uint8_t*)records;
+  parts[1].len = (uint64_t)count * sizeof(C0TraceRecord);
+  C0IoError err = C0_IO_FAILURE;
+  if (!c0_os_writev_all((uintptr_t)c0_trace_handle, parts, 2, &err)) {
+    c0_spec_trace_state = C0_TRACE_OFF;
+  }
+}
+
+static int c0_trace_table_grow_locked(void) {
+  const uint64_t cap = c0_trace_table_cap ? c0_trace_table_cap * 2
+                                          : C0_TRACE_TABLE_MIN;
+  C0TraceString** table =
+      (C0TraceString**)c0_heap_alloc_raw((size_t)(cap * sizeof(C0TraceString*)));
+  if (!table) {
+    return 0;
+  }
+  for (uint64_t i = 0; i < cap; ++i) {
+    table[i] = NULL;
+  }
+  for (uint64_t i = 0; i < c0_trace_table_cap; ++i) {
+    C0TraceString* entry = c0_trace_table[i];
+    if (!entry) {
+      continue;
     }
-    if (written == 0) {
-      break;
+    uint64_t slot = entry->hash & (cap - 1);
+    while (table[slot]) {
+      slot = (slot + 1) & (cap - 1);
     }
-    offset += written;
+    table[slot] = entry;
   }
+  c0_heap_free_raw(c0_trace_table);
+  c0_trace_table = table;
+  c0_trace_table_cap = cap;
+  return 1;
 }
 
-static void c0_trace_write_cstr(const char* text) {
-  if (!text) {
+// Called with c0_trace_lock held. Entries are never freed or mutated once
+// published, so per-thread caches may keep pointers to them.
+static const C0TraceString* c0_trace_intern_locked(const uint8_t* data,
+                                                   uint64_t len,
+                                                   uint64_t hash) {
+  if (c0_trace_table_cap != 0) {
+    uint64_t slot = hash & (c0_trace_table_cap - 1);
+    while (c0_trace_table[slot]) {
+      const C0TraceString* entry = c0_trace_table[slot];
+      if (entry->hash == hash && entry->len == len &&
+          c0_trace_bytes_eq(entry->data, data, len)) {
+        return entry;
+      }
+      slot = (slot + 1) & (c0_trace_table_cap - 1);
+    }
+  }
+  if (len > UINT32_MAX || c0_trace_string_count == C0_TRACE_NO_PAYLOAD) {
+    return NULL;
+  }
+  // Keep the load factor at or below one half.
+  if ((uint64_t)(c0_trace_string_count + 1) * 2 > c0_trace_table_cap &&
+      !c0_trace_table_grow_locked()) {
+    return NULL;
+  }
+  C0TraceString* entry =
+      (C0TraceString*)c0_heap_alloc_raw(sizeof(C0TraceString) + (size_t)len);
+  if (!entry) {
+    return NULL;
+  }
+  uint8_t* copy = (uint8_t*)(entry + 1);
+  if (len != 0) {
+    c0_memcpy(copy, data, (size_t)len);
+  }
+  entry->data = copy;
+  entry->len = len;
+  entry->hash = hash;
+  entry->index = c0_trace_string_count++;
+
+  uint64_t slot = hash & (c0_trace_table_cap - 1);
+  while (c0_trace_table[slot]) {
+    slot = (slot + 1) & (c0_trace_table_cap - 1);
+  }
+  c0_trace_table[slot] = entry;
+
+  uint8_t block[16];
+  c0_trace_put_u32(block, C0_TRACE_BLOCK_STRING);
+  c0_trace_put_u32(block + 4, entry->index);
+  c0_trace_put_u32(block + 8, (uint32_t)len);
+  c0_trace_put_u32(block + 12, 0);
+  c0_trace_write_locked(block, sizeof(block));
+  c0_trace_write_locked(copy, len);
+  return entry;
+}
+
+// Copies the buffer out under its own lock and writes the copy, so the owning
+// thread is only blocked for the memcpy. Called with c0_trace_lock held.
+static void c0_trace_drain_locked(C0TraceBuffer* buffer) {
+  c0_os_lock(&buffer->lock);
+  const uint32_t count = buffer->count;
+  if (count != 0) {
+    c0_memcpy(c0_trace_scratch, buffer->records,
+              (size_t)count * sizeof(C0TraceRecord));
+    buffer->count = 0;
+  }
+  c0_os_unlock(&buffer->lock);
+  c0_trace_write_records_locked(c0_trace_scratch, count);
+}
+
+static void c0_trace_drain_all(void) {
+  c0_os_lock(&c0_trace_lock);
+  for (C0TraceBuffer* buffer = c0_trace_buffers; buffer; buffer = buffer->next) {
+    c0_trace_drain_locked(buffer);
+  }
+  c0_os_unlock(&c0_trace_lock);
+}
+
+// Runs on thread exit with that thread's buffer: writes out what it still
+// holds, then unlinks and frees it, so threads started per parallel block do
+// not leave buffers behind.
+static VOID WINAPI c0_trace_buffer_retire(PVOID data) {
+  C0TraceBuffer* buffer = (C0TraceBuffer*)data;
+  if (!buffer) {
     return;
   }
-  c0_trace_write_bytes((const uint8_t*)text, c0_cstr_len(text));
+  c0_os_lock(&c0_trace_lock);
+  c0_trace_drain_locked(buffer);
+  if (buffer->prev) {
+    buffer->prev->next = buffer->next;
+  } else {
+    c0_trace_buffers = buffer->next;
+  }
+  if (buffer->next) {
+    buffer->next->prev = buffer->prev;
+  }
+  c0_os_unlock(&c0_trace_lock);
+  c0_heap_free_raw(buffer);
 }
 
-static void c0_trace_write_encoded(const uint8_t* data, uint64_t len) {
-  static const char hex[] = "0123456789ABCDEF";
-  for (uint64_t i = 0; i < len; ++i) {
-    uint8_t c = data[i];
-    if (c == '\t' || c == '\n' || c == '%' || c == ';' || c == '=') {
-      char out[3];
-      out[0] = '%';
-      out[1] = hex[(c >> 4) & 0xF];
-      out[2] = hex[c & 0xF];
-      c0_trace_write_bytes((const uint8_t*)out, 3);
-    } else {
-      c0_trace_write_bytes(&c, 1);
+static BOOL CALLBACK c0_trace_tls_init(PINIT_ONCE init_once, PVOID param,
+                                       PVOID* context) {
+  (void)init_once;
+  (void)param;
+  (void)context;
+  DWORD idx = FlsAlloc(c0_trace_buffer_retire);
+  if (idx == FLS_OUT_OF_INDEXES) {
+    return FALSE;
+  }
+  c0_trace_tls_index = idx;
+  return TRUE;
+}
+
+// Buffers live in fiber-local storage; c0_trace_buffer_retire drains and
+// frees each one when its thread exits.
+static C0TraceBuffer* c0_trace_buffer(void) {
+  if (!InitOnceExecuteOnce(&c0_trace_tls_once, c0_trace_tls_init, NULL, NULL)) {
+    return NULL;
+  }
+  C0TraceBuffer* buffer = (C0TraceBuffer*)FlsGetValue(c0_trace_tls_index);
+  if (buffer) {
+    return buffer;
+  }
+  buffer = (C0TraceBuffer*)c0_heap_alloc_raw(sizeof(C0TraceBuffer));
+  if (!buffer) {
+    return NULL;
+  }
+  const C0OsLock init = C0_OS_LOCK_INIT;
+  buffer->lock = init;
+  buffer->thread = (uint32_t)GetCurrentThreadId();
+  buffer->count = 0;
+  for (uint32_t i = 0; i < C0_TRACE_CACHE_SLOTS; ++i) {
+    buffer->cache[i].entry = NULL;
+  }
+  if (!FlsSetValue(c0_trace_tls_index, buffer)) {
+    c0_heap_free_raw(buffer);
+    return NULL;
+  }
+  c0_os_lock(&c0_trace_lock);
+  buffer->prev = NULL;
+  buffer->next = c0_trace_buffers;
+  if (c0_trace_buffers) {
+    c0_trace_buffers->prev = buffer;
+  }
+  c0_trace_buffers = buffer;
+  c0_os_unlock(&c0_trace_lock);
+  return buffer;
+}
+
+// Resolves a string to its index, consulting the thread's cache before the
+// shared table. Returns C0_TRACE_NO_PAYLOAD when the table is unavailable.
+static uint32_t c0_trace_index(C0TraceBuffer* buffer,
+                               const uint8_t* data,
+                               uint64_t len) {
+  const uint64_t hash = c0_trace_hash(data, len);
+  C0TraceCacheSlot* slot = NULL;
+  if (buffer) {
+    slot = &buffer->cache[hash & (C0_TRACE_CACHE_SLOTS - 1)];
+    const C0TraceString* entry = slot->entry;
+    if (entry && entry->hash == hash && entry->len == len &&
+        c0_trace_bytes_eq(entry->data, data, len)) {
+      return entry->index;
     }
   }
+  c0_os_lock(&c0_trace_lock);
+  const C0TraceString* entry = c0_trace_intern_locked(data, len, hash);
+  c0_os_unlock(&c0_trace_lock);
+  if (!entry) {
+    return C0_TRACE_NO_PAYLOAD;
+  }
+  if (slot) {
+    slot->entry = entry;
+  }
+  return entry->index;
 }
 
-static void c0_spec_trace_init(void) {
-  if (InterlockedCompareExchange(&c0_trace_init, 1, 0) != 0) {
-    return;
+static DWORD WINAPI c0_trace_writer_main(LPVOID arg) {
+  const DWORD interval = (DWORD)(uintptr_t)arg;
+  for (;;) {
+    Sleep(interval);
+    c0_trace_drain_all();
   }
+  return 0;
+}
+
+static HANDLE c0_trace_open(void) {
   DWORD needed = GetEnvironmentVariableW(C0_SPEC_TRACE_ENV, NULL, 0);
   if (needed == 0) {
-    return;
+    return NULL;
   }
   wchar_t* path = (wchar_t*)c0_heap_alloc_raw(sizeof(wchar_t) * needed);
   if (!path) {
-    return;
+    return NULL;
   }
   DWORD got = GetEnvironmentVariableW(C0_SPEC_TRACE_ENV, path, needed);
   if (got == 0 || got >= needed) {
     c0_heap_free_raw(path);
-    return;
+    return NULL;
   }
   HANDLE handle = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ,
                               NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
   c0_heap_free_raw(path);
   if (handle == INVALID_HANDLE_VALUE) {
+    return NULL;
+  }
+  return handle;
+}
+
+static void c0_spec_trace_init(void) {
+  if (InterlockedCompareExchange(&c0_trace_init, 1, 0) != 0) {
+    // Another thread is initializing; wait for it to publish the state.
+    while (c0_spec_trace_state == C0_TRACE_UNINIT) {
+      Sleep(0);
+    }
+    return;
+  }
+  HANDLE handle = c0_trace_open();
+  if (!handle) {
+    c0_spec_trace_state = C0_TRACE_OFF;
     return;
   }
+  c0_os_lock(&c0_trace_lock);
   c0_trace_handle = handle;
-  c0_trace_enabled = 1;
-  c0_trace_write_cstr("spec_trace_v1\n");
+  c0_trace_write_header_locked();
+  c0_os_unlock(&c0_trace_lock);
+
+  uint64_t interval = C0_SPEC_TRACE_FLUSH_DEFAULT_MS;
+  uint64_t env = 0;
+  if (c0_os_env_u64(C0_SPEC_TRACE_FLUSH_ENV, &env)) {
+    interval = env > 0xFFFFFFFEu ? 0xFFFFFFFEu : env;
+  }
+  c0_spec_trace_state = C0_TRACE_ON;
+  if (interval != 0) {
+    // Without a writer, buffers are still written when full and at shutdown.
+    (void)c0_os_thread_start(c0_trace_writer_main, (void*)(uintptr_t)interval);
+  }
+}
+
+void c0_spec_trace_flush(void) {
+  if (c0_spec_trace_state != C0_TRACE_ON) {
+    return;
+  }
+  c0_trace_drain_all();
+  c0_os_lock(&c0_trace_lock);
+  if (c0_trace_handle) {
+    FlushFileBuffers(c0_trace_handle);
+  }
+  c0_os_unlock(&c0_trace_lock);
 }
 
 void cursive_x3a_x3aruntime_x3a_x3aspec_x5ftrace_x3a_x3aemit(
     const C0StringView* rule_id,
     const C0StringView* payload) {
-  c0_spec_trace_init();
-  if (!c0_trace_enabled || !rule_id || !rule_id->data || rule_id->len == 0) {
+  if (c0_spec_trace_state == C0_TRACE_UNINIT) {
+    c0_spec_trace_init();
+  }
+  if (c0_spec_trace_state != C0_TRACE_ON || !rule_id || !rule_id->data ||
+      rule_id->len == 0) {
     return;
   }
-  AcquireSRWLockExclusive(&c0_trace_lock);
-  c0_trace_write_cstr("runtime\truntime\t");
-  c0_trace_write_bytes(rule_id->data, rule_id->len);
-  c0_trace_write_cstr("\t-\t0\t0\t0\t0\t");
+  C0TraceRecord record;
+  record.ticks = c0_trace_ticks();
+  record._pad = 0;
+
+  C0TraceBuffer* buffer = c0_trace_buffer();
+  record.rule = c0_trace_index(buffer, rule_id->data, rule_id->len);
+  if (record.rule == C0_TRACE_NO_PAYLOAD) {
+    return;
+  }
+  record.payload = C0_TRACE_NO_PAYLOAD;
   if (payload && payload->data && payload->len != 0) {
-    c0_trace_write_encoded(payload->data, payload->len);
+    record.payload = c0_trace_index(buffer, payload->data, payload->len);
+  }
+  record.thread = buffer ? buffer->thread : (uint32_t)GetCurrentThreadId();
+
+  if (!buffer) {
+    // No thread buffer: write the record through.
+    c0_os_lock(&c0_trace_lock);
+    c0_trace_write_records_locked(&record, 1);
+    c0_os_unlock(&c0_trace_lock);
+    return;
+  }
+
+  c0_os_lock(&buffer->lock);
+  if (buffer->count == C0_TRACE_BUFFER_RECORDS) {
+    // Full: drain it ourselves, respecting the global-then-buffer lock order.
+    c0_os_unlock(&buffer->lock);
+    c0_os_lock(&c0_trace_lock);
+    c0_trace_drain_locked(buffer);
+    c0_os_unlock(&c0_trace_lock);
+    c0_os_lock(&buffer->lock);
   }
-  c0_trace_write_cstr("\n");
-  FlushFileBuffers(c0_trace_handle);
-  ReleaseSRWLockExclusive(&c0_trace_lock);
+  buffer->records[buffer->count++] = record;
+  c0_os_unlock(&buffer->lock);
 }
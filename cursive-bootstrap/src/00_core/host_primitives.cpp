@@ -30,6 +30,7 @@ bool IsFSPrim(HostPrim prim) {
     case HostPrim::FSWriteFile:
     case HostPrim::FSWriteStdout:
     case HostPrim::FSWriteStderr:
+    case HostPrim::FSFlushStd:
     case HostPrim::FSExists:
     case HostPrim::FSRemove:
     case HostPrim::FSOpenDir:
@@ -1,5 +1,6 @@
 #include "cursive0/00_core/spec_trace.h"
 
+#include <atomic>
 #include <fstream>
 #include <mutex>
 #include <sstream>
@@ -16,7 +17,8 @@ struct TraceState {
   std::string domain;
   std::string phase;
   std::string root;
-  bool enabled = false;
+  // Read without the mutex on every Record; rules fire on worker threads.
+  std::atomic<bool> enabled{false};
 };
 
 TraceState& State() {
@@ -99,6 +101,9 @@ void SpecTrace::Record(std::string_view rule_id,
                        const std::optional<Span>& span,
                        std::string_view payload) {
   auto& state = State();
+  if (!state.enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
   std::lock_guard<std::mutex> lock(state.mutex);
   if (!state.enabled) {
     return;
@@ -98,6 +98,48 @@ bool IsSpecialArchiveMember(std::string_view name) {
   return name == "/" || name == "//";
 }
 
+// LLVM bitcode, raw or in the wrapper header; produced for --lto builds.
+bool IsBitcode(std::string_view bytes) {
+  if (bytes.size() < 4) {
+    return false;
+  }
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(bytes.data());
+  const bool raw = data[0] == 'B' && data[1] == 'C' && data[2] == 0xC0 && data[3] == 0xDE;
+  const bool wrapped = data[0] == 0xDE && data[1] == 0xC0 && data[2] == 0x17 && data[3] == 0x0B;
+  return raw || wrapped;
+}
+
+uint32_t ReadU32BE(const unsigned char* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+// First linker member ("/"): big-endian count, offsets, then names. It is
+// the only symbol source for bitcode members, which have no COFF table.
+bool ParseFirstLinkerMember(std::string_view member,
+                            std::vector<std::string>& symbols) {
+  if (member.size() < 4) {
+    return false;
+  }
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(member.data());
+  const std::size_t count = ReadU32BE(data);
+  std::size_t pos = 4 + count * 4;
+  if (pos > member.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::size_t end = member.find('\0', pos);
+    if (end == std::string_view::npos) {
+      return false;
+    }
+    if (end > pos) {
+      symbols.emplace_back(member.substr(pos, end - pos));
+    }
+    pos = end + 1;
+  }
+  return true;
+}
+
 std::optional<std::string> CoffSymbolName(std::string_view bytes,
                                           std::size_t entry_offset,
                                           std::size_t string_table_offset,
@@ -221,8 +263,12 @@ bool ParseArchiveSymbols(std::string_view bytes,
     if (data_offset + size > bytes.size()) {
       return false;
     }
-    if (!IsSpecialArchiveMember(name)) {
-      const std::string_view member(bytes.data() + data_offset, size);
+    const std::string_view member(bytes.data() + data_offset, size);
+    if (name == "/" && offset == 8) {
+      if (!ParseFirstLinkerMember(member, symbols)) {
+        return false;
+      }
+    } else if (!IsSpecialArchiveMember(name) && !IsBitcode(member)) {
       if (!ParseCoffSymbols(member, symbols)) {
         return false;
       }
@@ -248,6 +294,8 @@ std::optional<std::vector<std::string>> LinkerSymsForInputs(
       if (!ParseArchiveSymbols(*bytes, symbols)) {
         return std::nullopt;
       }
+    } else if (IsBitcode(*bytes)) {
+      // Module bitcode only references the runtime; nothing to collect.
     } else {
       if (!ParseCoffSymbols(*bytes, symbols)) {
         return std::nullopt;
@@ -297,12 +345,17 @@ std::filesystem::path RuntimeLibPath(const Project& project) {
   return project.root / "runtime" / "cursive0_rt.lib";
 }
 
+std::filesystem::path RuntimeBitcodeLibPath(const Project& project) {
+  return project.root / "runtime" / "cursive0_rt_lto.lib";
+}
+
 std::vector<std::string> RuntimeRequiredSyms() {
   std::vector<std::string> syms;
   syms.push_back(core::PathSig({"cursive", "runtime", "panic"}));
   syms.push_back(core::PathSig({"cursive", "runtime", "string", "drop_managed"}));
   syms.push_back(core::PathSig({"cursive", "runtime", "bytes", "drop_managed"}));
   syms.push_back(core::PathSig({"cursive", "runtime", "context_init"}));
+  syms.push_back(core::PathSig({"cursive", "runtime", "shutdown"}));
   syms.push_back(core::PathSig({"cursive", "runtime", "spec_trace", "emit"}));
 
   const std::string_view region_procs[] = {
@@ -360,6 +413,7 @@ std::vector<std::string> RuntimeRequiredSyms() {
       "write_file",
       "write_stdout",
       "write_stderr",
+      "flush_std",
       "exists",
       "remove",
       "open_dir",
@@ -381,12 +435,31 @@ std::vector<std::string> RuntimeRequiredSyms() {
     syms.push_back(core::PathSig({"cursive", "runtime", "heap", name}));
   }
 
+  const std::string_view reactor_methods[] = {
+      "read",
+      "write",
+      "open_read",
+      "wait",
+  };
+  for (const auto& name : reactor_methods) {
+    syms.push_back(core::PathSig({"cursive", "runtime", "reactor", name}));
+  }
+
   std::sort(syms.begin(), syms.end());
   syms.erase(std::unique(syms.begin(), syms.end()), syms.end());
   return syms;
 }
 
 std::optional<std::filesystem::path> ResolveRuntimeLib(const Project& project) {
+  // LTO builds link the bitcode runtime when it was built, so its helpers
+  // can be imported into Cursive modules; otherwise the native archive.
+  if (LtoMode(project) != "none") {
+    const auto bitcode = RuntimeBitcodeLibPath(project);
+    if (ReadFileBytes(bitcode).has_value()) {
+      SPEC_RULE("ResolveRuntimeLib-Ok");
+      return bitcode;
+    }
+  }
   const auto path = RuntimeLibPath(project);
   const auto bytes = ReadFileBytes(path);
   if (!bytes.has_value()) {
@@ -542,8 +615,9 @@ LinkResult LinkWithDeps(const std::vector<std::filesystem::path>& objs,
                         const LinkDeps& deps) {
   LinkResult result;
 
+  // Only lld-link runs the LTO backends over bitcode inputs.
   auto tool = deps.resolve_tool(project, "lld-link");
-  if (!tool.has_value()) {
+  if (!tool.has_value() && LtoMode(project) == "none") {
     tool = deps.resolve_tool(project, "link");
   }
   if (!tool.has_value()) {
@@ -181,6 +181,13 @@ std::filesystem::path IRPath(const Project& project,
   return project.outputs.ir_dir / (mangled + ext);
 }
 
+std::string_view LtoMode(const Project& project) {
+  if (project.assembly.lto.has_value()) {
+    return *project.assembly.lto;
+  }
+  return "none";
+}
+
 std::filesystem::path ExePath(const Project& project) {
   return project.outputs.bin_dir / (project.assembly.name + ".exe");
 }
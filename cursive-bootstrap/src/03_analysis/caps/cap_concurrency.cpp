@@ -56,6 +56,29 @@ static syntax::Param MakeParam(std::string_view name,
   return param;
 }
 
+static std::shared_ptr<syntax::Type> MakeTypeDynamicAst(
+    std::initializer_list<std::string_view> comps) {
+  syntax::TypeDynamic node;
+  for (const auto comp : comps) {
+    node.path.emplace_back(comp);
+  }
+  return MakeTypeNode(node);
+}
+
+static std::shared_ptr<syntax::Type> MakeTypeStringAst(
+    std::optional<syntax::StringState> state) {
+  syntax::TypeString node;
+  node.state = state;
+  return MakeTypeNode(node);
+}
+
+static std::shared_ptr<syntax::Type> MakeTypeBytesAst(
+    std::optional<syntax::BytesState> state) {
+  syntax::TypeBytes node;
+  node.state = state;
+  return MakeTypeNode(node);
+}
+
 static std::shared_ptr<syntax::Type> MakeTypeModalStateAst(
     std::initializer_list<std::string_view> comps,
     std::string_view state) {
@@ -713,4 +736,54 @@ syntax::ClassDecl BuildReactorClassDecl() {
   return decl;
 }
 
+TypeRef MakeFutureType(const TypeRef& value_type, const TypeRef& err_type) {
+  SpecDefsConcurrency();
+  TypePathType path_type;
+  path_type.path = {"Async"};
+  path_type.generic_args = {TypeUnit(), TypeUnit(), value_type, err_type};
+  return MakeType(path_type);
+}
+
+std::optional<ReactorMethodSig> LookupReactorMethodSig(std::string_view name) {
+  SpecDefsConcurrency();
+  ReactorMethodSig sig{};
+  sig.recv_perm = Permission::Const;
+  const auto io_error = MakeTypePath({"IoError"});
+
+  // procedure read(~, file: File@Read, max: usize) -> Future<bytes@Managed, IoError>
+  if (StrEq(name, "read")) {
+    sig.params = {
+        MakeParam("file", MakeTypeModalStateAst({"File"}, "Read")),
+        MakeParam("max", MakeTypePrimAst("usize")),
+    };
+    sig.ret = MakeFutureType(MakeTypeBytes(BytesState::Managed), io_error);
+    return sig;
+  }
+
+  // procedure write(~, file: File@Write, data: bytes@View) -> Future<(), IoError>
+  if (StrEq(name, "write")) {
+    sig.params = {
+        MakeParam("file", MakeTypeModalStateAst({"File"}, "Write")),
+        MakeParam("data", MakeTypeBytesAst(syntax::BytesState::View)),
+    };
+    sig.ret = MakeFutureType(TypeUnit(), io_error);
+    return sig;
+  }
+
+  // procedure open_read(~, fs: $FileSystem, path: string@View)
+  //   -> Future<unique File@Read, IoError>
+  if (StrEq(name, "open_read")) {
+    sig.params = {
+        MakeParam("fs", MakeTypeDynamicAst({"FileSystem"})),
+        MakeParam("path", MakeTypeStringAst(syntax::StringState::View)),
+    };
+    sig.ret = MakeFutureType(
+        MakeTypePerm(Permission::Unique, MakeTypeModalState({"File"}, "Read")),
+        io_error);
+    return sig;
+  }
+
+  return std::nullopt;
+}
+
 }  // namespace cursive0::analysis
@@ -54,6 +54,13 @@ static std::shared_ptr<syntax::Type> MakeTypeBytesAst(
   return MakeTypeNode(node);
 }
 
+static std::shared_ptr<syntax::Type> MakeTypeSliceAst(
+    std::shared_ptr<syntax::Type> element) {
+  syntax::TypeSlice node;
+  node.element = std::move(element);
+  return MakeTypeNode(node);
+}
+
 static std::shared_ptr<syntax::Type> MakeTypeModalStateAst(
     std::initializer_list<std::string_view> comps,
     std::string_view state) {
@@ -265,6 +272,11 @@ std::optional<FileSystemMethodSig> LookupFileSystemMethodSig(
     sig.ret = Union2(TypeUnit(), TypeIoError());
     return sig;
   }
+  if (IdEq(name, "flush_std")) {
+    sig.params = {};
+    sig.ret = Union2(TypeUnit(), TypeIoError());
+    return sig;
+  }
   if (IdEq(name, "exists")) {
     sig.params = {MakeParam("path", MakeTypeStringAst(syntax::StringState::View))};
     sig.ret = TypeBool();
@@ -334,6 +346,18 @@ syntax::ModalDecl BuildFileModalDecl() {
       "read_all_bytes", {},
       MakeTypeUnionAst({MakeTypeBytesAst(syntax::BytesState::Managed),
                         MakeTypePathAst({"IoError"})})));
+  read_members.push_back(MakeStateMethod(
+      "map_bytes", {},
+      MakeTypeUnionAst({MakeTypeBytesAst(syntax::BytesState::View),
+                        MakeTypePathAst({"IoError"})})));
+  read_members.push_back(MakeStateMethod(
+      "map_text", {},
+      MakeTypeUnionAst({MakeTypeStringAst(syntax::StringState::View),
+                        MakeTypePathAst({"IoError"})})));
+  read_members.push_back(MakeStateMethod(
+      "unmap", {},
+      MakeTypeUnionAst({MakeTypePrimAst("()"),
+                        MakeTypePathAst({"IoError"})})));
   read_members.push_back(MakeTransition("close", {}, "Closed"));
 
   std::vector<syntax::StateMember> write_members;
@@ -341,9 +365,17 @@ syntax::ModalDecl BuildFileModalDecl() {
   write_members.push_back(MakeStateMethod(
       "write", {MakeParam("data", MakeTypeBytesAst(syntax::BytesState::View))},
       MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
+  write_members.push_back(MakeStateMethod(
+      "write_vectored",
+      {MakeParam("parts",
+                 MakeTypeSliceAst(MakeTypeBytesAst(syntax::BytesState::View)))},
+      MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
   write_members.push_back(MakeStateMethod(
       "flush", {},
       MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
+  write_members.push_back(MakeStateMethod(
+      "set_buffer_size", {MakeParam("size", MakeTypePrimAst("usize"))},
+      MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
   write_members.push_back(MakeTransition("close", {}, "Closed"));
 
   std::vector<syntax::StateMember> append_members;
@@ -351,9 +383,17 @@ syntax::ModalDecl BuildFileModalDecl() {
   append_members.push_back(MakeStateMethod(
       "write", {MakeParam("data", MakeTypeBytesAst(syntax::BytesState::View))},
       MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
+  append_members.push_back(MakeStateMethod(
+      "write_vectored",
+      {MakeParam("parts",
+                 MakeTypeSliceAst(MakeTypeBytesAst(syntax::BytesState::View)))},
+      MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
   append_members.push_back(MakeStateMethod(
       "flush", {},
       MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
+  append_members.push_back(MakeStateMethod(
+      "set_buffer_size", {MakeParam("size", MakeTypePrimAst("usize"))},
+      MakeTypeUnionAst({MakeTypePrimAst("()"), MakeTypePathAst({"IoError"})})));
   append_members.push_back(MakeTransition("close", {}, "Closed"));
 
   std::vector<syntax::StateMember> closed_members;
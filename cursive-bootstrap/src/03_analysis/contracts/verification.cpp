@@ -1,5 +1,6 @@
 #include "cursive0/03_analysis/contracts/verification.h"
 
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <string>
@@ -656,80 +657,156 @@ static PredConstraints BuildConstraintsFromPredicate(
   return out;
 }
 
-static bool EntailsConstraints(const std::vector<DiffConstraint>& facts,
+static bool EntailsConstraints(const DiffConstraintSolver& solver,
                                const std::vector<DiffConstraint>& targets) {
   if (targets.empty()) {
     return false;
   }
-  std::unordered_map<std::string, std::size_t> indices;
-  std::vector<std::string> vars;
-  auto add_var = [&](const std::string& var) {
-    if (indices.find(var) != indices.end()) {
-      return;
+  for (const auto& target : targets) {
+    if (!solver.Entails(target.x, target.y, target.c)) {
+      return false;
     }
-    indices[var] = vars.size();
-    vars.push_back(var);
-  };
+  }
+  return true;
+}
 
-  add_var("__zero");
-  for (const auto& c : facts) {
-    add_var(c.x);
-    add_var(c.y);
+static void AddLinearFact(DiffConstraintSolver& solver,
+                          const syntax::ExprPtr& predicate) {
+  const auto pred = BuildConstraintsFromPredicate(predicate);
+  if (!pred.ok || pred.constant) {
+    // Constant facts carry no linear information (false ones are an
+    // inconsistent fact set; be conservative and ignore them).
+    return;
   }
-  for (const auto& c : targets) {
-    add_var(c.x);
-    add_var(c.y);
+  for (const auto& c : pred.constraints) {
+    solver.Add(c.x, c.y, c.c);
   }
+}
+
+constexpr std::int64_t kNoPath = std::numeric_limits<std::int64_t>::max() / 4;
+
+}  // namespace
 
-  const std::size_t n = vars.size();
-  const auto INF = std::numeric_limits<std::int64_t>::max() / 4;
-  std::vector<std::vector<std::int64_t>> dist(
-      n, std::vector<std::int64_t>(n, INF));
-  for (std::size_t i = 0; i < n; ++i) {
-    dist[i][i] = 0;
+bool ExprStructEqual(const syntax::ExprPtr& a, const syntax::ExprPtr& b) {
+  return ExprStructEqualInternal(a, b);
+}
+
+std::optional<std::uint32_t> DiffConstraintSolver::Find(std::string_view term) const {
+  const auto it = ids_.find(std::string(term));
+  if (it == ids_.end()) {
+    return std::nullopt;
   }
-  for (const auto& c : facts) {
-    const auto from = indices[c.y];
-    const auto to = indices[c.x];
-    if (c.c < dist[from][to]) {
-      dist[from][to] = c.c;
+  return it->second;
+}
+
+std::uint32_t DiffConstraintSolver::Intern(std::string_view term) {
+  if (const auto id = Find(term)) {
+    return *id;
+  }
+  const auto id = static_cast<std::uint32_t>(terms_.size());
+  if (terms_.size() == stride_) {
+    const std::size_t stride = stride_ == 0 ? 8 : stride_ * 2;
+    std::vector<std::int64_t> dist(stride * stride, kNoPath);
+    for (std::size_t i = 0; i < stride_; ++i) {
+      std::copy_n(dist_.begin() + static_cast<std::ptrdiff_t>(i * stride_), stride_,
+                  dist.begin() + static_cast<std::ptrdiff_t>(i * stride));
+    }
+    for (std::size_t i = stride_; i < stride; ++i) {
+      dist[i * stride + i] = 0;
     }
+    dist_ = std::move(dist);
+    stride_ = stride;
   }
+  ids_.emplace(std::string(term), id);
+  terms_.emplace_back(term);
+  return id;
+}
 
-  for (std::size_t k = 0; k < n; ++k) {
-    for (std::size_t i = 0; i < n; ++i) {
-      if (dist[i][k] >= INF) {
+bool DiffConstraintSolver::Add(std::string_view x,
+                               std::string_view y,
+                               std::int64_t c) {
+  if (!consistent_) {
+    return false;
+  }
+  // x - y <= c is the edge y -> x of weight c.
+  const auto from = Intern(y);
+  const auto to = Intern(x);
+  if (At(from, to) <= c) {
+    return true;
+  }
+  std::int64_t cycle = 0;
+  if (At(to, from) < kNoPath && CheckedAdd(At(to, from), c, cycle) && cycle < 0) {
+    consistent_ = false;
+    return false;
+  }
+  // Every shortest path that improves goes i -> from -> to -> j.
+  const auto n = static_cast<std::uint32_t>(terms_.size());
+  std::vector<std::int64_t> into_from(n);
+  std::vector<std::int64_t> out_of_to(n);
+  for (std::uint32_t k = 0; k < n; ++k) {
+    into_from[k] = At(k, from);
+    out_of_to[k] = At(to, k);
+  }
+  for (std::uint32_t i = 0; i < n; ++i) {
+    std::int64_t head = 0;
+    if (into_from[i] >= kNoPath || !CheckedAdd(into_from[i], c, head)) {
+      continue;
+    }
+    for (std::uint32_t j = 0; j < n; ++j) {
+      std::int64_t sum = 0;
+      if (out_of_to[j] >= kNoPath || !CheckedAdd(head, out_of_to[j], sum)) {
         continue;
       }
-      for (std::size_t j = 0; j < n; ++j) {
-        if (dist[k][j] >= INF) {
-          continue;
-        }
-        std::int64_t sum = 0;
-        if (!CheckedAdd(dist[i][k], dist[k][j], sum)) {
-          continue;
-        }
-        if (sum < dist[i][j]) {
-          dist[i][j] = sum;
+      if (sum < At(i, j)) {
+        if (!marks_.empty()) {
+          undo_.push_back({i, j, At(i, j)});
         }
+        At(i, j) = sum;
       }
     }
   }
+  return true;
+}
 
-  for (const auto& target : targets) {
-    const auto from = indices[target.y];
-    const auto to = indices[target.x];
-    if (dist[from][to] > target.c) {
-      return false;
-    }
+bool DiffConstraintSolver::Entails(std::string_view x,
+                                   std::string_view y,
+                                   std::int64_t c) const {
+  if (!consistent_) {
+    return false;
   }
-  return true;
+  if (x == y) {
+    return c >= 0;
+  }
+  const auto from = Find(y);
+  const auto to = Find(x);
+  if (!from.has_value() || !to.has_value()) {
+    return false;
+  }
+  return At(*from, *to) <= c;
 }
 
-}  // namespace
+void DiffConstraintSolver::Push() {
+  marks_.push_back({undo_.size(), terms_.size(), consistent_});
+}
 
-bool ExprStructEqual(const syntax::ExprPtr& a, const syntax::ExprPtr& b) {
-  return ExprStructEqualInternal(a, b);
+void DiffConstraintSolver::Pop() {
+  if (marks_.empty()) {
+    return;
+  }
+  const Mark mark = marks_.back();
+  marks_.pop_back();
+  while (undo_.size() > mark.undo) {
+    const Undo& entry = undo_.back();
+    At(entry.from, entry.to) = entry.old;
+    undo_.pop_back();
+  }
+  // Terms interned since the mark only have paths logged above, so their
+  // rows and columns are back to "no path" and can be reused.
+  while (terms_.size() > mark.terms) {
+    ids_.erase(terms_.back());
+    terms_.pop_back();
+  }
+  consistent_ = mark.consistent;
 }
 
 StaticProofResult StaticProof(
@@ -859,26 +936,25 @@ bool EntLinear(const StaticProofContext& ctx, const syntax::ExprPtr& expr) {
     return target.value;
   }
 
-  std::vector<DiffConstraint> facts;
+  // AddFact keeps ctx.linear closed over every fact. When the facts are in
+  // dominance order and the newest one dominates this location, all of them
+  // do and the closure answers the query directly.
+  if (ctx.facts.empty() ||
+      (ctx.facts_ordered && FactDominates(ctx.facts.back(), expr->span))) {
+    return EntailsConstraints(ctx.linear, target.constraints);
+  }
+
+  // Otherwise close over the dominating facts only; in dominance order they
+  // are a prefix.
+  DiffConstraintSolver solver;
   for (const auto& fact : ctx.facts) {
-    if (!FactDominates(fact, expr->span)) {
-      continue;
+    if (FactDominates(fact, expr->span)) {
+      AddLinearFact(solver, fact.predicate);
+    } else if (ctx.facts_ordered) {
+      break;
     }
-    const auto pred = BuildConstraintsFromPredicate(fact.predicate);
-    if (!pred.ok) {
-      continue;
-    }
-    if (pred.constant) {
-      if (!pred.value) {
-        // Inconsistent fact set; be conservative.
-        continue;
-      }
-      continue;
-    }
-    facts.insert(facts.end(), pred.constraints.begin(), pred.constraints.end());
   }
-
-  return EntailsConstraints(facts, target.constraints);
+  return EntailsConstraints(solver, target.constraints);
 }
 
 ConstValue EvaluateConstant(const syntax::ExprPtr& expr) {
@@ -1096,7 +1172,60 @@ void AddFact(StaticProofContext& ctx,
   fact.predicate = predicate;
   fact.location = location;
   fact.scope_id = ctx.current_scope;
+  if (!ctx.facts.empty() && !FactDominates(ctx.facts.back(), location)) {
+    ctx.facts_ordered = false;
+  }
   ctx.facts.push_back(fact);
+  AddLinearFact(ctx.linear, predicate);
+}
+
+void AddConjunctFacts(StaticProofContext& ctx, const syntax::ExprPtr& expr) {
+  if (!expr) {
+    return;
+  }
+  if (const auto* binary = std::get_if<syntax::BinaryExpr>(&expr->node)) {
+    if (binary->op == "&&") {
+      AddConjunctFacts(ctx, binary->lhs);
+      AddConjunctFacts(ctx, binary->rhs);
+      return;
+    }
+  }
+  AddFact(ctx, expr, expr->span);
+}
+
+void PushFactScope(StaticProofContext& ctx) {
+  ctx.scope_marks.push_back({ctx.facts.size(), ctx.facts_ordered});
+  ctx.linear.Push();
+  ++ctx.current_scope;
+}
+
+void PopFactScope(StaticProofContext& ctx) {
+  if (ctx.scope_marks.empty()) {
+    return;
+  }
+  ctx.facts.resize(ctx.scope_marks.back().facts);
+  ctx.facts_ordered = ctx.scope_marks.back().facts_ordered;
+  ctx.scope_marks.pop_back();
+  ctx.linear.Pop();
+  --ctx.current_scope;
+}
+
+namespace {
+
+thread_local StaticProofContext* current_proof_ctx = nullptr;
+
+}  // namespace
+
+ProofSession::ProofSession() : prev_(current_proof_ctx) {
+  current_proof_ctx = &ctx_;
+}
+
+ProofSession::~ProofSession() {
+  current_proof_ctx = prev_;
+}
+
+StaticProofContext* CurrentProofContext() {
+  return current_proof_ctx;
 }
 
 bool FactDominates(const VerificationFact& fact, const core::Span& location) {
@@ -15,8 +15,34 @@ static inline void SpecDefsKeyConflict() {
   SPEC_DEF("CanonicalOrder", "C0X.5.X");
 }
 
+KeyBlock::Keys SortedKeys(const KeyBlock::Keys& keys) {
+  auto sorted = keys;
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const auto& a, const auto& b) {
+                     return KeyPathLess(a.first, b.first);
+                   });
+  return sorted;
+}
+
 }  // namespace
 
+const KeyBlock::Keys& KeyBlock::canonical() const {
+  if (!canonical_.has_value()) {
+    canonical_ = SortedKeys(keys_);
+  }
+  return *canonical_;
+}
+
+const KeyPathTrie& KeyBlock::index() const {
+  if (!index_.has_value()) {
+    index_.emplace();
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+      index_->Insert(i, keys_[i].first, keys_[i].second);
+    }
+  }
+  return *index_;
+}
+
 bool KeysConflict(const KeyPath& p1, KeyAccessMode m1,
                   const KeyPath& p2, KeyAccessMode m2) {
   SpecDefsKeyConflict();
@@ -44,7 +70,11 @@ ConflictResult CheckAcquisitionConflict(const KeyContext& ctx,
   SPEC_RULE("K-CheckAcquisition");
   
   ConflictResult result;
+  if (!ctx.ConflictsWith(path, mode)) {
+    return result;
+  }
   
+  // Report the first conflicting key in acquisition order
   for (const auto& held : ctx.HeldKeys()) {
     if (KeysConflict(held.path, held.mode, path, mode)) {
       result.conflict = true;
@@ -59,17 +89,29 @@ ConflictResult CheckAcquisitionConflict(const KeyContext& ctx,
   return result;
 }
 
-ConflictResult CheckBlockConflict(
-    const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys1,
-    const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys2,
-    const core::Span& span) {
+ConflictResult CheckBlockConflict(const KeyBlock& block1,
+                                  const KeyBlock& block2,
+                                  const core::Span& span) {
   SpecDefsKeyConflict();
   SPEC_RULE("K-CheckBlockConflict");
   
   ConflictResult result;
   
-  for (const auto& [p1, m1] : keys1) {
-    for (const auto& [p2, m2] : keys2) {
+  // Query the larger block's index with the smaller block's keys
+  const bool swap = block2.keys().size() > block1.keys().size();
+  const KeyPathTrie& index = swap ? block2.index() : block1.index();
+  const auto& probes = swap ? block1.keys() : block2.keys();
+  const bool any = std::any_of(probes.begin(), probes.end(),
+                               [&](const auto& key) {
+                                 return index.Conflicts(key.first, key.second);
+                               });
+  if (!any) {
+    return result;
+  }
+  
+  // Report the first conflicting pair in block order
+  for (const auto& [p1, m1] : block1.keys()) {
+    for (const auto& [p2, m2] : block2.keys()) {
       if (KeysConflict(p1, m1, p2, m2)) {
         result.conflict = true;
         result.diag_id = "E-CON-0060";  // Parallel key conflict
@@ -84,12 +126,19 @@ ConflictResult CheckBlockConflict(
   return result;
 }
 
-OrderValidation ValidateAcquisitionOrder(
-    const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys) {
+ConflictResult CheckBlockConflict(
+    const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys1,
+    const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys2,
+    const core::Span& span) {
+  return CheckBlockConflict(KeyBlock(keys1), KeyBlock(keys2), span);
+}
+
+OrderValidation ValidateAcquisitionOrder(const KeyBlock& block) {
   SpecDefsKeyConflict();
   SPEC_RULE("K-ValidateOrder");
   
   OrderValidation result;
+  const auto& keys = block.keys();
   
   // Check if keys are in canonical (lexicographic) order
   for (std::size_t i = 1; i < keys.size(); ++i) {
@@ -101,12 +150,8 @@ OrderValidation ValidateAcquisitionOrder(
   }
   
   // Compute suggested order
-  result.suggested_order = {};
-  auto sorted = keys;
-  std::stable_sort(sorted.begin(), sorted.end(),
-                   [](const auto& a, const auto& b) {
-                     return KeyPathLess(a.first, b.first);
-                   });
+  const auto& sorted = result.ok ? keys : block.canonical();
+  result.suggested_order.reserve(sorted.size());
   for (const auto& [path, _] : sorted) {
     result.suggested_order.push_back(path);
   }
@@ -114,17 +159,17 @@ OrderValidation ValidateAcquisitionOrder(
   return result;
 }
 
+OrderValidation ValidateAcquisitionOrder(
+    const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys) {
+  return ValidateAcquisitionOrder(KeyBlock(keys));
+}
+
 std::vector<std::pair<KeyPath, KeyAccessMode>> CanonicalOrder(
     const std::vector<std::pair<KeyPath, KeyAccessMode>>& keys) {
   SpecDefsKeyConflict();
   SPEC_RULE("K-CanonicalOrder");
   
-  auto sorted = keys;
-  std::stable_sort(sorted.begin(), sorted.end(),
-                   [](const auto& a, const auto& b) {
-                     return KeyPathLess(a.first, b.first);
-                   });
-  return sorted;
+  return SortedKeys(keys);
 }
 
 bool StaticallyDisjoint(const syntax::ExprPtr& idx1, const syntax::ExprPtr& idx2) {
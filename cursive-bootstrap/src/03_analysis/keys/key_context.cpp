@@ -17,8 +17,183 @@ static inline void SpecDefsKeyContext() {
   SPEC_DEF("Acquire", "C0X.5.X");
 }
 
+// Segments IsPrefix compares: those before the first boundary marker
+std::size_t AnchorDepth(const KeyPath& path) {
+  for (std::size_t i = 0; i < path.segs.size(); ++i) {
+    if (path.segs[i].boundary) {
+      return i;
+    }
+  }
+  return path.segs.size();
+}
+
+bool ModeConflicts(KeyAccessMode m1, KeyAccessMode m2) {
+  return m1 == KeyAccessMode::Write || m2 == KeyAccessMode::Write;
+}
+
 }  // namespace
 
+KeyPathTrie::KeyPathTrie() {
+  nodes_.emplace_back();
+}
+
+std::uint64_t KeyPathTrie::Intern(const std::string& name, bool is_index) {
+  const auto [it, inserted] = names_.emplace(name, names_.size());
+  return (it->second << 1) | (is_index ? 1u : 0u);
+}
+
+std::optional<std::uint64_t> KeyPathTrie::Lookup(const std::string& name,
+                                                 bool is_index) const {
+  const auto it = names_.find(name);
+  if (it == names_.end()) {
+    return std::nullopt;
+  }
+  return (it->second << 1) | (is_index ? 1u : 0u);
+}
+
+std::uint32_t KeyPathTrie::ChildOrCreate(std::uint32_t node,
+                                         std::uint64_t key,
+                                         KeyAccessMode mode) {
+  std::uint32_t child = 0;
+  const auto it = nodes_[node].children.find(key);
+  if (it != nodes_[node].children.end()) {
+    child = it->second;
+  } else {
+    child = static_cast<std::uint32_t>(nodes_.size());
+    Node fresh;
+    // nodes_[0] sits above the roots, which are at depth 0.
+    fresh.depth = node == 0 ? 0 : nodes_[node].depth + 1;
+    nodes_.push_back(std::move(fresh));
+    nodes_[node].children.emplace(key, child);
+  }
+  if (mode == KeyAccessMode::Write) {
+    ++nodes_[child].writes;
+  } else {
+    ++nodes_[child].reads;
+  }
+  return child;
+}
+
+std::vector<std::uint32_t> KeyPathTrie::PathNodes(const KeyPath& path) const {
+  std::vector<std::uint32_t> out;
+  out.reserve(path.segs.size() + 1);
+  std::uint32_t node = 0;
+  auto step = [&](const std::optional<std::uint64_t>& key) {
+    if (!key.has_value()) {
+      return false;
+    }
+    const auto it = nodes_[node].children.find(*key);
+    if (it == nodes_[node].children.end()) {
+      return false;
+    }
+    node = it->second;
+    out.push_back(node);
+    return true;
+  };
+  if (!step(Lookup(path.root, false))) {
+    return out;
+  }
+  for (const auto& seg : path.segs) {
+    if (!step(Lookup(seg.name, seg.is_index))) {
+      break;
+    }
+  }
+  return out;
+}
+
+void KeyPathTrie::Insert(KeyId id, const KeyPath& path, KeyAccessMode mode) {
+  if (mode == KeyAccessMode::Write) {
+    ++nodes_[0].writes;
+  } else {
+    ++nodes_[0].reads;
+  }
+  const std::size_t anchor = AnchorDepth(path);
+  std::uint32_t node = ChildOrCreate(0, Intern(path.root, false), mode);
+  for (std::size_t i = 0;; ++i) {
+    if (i == anchor) {
+      nodes_[node].anchors.push_back(Anchor{id, mode, path.segs.size()});
+    }
+    if (i == path.segs.size()) {
+      break;
+    }
+    const auto& seg = path.segs[i];
+    node = ChildOrCreate(node, Intern(seg.name, seg.is_index), mode);
+  }
+}
+
+void KeyPathTrie::Erase(KeyId id, const KeyPath& path, KeyAccessMode mode) {
+  const auto nodes = PathNodes(path);
+  if (nodes.size() != path.segs.size() + 1) {
+    return;  // never inserted
+  }
+  auto drop = [mode](Node& node) {
+    if (mode == KeyAccessMode::Write) {
+      --node.writes;
+    } else {
+      --node.reads;
+    }
+  };
+  drop(nodes_[0]);
+  for (const auto node : nodes) {
+    drop(nodes_[node]);
+  }
+  auto& anchors = nodes_[nodes[AnchorDepth(path)]].anchors;
+  anchors.erase(std::remove_if(anchors.begin(), anchors.end(),
+                               [id](const Anchor& a) { return a.id == id; }),
+                anchors.end());
+}
+
+bool KeyPathTrie::Covers(const KeyPath& path, KeyAccessMode mode) const {
+  for (const auto node : PathNodes(path)) {
+    for (const auto& anchor : nodes_[node].anchors) {
+      if (anchor.length <= path.segs.size() &&
+          (anchor.mode == KeyAccessMode::Write || mode == KeyAccessMode::Read)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool KeyPathTrie::SubtreeConflicts(std::uint32_t node,
+                                   std::size_t min_depth,
+                                   KeyAccessMode mode) const {
+  const Node& n = nodes_[node];
+  const std::size_t relevant =
+      mode == KeyAccessMode::Write ? n.reads + n.writes : n.writes;
+  if (relevant == 0) {
+    return false;
+  }
+  // Every key counted here is at least this long.
+  if (n.depth >= min_depth) {
+    return true;
+  }
+  for (const auto& [key, child] : n.children) {
+    if (SubtreeConflicts(child, min_depth, mode)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool KeyPathTrie::Conflicts(const KeyPath& path, KeyAccessMode mode) const {
+  const auto nodes = PathNodes(path);
+  // Held keys that are a prefix of `path`
+  for (const auto node : nodes) {
+    for (const auto& anchor : nodes_[node].anchors) {
+      if (anchor.length <= path.segs.size() && ModeConflicts(anchor.mode, mode)) {
+        return true;
+      }
+    }
+  }
+  // Held keys that `path` is a prefix of
+  const std::size_t anchor = AnchorDepth(path);
+  if (anchor >= nodes.size()) {
+    return false;
+  }
+  return SubtreeConflicts(nodes[anchor], path.segs.size(), mode);
+}
+
 std::string KeyPath::ToString() const {
   std::ostringstream oss;
   oss << root;
@@ -69,6 +244,8 @@ bool KeyContext::Acquire(const KeyPath& path, KeyAccessMode mode) {
   key.path = path;
   key.mode = mode;
   key.scope = current_scope_;
+  key.id = next_key_id_++;
+  index_.Insert(key.id, key.path, key.mode);
   held_keys_.push_back(std::move(key));
   return true;
 }
@@ -78,6 +255,11 @@ void KeyContext::ReleaseScope() {
   SPEC_RULE("K-Release-Scope");
   
   // Remove all keys at current scope
+  for (const auto& key : held_keys_) {
+    if (key.scope == current_scope_) {
+      index_.Erase(key.id, key.path, key.mode);
+    }
+  }
   held_keys_.erase(
       std::remove_if(held_keys_.begin(), held_keys_.end(),
                      [this](const HeldKey& k) {
@@ -90,20 +272,10 @@ bool KeyContext::Covers(const KeyPath& path, KeyAccessMode mode) const {
   SpecDefsKeyContext();
   SPEC_RULE("K-Covers");
   
-  for (const auto& held : held_keys_) {
-    // A held key covers the path if:
-    // 1. The held path is a prefix of the requested path
-    // 2. The held mode is >= the requested mode (Write covers both, Read covers Read)
-    if (IsPrefix(held.path, path)) {
-      if (held.mode == KeyAccessMode::Write) {
-        return true;  // Write covers everything
-      }
-      if (mode == KeyAccessMode::Read) {
-        return true;  // Read covers Read
-      }
-    }
-  }
-  return false;
+  // A held key covers the path if:
+  // 1. The held path is a prefix of the requested path
+  // 2. The held mode is >= the requested mode (Write covers both, Read covers Read)
+  return index_.Covers(path, mode);
 }
 
 KeyPath LowerKeyPath(const syntax::KeyPathExpr& ast_path) {
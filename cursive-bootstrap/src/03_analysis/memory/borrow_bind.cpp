@@ -1866,8 +1866,7 @@ static BindResult BindMatchExpr(const ScopeContext& ctx,
         arm_state.binds, BindInfoMap(type_map, resp, Movability::Mov,
                                      syntax::Mutability::Let));
     for (const auto& [name, type] : pat.bindings) {
-      arm_state.env.scopes.back()[IdKeyOf(name)] =
-          TypeBinding{syntax::Mutability::Let, type};
+      arm_state.env.Bind(IdKeyOf(name), TypeBinding{syntax::Mutability::Let, type});
     }
 
     if (arm.guard_opt) {
@@ -2023,8 +2022,7 @@ static BindResult BindLoopIter(const ScopeContext& ctx,
         scoped.binds, BindInfoMap(type_map, Responsibility::Resp,
                                   Movability::Mov, syntax::Mutability::Let));
     for (const auto& [name, type] : pat.bindings) {
-      scoped.env.scopes.back()[IdKeyOf(name)] =
-          TypeBinding{syntax::Mutability::Let, type};
+      scoped.env.Bind(IdKeyOf(name), TypeBinding{syntax::Mutability::Let, type});
     }
 
     const auto body = BindBlock(ctx, *loop.body, scoped);
@@ -2170,10 +2168,7 @@ static BindResult BindStmt(const ScopeContext& ctx,
           current.binds = IntroAll_B(
               current.binds, BindInfoMap(type_map, resp, mv, mut));
           for (const auto& [name, type] : pat.bindings) {
-            if (current.env.scopes.empty()) {
-              current.env.scopes.emplace_back();
-            }
-            current.env.scopes.back()[IdKeyOf(name)] = TypeBinding{mut, type};
+            current.env.Bind(IdKeyOf(name), TypeBinding{mut, type});
           }
           SPEC_RULE("B-LetVar");
           return OkResult(current);
@@ -2209,13 +2204,8 @@ static BindResult BindStmt(const ScopeContext& ctx,
           current.binds = *updated;
 
           const auto key = IdKeyOf(node.name);
-          for (auto it = current.env.scopes.rbegin(); it != current.env.scopes.rend(); ++it) {
-            const auto found = it->find(key);
-            if (found != it->end()) {
-              found->second = TypeBinding{syntax::Mutability::Let, *bind_type};
-              break;
-            }
-          }
+          current.env.Rebind(key,
+                             TypeBinding{syntax::Mutability::Let, *bind_type});
           SPEC_RULE("B-ShadowLet");
           return OkResult(current);
         } else if constexpr (std::is_same_v<T, syntax::ShadowVarStmt>) {
@@ -2250,13 +2240,8 @@ static BindResult BindStmt(const ScopeContext& ctx,
           current.binds = *updated;
 
           const auto key = IdKeyOf(node.name);
-          for (auto it = current.env.scopes.rbegin(); it != current.env.scopes.rend(); ++it) {
-            const auto found = it->find(key);
-            if (found != it->end()) {
-              found->second = TypeBinding{syntax::Mutability::Var, *bind_type};
-              break;
-            }
-          }
+          current.env.Rebind(key,
+                             TypeBinding{syntax::Mutability::Var, *bind_type});
           SPEC_RULE("B-ShadowVar");
           return OkResult(current);
         } else if constexpr (std::is_same_v<T, syntax::AssignStmt> ||
@@ -2389,8 +2374,7 @@ static BindResult BindStmt(const ScopeContext& ctx,
               scoped.binds,
               BindInfoMap(type_map, Responsibility::Resp, Movability::Mov,
                           syntax::Mutability::Let));
-          scoped.env.scopes.back()[IdKeyOf(name)] =
-              TypeBinding{syntax::Mutability::Let, region_type};
+          scoped.env.Bind(IdKeyOf(name), TypeBinding{syntax::Mutability::Let, region_type});
 
           const auto body = BindBlock(ctx, *node.body, scoped);
           if (!body.ok) {
@@ -2419,8 +2403,7 @@ static BindResult BindStmt(const ScopeContext& ctx,
               scoped.binds,
               BindInfoMap(type_map, Responsibility::Resp, Movability::Mov,
                           syntax::Mutability::Let));
-          scoped.env.scopes.back()[IdKeyOf(name)] =
-              TypeBinding{syntax::Mutability::Let, region_type};
+          scoped.env.Bind(IdKeyOf(name), TypeBinding{syntax::Mutability::Let, region_type});
 
           const auto body = BindBlock(ctx, *node.body, scoped);
           if (!body.ok) {
@@ -2490,10 +2473,7 @@ static BindScope StaticBindInfo(const ScopeContext& ctx,
     return out;
   }
   for (const auto& [name, type] : pat.bindings) {
-    if (env.scopes.empty()) {
-      env.scopes.emplace_back();
-    }
-    env.scopes.front()[IdKeyOf(name)] = TypeBinding{decl.mut, type};
+    env.Bind(IdKeyOf(name), TypeBinding{decl.mut, type});
   }
   const auto type_map = BindTypeMapFromBindings(pat.bindings);
   const auto resp = RespOfInit(decl.binding.init);
@@ -2553,11 +2533,8 @@ static void ParamTypeMap(const ScopeContext& ctx,
   TypeRef self_base;
   if (self_param.has_value()) {
     self_base = StripPerm(self_param->type);
-    if (env.scopes.empty()) {
-      env.scopes.emplace_back();
-    }
-    env.scopes.back()[IdKeyOf("self")] =
-        TypeBinding{syntax::Mutability::Let, self_param->type};
+    env.Bind(IdKeyOf("self"),
+             TypeBinding{syntax::Mutability::Let, self_param->type});
   }
   for (const auto& param : params) {
     const auto lowered = LocalLowerType(ctx, param.type);
@@ -2568,11 +2545,7 @@ static void ParamTypeMap(const ScopeContext& ctx,
     if (self_base) {
       type = SubstSelfType(self_base, type);
     }
-    if (env.scopes.empty()) {
-      env.scopes.emplace_back();
-    }
-    env.scopes.back()[IdKeyOf(param.name)] =
-        TypeBinding{syntax::Mutability::Let, type};
+    env.Bind(IdKeyOf(param.name), TypeBinding{syntax::Mutability::Let, type});
   }
 }
 
@@ -2595,7 +2568,7 @@ BindCheckResult BindCheckBody(const ScopeContext& ctx,
   PermEnv perms;
   TypeEnv env;
 
-  env.scopes.emplace_back();
+  env.PushScope();
   const auto static_info = StaticBindMap(ctx, module_path, env);
   binds = PushScope_B(binds);
   binds = IntroAll_B(binds, static_info);
@@ -2603,7 +2576,7 @@ BindCheckResult BindCheckBody(const ScopeContext& ctx,
   perms.emplace_back();
   perms.emplace_back();
 
-  env.scopes.emplace_back();
+  env.PushScope();
   const auto param_info = ParamBindMap(params, self_param);
   binds = PushScope_B(binds);
   binds = IntroAll_B(binds, param_info);
@@ -2,12 +2,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <map>
 #include <optional>
 #include <queue>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -98,7 +100,8 @@ struct InitEnv {
   syntax::ModulePath self;
   std::size_t self_index = 0;
   const std::vector<syntax::ModulePath>* modules = nullptr;
-  const std::map<std::string, std::size_t>* module_index = nullptr;
+  const std::unordered_map<std::string, std::size_t>* module_index = nullptr;
+  const NameMap* names = nullptr;
   AliasMap alias;
   UsingMap using_value;
   UsingMap using_type;
@@ -1190,22 +1193,52 @@ void CollectPatNodesFromExpr(const syntax::ExprPtr& expr,
       expr->node);
 }
 
-struct EdgeSets {
-  std::vector<std::set<std::size_t>> type_edges;
-  std::vector<std::set<std::size_t>> eager_edges;
-  std::vector<std::set<std::size_t>> lazy_edges;
+using EdgeList = std::vector<std::pair<std::size_t, std::size_t>>;
+
+struct EdgeLists {
+  EdgeList type_edges;
+  EdgeList eager_edges;
+  EdgeList lazy_edges;
 };
 
-void AddEdges(std::vector<std::set<std::size_t>>& edges,
+// Edges dep -> from: `dep` is initialized before `from`.
+void AddEdges(EdgeList& edges,
+              std::size_t module_count,
               std::size_t from,
               const ModuleSet& deps) {
   for (const auto dep : deps) {
-    if (dep < edges.size()) {
-      edges[dep].insert(from);
+    if (dep < module_count) {
+      edges.emplace_back(dep, from);
     }
   }
 }
 
+// Compressed adjacency: the successors of u are
+// targets[offsets[u]] .. targets[offsets[u + 1] - 1], in ascending order.
+struct InitAdjacency {
+  std::vector<std::size_t> offsets;
+  std::vector<std::size_t> targets;
+
+  std::size_t Size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+// Sorts and deduplicates `edges` in place and builds their adjacency.
+InitAdjacency BuildAdjacency(std::size_t module_count, EdgeList& edges) {
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  InitAdjacency adj;
+  adj.offsets.assign(module_count + 1, 0);
+  adj.targets.reserve(edges.size());
+  for (const auto& [u, v] : edges) {
+    ++adj.offsets[u + 1];
+    adj.targets.push_back(v);
+  }
+  for (std::size_t u = 0; u < module_count; ++u) {
+    adj.offsets[u + 1] += adj.offsets[u];
+  }
+  return adj;
+}
+
 ModuleSet TypeRefsFromPathList(const std::vector<syntax::ClassPath>& paths,
                                const InitEnv& env) {
   ModuleSet out;
@@ -1697,6 +1730,251 @@ ModuleSet TypeDepsForModule(const syntax::ASTModule& module,
   return deps;
 }
 
+// ---------------------------------------------------------------------------
+// Initializers that cannot panic
+//
+// A module's poison flag is only ever set when the initializer of that
+// module, or of a module it eagerly depends on, panics. Static
+// initializers built only from literals and aggregates of them, stored at
+// types with no refinement or invariant to check, cannot panic.
+// ---------------------------------------------------------------------------
+
+constexpr std::size_t kMaxPlainTypeDepth = 8;
+
+struct FoundTypeDecl {
+  const TypeDecl* decl = nullptr;
+  bool local = false;  // declared in env.self
+};
+
+FoundTypeDecl LookupTypeDecl(const syntax::TypePath& path,
+                             const InitEnv& env,
+                             const Sigma& sigma) {
+  if (path.empty()) {
+    return {};
+  }
+  syntax::ModulePath full;
+  if (path.size() == 1) {
+    const auto key = IdKeyOf(path[0]);
+    if (env.names) {
+      const auto it = env.names->find(key);
+      if (it != env.names->end() && it->second.kind == EntityKind::Type &&
+          it->second.origin_opt.has_value()) {
+        full = *it->second.origin_opt;
+        full.push_back(it->second.target_opt.value_or(path[0]));
+      }
+    }
+    if (full.empty()) {
+      full = env.self;
+      full.push_back(path[0]);
+    }
+  } else {
+    full = AliasExpand(path, env.alias);
+  }
+  const auto it = sigma.types.find(PathKeyOf(full));
+  if (it == sigma.types.end()) {
+    return {};
+  }
+  full.pop_back();
+  return {&it->second, PathEq(full, env.self)};
+}
+
+bool PlainType(const std::shared_ptr<syntax::Type>& type,
+               const InitEnv& env,
+               const Sigma& sigma,
+               bool resolve_paths,
+               std::size_t depth);
+
+// Field defaults are arbitrary expressions, so fields with one are refused.
+bool PlainField(const syntax::FieldDecl& field,
+                const InitEnv& env,
+                const Sigma& sigma,
+                bool resolve_paths,
+                std::size_t depth) {
+  return !field.init_opt &&
+         PlainType(field.type, env, sigma, resolve_paths, depth);
+}
+
+// Values of the declared type are built without any runtime check. Paths
+// inside a type declared in another module would need that module's names,
+// so they are only followed one level out of env.self.
+bool PlainTypeDecl(const FoundTypeDecl& found,
+                   const InitEnv& env,
+                   const Sigma& sigma,
+                   std::size_t depth) {
+  if (!found.decl) {
+    return false;
+  }
+  const bool resolve_paths = found.local;
+  if (const auto* record = std::get_if<syntax::RecordDecl>(found.decl)) {
+    if (record->generic_params.has_value() || record->invariant.has_value()) {
+      return false;
+    }
+    for (const auto& member : record->members) {
+      const auto* field = std::get_if<syntax::FieldDecl>(&member);
+      if (field && !PlainField(*field, env, sigma, resolve_paths, depth)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (const auto* enum_decl = std::get_if<syntax::EnumDecl>(found.decl)) {
+    if (enum_decl->generic_params.has_value() ||
+        enum_decl->invariant.has_value()) {
+      return false;
+    }
+    for (const auto& variant : enum_decl->variants) {
+      if (!variant.payload_opt.has_value()) {
+        continue;
+      }
+      if (const auto* tuple =
+              std::get_if<syntax::VariantPayloadTuple>(&*variant.payload_opt)) {
+        for (const auto& elem : tuple->elements) {
+          if (!PlainType(elem, env, sigma, resolve_paths, depth)) {
+            return false;
+          }
+        }
+      } else {
+        const auto& fields =
+            std::get<syntax::VariantPayloadRecord>(*variant.payload_opt).fields;
+        for (const auto& field : fields) {
+          if (!PlainField(field, env, sigma, resolve_paths, depth)) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+bool PlainType(const std::shared_ptr<syntax::Type>& type,
+               const InitEnv& env,
+               const Sigma& sigma,
+               bool resolve_paths,
+               std::size_t depth) {
+  if (!type || depth > kMaxPlainTypeDepth) {
+    return false;
+  }
+  return std::visit(
+      [&](const auto& node) -> bool {
+        using T = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<T, syntax::TypePrim> ||
+                      std::is_same_v<T, syntax::TypeString> ||
+                      std::is_same_v<T, syntax::TypeBytes>) {
+          return true;
+        } else if constexpr (std::is_same_v<T, syntax::TypePermType>) {
+          return PlainType(node.base, env, sigma, resolve_paths, depth);
+        } else if constexpr (std::is_same_v<T, syntax::TypeTuple>) {
+          for (const auto& elem : node.elements) {
+            if (!PlainType(elem, env, sigma, resolve_paths, depth)) {
+              return false;
+            }
+          }
+          return true;
+        } else if constexpr (std::is_same_v<T, syntax::TypeArray>) {
+          return PlainType(node.element, env, sigma, resolve_paths, depth);
+        } else if constexpr (std::is_same_v<T, syntax::TypePathType>) {
+          if (!resolve_paths || !node.generic_args.empty()) {
+            return false;
+          }
+          return PlainTypeDecl(LookupTypeDecl(node.path, env, sigma), env,
+                               sigma, depth + 1);
+        } else {
+          return false;
+        }
+      },
+      type->node);
+}
+
+bool LiteralOperand(const syntax::ExprPtr& expr) {
+  return expr && std::holds_alternative<syntax::LiteralExpr>(expr->node);
+}
+
+bool InfallibleExpr(const syntax::ExprPtr& expr,
+                    const InitEnv& env,
+                    const Sigma& sigma) {
+  if (!expr) {
+    return false;
+  }
+  const auto all = [&](const std::vector<syntax::ExprPtr>& exprs) {
+    return std::all_of(exprs.begin(), exprs.end(),
+                       [&](const syntax::ExprPtr& elem) {
+                         return InfallibleExpr(elem, env, sigma);
+                       });
+  };
+  const auto all_fields = [&](const std::vector<syntax::FieldInit>& fields) {
+    return std::all_of(fields.begin(), fields.end(),
+                       [&](const syntax::FieldInit& field) {
+                         return InfallibleExpr(field.value, env, sigma);
+                       });
+  };
+  return std::visit(
+      [&](const auto& node) -> bool {
+        using T = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<T, syntax::LiteralExpr>) {
+          return true;
+        } else if constexpr (std::is_same_v<T, syntax::UnaryExpr>) {
+          // In-range literals negate without overflow.
+          return (node.op == "-" || node.op == "!") &&
+                 LiteralOperand(node.value);
+        } else if constexpr (std::is_same_v<T, syntax::TupleExpr> ||
+                             std::is_same_v<T, syntax::ArrayExpr>) {
+          return all(node.elements);
+        } else if constexpr (std::is_same_v<T, syntax::ArrayRepeatExpr>) {
+          return InfallibleExpr(node.value, env, sigma) &&
+                 LiteralOperand(node.count);
+        } else if constexpr (std::is_same_v<T, syntax::RecordExpr>) {
+          const auto* path = std::get_if<syntax::TypePath>(&node.target);
+          return path &&
+                 PlainTypeDecl(LookupTypeDecl(*path, env, sigma), env, sigma,
+                               0) &&
+                 all_fields(node.fields);
+        } else if constexpr (std::is_same_v<T, syntax::EnumLiteralExpr>) {
+          if (node.path.size() < 2) {
+            return false;
+          }
+          const syntax::TypePath enum_path(node.path.begin(),
+                                           node.path.end() - 1);
+          if (!PlainTypeDecl(LookupTypeDecl(enum_path, env, sigma), env,
+                             sigma, 0)) {
+            return false;
+          }
+          if (!node.payload_opt.has_value()) {
+            return true;
+          }
+          if (const auto* paren =
+                  std::get_if<syntax::EnumPayloadParen>(&*node.payload_opt)) {
+            return all(paren->elements);
+          }
+          return all_fields(
+              std::get<syntax::EnumPayloadBrace>(*node.payload_opt).fields);
+        } else {
+          return false;
+        }
+      },
+      expr->node);
+}
+
+bool InitCannotPanic(const syntax::ASTModule& module,
+                     const InitEnv& env,
+                     const Sigma& sigma) {
+  for (const auto& item : module.items) {
+    const auto* decl = std::get_if<syntax::StaticDecl>(&item);
+    if (!decl) {
+      continue;
+    }
+    const auto& binding = decl->binding;
+    if (binding.type_opt && !PlainType(binding.type_opt, env, sigma, true, 0)) {
+      return false;
+    }
+    if (!InfallibleExpr(binding.init, env, sigma)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 ModuleSet ValueDepsEagerForModule(const syntax::ASTModule& module,
                                   const InitEnv& env) {
   ModuleSet deps;
@@ -1774,76 +2052,112 @@ ModuleSet ValueDepsLazyForModule(const syntax::ASTModule& module,
   return deps;
 }
 
-bool Reachable(std::size_t u,
-               std::size_t v,
-               const std::vector<std::set<std::size_t>>& edges,
-               std::vector<bool>& visiting) {
+// Strongly connected components that contain a cycle (more than one
+// module, or a module with an edge to itself), found with Tarjan's
+// algorithm in one O(V + E) pass. Iterative, so long dependency chains do
+// not recurse. Members of each component are listed in ascending order.
+std::vector<std::vector<std::size_t>> CyclicComponents(
+    const InitAdjacency& adj) {
   SpecDefsInitPlanner();
-  if (edges[u].count(v) > 0) {
-    SPEC_RULE("Reachable-Edge");
-    return true;
-  }
-  for (const auto w : edges[u]) {
-    if (visiting[w]) {
+  constexpr std::size_t kUnvisited = static_cast<std::size_t>(-1);
+  const std::size_t n = adj.Size();
+  std::vector<std::size_t> index(n, kUnvisited);
+  std::vector<std::size_t> low(n, 0);
+  std::vector<bool> on_stack(n, false);
+  std::vector<std::size_t> stack;
+  // (vertex, next successor slot) frames of the simulated recursion.
+  std::vector<std::pair<std::size_t, std::size_t>> frames;
+  std::vector<std::vector<std::size_t>> cyclic;
+  std::size_t next_index = 0;
+
+  for (std::size_t root = 0; root < n; ++root) {
+    if (index[root] != kUnvisited) {
       continue;
     }
-    visiting[w] = true;
-    if (Reachable(w, v, edges, visiting)) {
-      SPEC_RULE("Reachable-Step");
-      return true;
+    frames.emplace_back(root, adj.offsets[root]);
+    index[root] = low[root] = next_index++;
+    stack.push_back(root);
+    on_stack[root] = true;
+    while (!frames.empty()) {
+      auto& [u, slot] = frames.back();
+      if (slot < adj.offsets[u + 1]) {
+        const std::size_t w = adj.targets[slot++];
+        if (index[w] == kUnvisited) {
+          index[w] = low[w] = next_index++;
+          stack.push_back(w);
+          on_stack[w] = true;
+          frames.emplace_back(w, adj.offsets[w]);
+        } else if (on_stack[w]) {
+          low[u] = std::min(low[u], index[w]);
+        }
+        continue;
+      }
+      const std::size_t done = u;
+      frames.pop_back();
+      if (!frames.empty()) {
+        const std::size_t parent = frames.back().first;
+        low[parent] = std::min(low[parent], low[done]);
+      }
+      if (low[done] != index[done]) {
+        continue;
+      }
+      std::vector<std::size_t> component;
+      std::size_t w = 0;
+      do {
+        w = stack.back();
+        stack.pop_back();
+        on_stack[w] = false;
+        component.push_back(w);
+      } while (w != done);
+      if (component.size() > 1) {
+        SPEC_RULE("Reachable-Step");
+      } else {
+        const auto first = adj.targets.begin() + adj.offsets[done];
+        const auto last = adj.targets.begin() + adj.offsets[done + 1];
+        if (!std::binary_search(first, last, done)) {
+          continue;
+        }
+        SPEC_RULE("Reachable-Edge");
+      }
+      std::sort(component.begin(), component.end());
+      cyclic.push_back(std::move(component));
     }
   }
-  return false;
-}
-
-bool AcyclicEager(const std::vector<std::set<std::size_t>>& edges) {
-  SpecDefsInitPlanner();
-  const std::size_t n = edges.size();
-  for (std::size_t v = 0; v < n; ++v) {
-    std::vector<bool> visiting(n, false);
-    visiting[v] = true;
-    if (Reachable(v, v, edges, visiting)) {
-      return false;
-    }
+  std::sort(cyclic.begin(), cyclic.end());
+  if (cyclic.empty()) {
+    SPEC_RULE("WF-Acyclic-Eager");
   }
-  SPEC_RULE("WF-Acyclic-Eager");
-  return true;
+  return cyclic;
 }
 
-std::vector<std::size_t> TopoOrder(
-    const std::vector<std::set<std::size_t>>& edges,
-    bool& ok) {
+// Kahn's algorithm; among ready modules the lowest index goes first, so the
+// order follows module declaration order wherever dependencies allow.
+std::vector<std::size_t> TopoOrder(const InitAdjacency& adj, bool& ok) {
   SpecDefsInitPlanner();
   std::vector<std::size_t> order;
-  const std::size_t n = edges.size();
+  const std::size_t n = adj.Size();
+  order.reserve(n);
   std::vector<std::size_t> indeg(n, 0);
-  for (std::size_t u = 0; u < n; ++u) {
-    for (const auto v : edges[u]) {
-      if (v < n) {
-        indeg[v] += 1;
-      }
-    }
+  for (const auto v : adj.targets) {
+    indeg[v] += 1;
   }
-  std::set<std::size_t> ready;
+  std::priority_queue<std::size_t, std::vector<std::size_t>,
+                      std::greater<std::size_t>>
+      ready;
   for (std::size_t i = 0; i < n; ++i) {
     if (indeg[i] == 0) {
-      ready.insert(i);
+      ready.push(i);
     }
   }
   while (!ready.empty()) {
-    const std::size_t u = *ready.begin();
-    ready.erase(ready.begin());
+    const std::size_t u = ready.top();
+    ready.pop();
     order.push_back(u);
-    for (const auto v : edges[u]) {
-      if (v >= n) {
-        continue;
-      }
-      if (indeg[v] == 0) {
-        continue;
-      }
+    for (std::size_t e = adj.offsets[u]; e < adj.offsets[u + 1]; ++e) {
+      const std::size_t v = adj.targets[e];
       indeg[v] -= 1;
       if (indeg[v] == 0) {
-        ready.insert(v);
+        ready.push(v);
       }
     }
   }
@@ -1856,23 +2170,56 @@ std::vector<std::size_t> TopoOrder(
   return order;
 }
 
-std::vector<std::pair<std::size_t, std::size_t>> FlattenEdges(
-    const std::vector<std::set<std::size_t>>& edges) {
-  std::vector<std::pair<std::size_t, std::size_t>> out;
-  for (std::size_t u = 0; u < edges.size(); ++u) {
-    for (const auto v : edges[u]) {
-      out.emplace_back(u, v);
+// A panic in module u's initializer poisons u and every module reachable
+// from it along eager edges; the rest are never poisoned.
+std::vector<bool> PoisonFree(const InitAdjacency& adj,
+                             const std::vector<bool>& init_may_panic) {
+  const std::size_t n = adj.Size();
+  std::vector<bool> poisoned(n, false);
+  std::vector<std::size_t> stack;
+  for (std::size_t u = 0; u < n; ++u) {
+    if (init_may_panic[u] && !poisoned[u]) {
+      poisoned[u] = true;
+      stack.push_back(u);
     }
   }
+  while (!stack.empty()) {
+    const std::size_t u = stack.back();
+    stack.pop_back();
+    for (std::size_t e = adj.offsets[u]; e < adj.offsets[u + 1]; ++e) {
+      const std::size_t v = adj.targets[e];
+      if (!poisoned[v]) {
+        poisoned[v] = true;
+        stack.push_back(v);
+      }
+    }
+  }
+  std::vector<bool> out(n);
+  for (std::size_t u = 0; u < n; ++u) {
+    out[u] = !poisoned[u];
+  }
   return out;
 }
 
-void EmitInitDiag(core::DiagnosticStream& diags, std::string_view diag_id) {
+void EmitInitDiag(core::DiagnosticStream& diags,
+                  std::string_view diag_id,
+                  const std::vector<syntax::ModulePath>& modules,
+                  const std::vector<std::size_t>& cycle) {
   if (diag_id != "Topo-Cycle") {
     return;
   }
   if (auto diag = core::MakeDiagnostic("E-MOD-1401")) {
     diag->span.reset();
+    if (!cycle.empty()) {
+      diag->message += " (";
+      for (std::size_t i = 0; i < cycle.size(); ++i) {
+        if (i > 0) {
+          diag->message += ", ";
+        }
+        diag->message += ModuleKey(modules[cycle[i]]);
+      }
+      diag->message += ")";
+    }
     diags = core::Emit(diags, *diag);
   }
 }
@@ -1885,7 +2232,7 @@ InitPlanResult BuildInitPlan(const ScopeContext& ctx,
   InitPlanResult result;
 
   std::vector<syntax::ModulePath> modules;
-  std::map<std::string, std::size_t> module_index;
+  std::unordered_map<std::string, std::size_t> module_index;
   auto add_module = [&](const syntax::ModulePath& path) {
     const std::string key = ModuleKey(path);
     if (module_index.find(key) != module_index.end()) {
@@ -1907,23 +2254,21 @@ InitPlanResult BuildInitPlan(const ScopeContext& ctx,
     add_module(mod.path);
   }
 
-  EdgeSets edges;
-  edges.type_edges.resize(modules.size());
-  edges.eager_edges.resize(modules.size());
-  edges.lazy_edges.resize(modules.size());
+  EdgeLists edges;
+  const std::size_t module_count = modules.size();
+  std::vector<bool> init_may_panic(module_count, false);
 
   for (const auto& mod : ctx.sigma.mods) {
     const auto key = PathKeyOf(mod.path);
     const auto it = name_maps.find(key);
-    NameMap names;
-    if (it != name_maps.end()) {
-      names = it->second;
-    }
+    static const NameMap kNoNames;
+    const NameMap& names = it != name_maps.end() ? it->second : kNoNames;
 
     InitEnv env;
     env.self = mod.path;
     env.modules = &modules;
     env.module_index = &module_index;
+    env.names = &names;
     env.alias = AliasMapOf(names);
     env.using_value = BuildUsingValueMap(names);
     env.using_type = BuildUsingTypeMap(names);
@@ -1937,21 +2282,36 @@ InitPlanResult BuildInitPlan(const ScopeContext& ctx,
     const ModuleSet eager_deps = ValueDepsEagerForModule(mod, env);
     const ModuleSet lazy_deps = ValueDepsLazyForModule(mod, env);
 
-    AddEdges(edges.type_edges, *self_index, type_deps);
-    AddEdges(edges.eager_edges, *self_index, eager_deps);
-    AddEdges(edges.lazy_edges, *self_index, lazy_deps);
+    AddEdges(edges.type_edges, module_count, *self_index, type_deps);
+    AddEdges(edges.eager_edges, module_count, *self_index, eager_deps);
+    AddEdges(edges.lazy_edges, module_count, *self_index, lazy_deps);
+    if (!InitCannotPanic(mod, env, ctx.sigma)) {
+      init_may_panic[*self_index] = true;
+    }
   }
 
+  const InitAdjacency eager = BuildAdjacency(module_count, edges.eager_edges);
+  std::sort(edges.type_edges.begin(), edges.type_edges.end());
+  edges.type_edges.erase(
+      std::unique(edges.type_edges.begin(), edges.type_edges.end()),
+      edges.type_edges.end());
+  std::sort(edges.lazy_edges.begin(), edges.lazy_edges.end());
+  edges.lazy_edges.erase(
+      std::unique(edges.lazy_edges.begin(), edges.lazy_edges.end()),
+      edges.lazy_edges.end());
+
   InitPlan plan;
   plan.graph.modules = modules;
-  plan.graph.type_edges = FlattenEdges(edges.type_edges);
-  plan.graph.eager_edges = FlattenEdges(edges.eager_edges);
-  plan.graph.lazy_edges = FlattenEdges(edges.lazy_edges);
+  plan.graph.type_edges = std::move(edges.type_edges);
+  plan.graph.eager_edges = std::move(edges.eager_edges);
+  plan.graph.lazy_edges = std::move(edges.lazy_edges);
+
+  plan.poison_free = PoisonFree(eager, init_may_panic);
 
-  const bool acyclic = AcyclicEager(edges.eager_edges);
+  const auto cycles = CyclicComponents(eager);
   bool topo_ok = false;
-  if (acyclic) {
-    const auto order = TopoOrder(edges.eager_edges, topo_ok);
+  if (cycles.empty()) {
+    const auto order = TopoOrder(eager, topo_ok);
     if (topo_ok) {
       plan.init_order.reserve(order.size());
       for (const auto idx : order) {
@@ -1961,7 +2321,7 @@ InitPlanResult BuildInitPlan(const ScopeContext& ctx,
       }
     }
   } else {
-    EmitInitDiag(result.diags, "Topo-Cycle");
+    EmitInitDiag(result.diags, "Topo-Cycle", modules, cycles.front());
   }
 
   plan.topo_ok = topo_ok;
@@ -359,11 +359,8 @@ static void ParamTypeMap(const ScopeContext& ctx,
   TypeRef self_base;
   if (self_param.has_value()) {
     self_base = StripPermOnce(self_param->type);
-    if (env.scopes.empty()) {
-      env.scopes.emplace_back();
-    }
-    env.scopes.back()[IdKeyOf("self")] =
-        TypeBinding{syntax::Mutability::Let, self_param->type};
+    env.Bind(IdKeyOf("self"),
+             TypeBinding{syntax::Mutability::Let, self_param->type});
   }
   for (const auto& param : params) {
     const auto lowered = LocalLowerType(ctx, param.type);
@@ -374,11 +371,7 @@ static void ParamTypeMap(const ScopeContext& ctx,
     if (self_base) {
       type = SubstSelfType(self_base, type);
     }
-    if (env.scopes.empty()) {
-      env.scopes.emplace_back();
-    }
-    env.scopes.back()[IdKeyOf(param.name)] =
-        TypeBinding{syntax::Mutability::Let, type};
+    env.Bind(IdKeyOf(param.name), TypeBinding{syntax::Mutability::Let, type});
   }
 }
 
@@ -407,26 +400,13 @@ static void AddBindingsToTypeEnv(TypeEnv& env,
                                  const std::vector<std::pair<std::string, TypeRef>>& binds,
                                  syntax::Mutability mut,
                                  bool shadow) {
-  if (env.scopes.empty()) {
-    env.scopes.emplace_back();
+  if (env.Empty()) {
+    env.PushScope();
   }
   for (const auto& [name, type] : binds) {
     const auto key = IdKeyOf(name);
-    if (shadow) {
-      bool updated = false;
-      for (auto it = env.scopes.rbegin(); it != env.scopes.rend(); ++it) {
-        const auto found = it->find(key);
-        if (found != it->end()) {
-          found->second = TypeBinding{mut, type};
-          updated = true;
-          break;
-        }
-      }
-      if (!updated) {
-        env.scopes.back()[key] = TypeBinding{mut, type};
-      }
-    } else {
-      env.scopes.back()[key] = TypeBinding{mut, type};
+    if (!shadow || !env.Rebind(key, TypeBinding{mut, type})) {
+      env.Bind(key, TypeBinding{mut, type});
     }
   }
 }
@@ -1726,11 +1706,9 @@ static ProvStmtResult ProvStmt(const ScopeContext& ctx,
           inner_env.regions.push_back(RegionEntry{IdKeyOf(name), IdKeyOf(name)});
 
           TypeEnv inner_gamma = PushScope(gamma);
-          if (inner_gamma.scopes.empty()) {
-            inner_gamma.scopes.emplace_back();
-          }
-          inner_gamma.scopes.back()[IdKeyOf(name)] =
-              TypeBinding{syntax::Mutability::Let, RegionActiveTypeRef()};
+          inner_gamma.Bind(IdKeyOf(name),
+                           TypeBinding{syntax::Mutability::Let,
+                                        RegionActiveTypeRef()});
 
           if (node.body) {
             const auto body =
@@ -1764,11 +1742,9 @@ static ProvStmtResult ProvStmt(const ScopeContext& ctx,
               RegionEntry{IdKeyOf(fresh), IdKeyOf(*target)});
 
           TypeEnv inner_gamma = PushScope(gamma);
-          if (inner_gamma.scopes.empty()) {
-            inner_gamma.scopes.emplace_back();
-          }
-          inner_gamma.scopes.back()[IdKeyOf(fresh)] =
-              TypeBinding{syntax::Mutability::Let, RegionActiveTypeRef()};
+          inner_gamma.Bind(IdKeyOf(fresh),
+                           TypeBinding{syntax::Mutability::Let,
+                                        RegionActiveTypeRef()});
 
           if (node.body) {
             const auto body =
@@ -1854,16 +1830,16 @@ bool RegionActiveType(const TypeRef& type) {
 
 std::optional<std::string> InnermostActiveRegion(const TypeEnv& env) {
   SpecDefsRegions();
-  for (auto it = env.scopes.rbegin(); it != env.scopes.rend(); ++it) {
+  for (std::size_t scope = env.Depth(); scope-- > 0;) {
     std::optional<std::string> best;
-    for (const auto& [key, binding] : *it) {
+    env.ForEachBinding(scope, [&](const IdKey& key, const TypeBinding& binding) {
       if (!RegionActiveType(binding.type)) {
-        continue;
+        return;
       }
       if (!best.has_value() || key < *best) {
         best = key;
       }
-    }
+    });
     if (best.has_value()) {
       return best;
     }
@@ -1876,14 +1852,7 @@ std::string FreshRegionName(const TypeEnv& env) {
   for (std::size_t i = 0;; ++i) {
     std::string name = "region$" + std::to_string(i);
     const auto key = IdKeyOf(name);
-    bool used = false;
-    for (const auto& scope : env.scopes) {
-      if (scope.find(key) != scope.end()) {
-        used = true;
-        break;
-      }
-    }
-    if (!used) {
+    if (!env.Find(key)) {
       return name;
     }
   }
@@ -1925,14 +1894,11 @@ ProvCheckResult ProvBindCheck(const ScopeContext& ctx,
   }
 
   TypeEnv gamma;
-  gamma.scopes.emplace_back();
-  if (!static_bindings.empty()) {
-    for (const auto& binding : static_bindings) {
-      gamma.scopes.front()[IdKeyOf(binding.name)] =
-          TypeBinding{binding.mut, binding.type};
-    }
+  gamma.PushScope();
+  for (const auto& binding : static_bindings) {
+    gamma.Bind(IdKeyOf(binding.name), TypeBinding{binding.mut, binding.type});
   }
-  gamma.scopes.emplace_back();
+  gamma.PushScope();
   ParamTypeMap(ctx, params, self_param, gamma);
 
   const auto block = BlockProv(ctx, *body, prov_env, gamma, nullptr);
@@ -2002,14 +1968,11 @@ ExprProvMapResult ComputeExprProvenanceMap(
   }
 
   TypeEnv gamma;
-  gamma.scopes.emplace_back();
-  if (!static_bindings.empty()) {
-    for (const auto& binding : static_bindings) {
-      gamma.scopes.front()[IdKeyOf(binding.name)] =
-          TypeBinding{binding.mut, binding.type};
-    }
+  gamma.PushScope();
+  for (const auto& binding : static_bindings) {
+    gamma.Bind(IdKeyOf(binding.name), TypeBinding{binding.mut, binding.type});
   }
-  gamma.scopes.emplace_back();
+  gamma.PushScope();
   ParamTypeMap(ctx, params, self_param, gamma);
 
   ExprProvTagMap expr_map;
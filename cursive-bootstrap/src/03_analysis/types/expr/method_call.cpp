@@ -421,13 +421,50 @@ ExprTypeResult TypeMethodCallExprImpl(const ScopeContext& ctx,
       result.type = sig->ret;
       return result;
     }
-    if (IsReactorClassPath(dyn->path)) {
-      if (!(IdEq(expr.name, "run") || IdEq(expr.name, "register"))) {
+    if (IsReactorClassPath(dyn->path) &&
+        !(IdEq(expr.name, "run") || IdEq(expr.name, "register"))) {
+      const auto sig = LookupReactorMethodSig(expr.name);
+      if (!sig.has_value()) {
         SPEC_RULE("LookupClassMethod-NotFound");
         result.diag_id = "LookupMethod-NotFound";
         return result;
       }
 
+      const auto recv_base =
+          RecvBaseType(expr.receiver, std::nullopt, type_place, type_expr);
+      if (!recv_base.ok) {
+        result.diag_id = recv_base.diag_id;
+        return result;
+      }
+      if (!recv_base.base ||
+          !std::holds_alternative<TypeDynamic>(recv_base.base->node)) {
+        return result;
+      }
+      if (!PermSub(recv_base.perm, sig->recv_perm)) {
+        SPEC_RULE("MethodCall-RecvPerm-Err");
+        result.diag_id = "MethodCall-RecvPerm-Err";
+        return result;
+      }
+      const auto recv_arg = RecvArgOk(expr.receiver, std::nullopt, type_expr);
+      if (!recv_arg.ok) {
+        result.diag_id = recv_arg.diag_id;
+        return result;
+      }
+      const auto args_ok =
+          ArgsOk(ctx, sig->params, expr.args, type_expr, &type_place,
+                 lower_type);
+      if (!args_ok.ok) {
+        result.diag_id = args_ok.diag_id;
+        return result;
+      }
+
+      SPEC_RULE("T-Dynamic-MethodCall");
+      result.ok = true;
+      result.type = sig->ret;
+      return result;
+    }
+    if (IsReactorClassPath(dyn->path)) {
+
       const auto recv_base =
           RecvBaseType(expr.receiver, std::nullopt, type_place, type_expr);
       if (!recv_base.ok) {
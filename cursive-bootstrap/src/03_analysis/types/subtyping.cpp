@@ -12,6 +12,7 @@
 #include "cursive0/03_analysis/contracts/verification.h"
 #include "cursive0/03_analysis/resolve/scopes.h"
 #include "cursive0/03_analysis/types/type_equiv.h"
+#include "cursive0/03_analysis/types/type_memo.h"
 #include "cursive0/03_analysis/types/type_stmt.h"
 #include "cursive0/03_analysis/caps/cap_concurrency.h"
 #include "cursive0/02_syntax/ast.h"
@@ -140,11 +141,9 @@ static SubtypingResult Member(const TypeRef& type, const TypeUnion& uni) {
   return {true, std::nullopt, false};
 }
 
-}  // namespace
-
-SubtypingResult Subtyping(const ScopeContext& ctx,
-                          const TypeRef& lhs,
-                          const TypeRef& rhs) {
+SubtypingResult SubtypingUncached(const ScopeContext& ctx,
+                                  const TypeRef& lhs,
+                                  const TypeRef& rhs) {
   SpecDefsSubtyping();
   if (!lhs || !rhs) {
     return {true, std::nullopt, false};
@@ -171,9 +170,15 @@ SubtypingResult Subtyping(const ScopeContext& ctx,
       if (!lref->predicate || !rref->predicate) {
         return {true, std::nullopt, false};
       }
-      StaticProofContext proof_ctx;
+      // Sub-Refine holds for every `self`, so it must not see the facts of
+      // the procedure being typed (results are also memoized across
+      // procedures). One scratch context per thread is reused under a fact
+      // scope instead of building a fresh one per query.
+      thread_local StaticProofContext proof_ctx;
+      PushFactScope(proof_ctx);
       AddFact(proof_ctx, lref->predicate, rref->predicate->span);
       const auto proof = StaticProof(proof_ctx, rref->predicate);
+      PopFactScope(proof_ctx);
       if (proof.provable) {
         return {true, std::nullopt, true};
       }
@@ -457,4 +462,12 @@ SubtypingResult Subtyping(const ScopeContext& ctx,
   return {true, std::nullopt, false};
 }
 
+}  // namespace
+
+SubtypingResult Subtyping(const ScopeContext& ctx,
+                          const TypeRef& lhs,
+                          const TypeRef& rhs) {
+  return MemoSubtyping(ctx, lhs, rhs, SubtypingUncached);
+}
+
 }  // namespace cursive0::analysis
@@ -1109,22 +1109,11 @@ struct IntroResult {
 };
 
 static bool InScope(const TypeEnv& env, const IdKey& key) {
-  if (env.scopes.empty()) {
-    return false;
-  }
-  return env.scopes.back().find(key) != env.scopes.back().end();
+  return env.InInnermost(key);
 }
 
 static bool InOuter(const TypeEnv& env, const IdKey& key) {
-  if (env.scopes.size() < 2) {
-    return false;
-  }
-  for (std::size_t i = 0; i + 1 < env.scopes.size(); ++i) {
-    if (env.scopes[i].find(key) != env.scopes[i].end()) {
-      return true;
-    }
-  }
-  return false;
+  return env.InOuter(key);
 }
 
 static IntroResult IntroBinding(const TypeEnv& env,
@@ -1140,7 +1129,7 @@ static IntroResult IntroBinding(const TypeEnv& env,
   }
 
   const auto key = IdKeyOf(name);
-  if (env.scopes.empty()) {
+  if (env.Empty()) {
     return {false, std::nullopt, env};
   }
   if (InScope(env, key)) {
@@ -1153,7 +1142,7 @@ static IntroResult IntroBinding(const TypeEnv& env,
   }
 
   TypeEnv out = env;
-  out.scopes.back().emplace(key, binding);
+  out.Bind(key, binding);
   SPEC_RULE("Intro-Ok");
   return {true, std::nullopt, std::move(out)};
 }
@@ -1909,7 +1898,7 @@ ExprTypeResult TypeDispatchExpr(const ScopeContext& ctx,
     }
     // Add bindings to environment
     for (const auto& [name, type] : pat_result.bindings) {
-      body_env.scopes.back()[name] = TypeBinding{syntax::Mutability::Let, type};
+      body_env.Bind(name, TypeBinding{syntax::Mutability::Let, type});
     }
   }
 
@@ -1,17 +1,24 @@
 #include "cursive0/03_analysis/types/type_decls.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <set>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "cursive0/00_core/assert_spec.h"
 #include "cursive0/00_core/diagnostic_messages.h"
+#include "cursive0/00_core/spec_trace.h"
 #include "cursive0/03_analysis/attributes/attribute_registry.h"
+#include "cursive0/03_analysis/contracts/verification.h"
 #include "cursive0/03_analysis/memory/borrow_bind.h"
 #include "cursive0/03_analysis/composite/classes.h"
 #include "cursive0/03_analysis/composite/enums.h"
@@ -148,14 +155,14 @@ static std::vector<IdKey> ParamNames(const std::vector<syntax::Param>& params) {
 static bool AddBinding(TypeEnv& env,
                        std::string_view name,
                        const TypeRef& type) {
-  if (env.scopes.empty()) {
-    env.scopes.emplace_back();
+  if (env.Empty()) {
+    env.PushScope();
   }
   const auto key = IdKeyOf(name);
-  if (env.scopes.back().find(key) != env.scopes.back().end()) {
+  if (env.InInnermost(key)) {
     return false;
   }
-  env.scopes.back()[key] = {syntax::Mutability::Let, type};
+  env.Bind(key, {syntax::Mutability::Let, type});
   return true;
 }
 
@@ -226,6 +233,11 @@ static ExprTypeResult TypeBlockForDecl(const ScopeContext& ctx,
   type_ctx.contract = contract;
   type_ctx.contract_dynamic = contract_dynamic;
 
+  ProofSession proofs;
+  if (contract && contract->precondition) {
+    AddConjunctFacts(proofs.context(), contract->precondition);
+  }
+
   TypeEnv live_env = env;
   type_ctx.env_ref = &live_env;
   auto active_env = [&]() -> const TypeEnv& {
@@ -342,7 +354,7 @@ static bool CheckTypeInvariantPredicate(const ScopeContext& ctx,
                                         const TypeRef& self_type,
                                         core::DiagnosticStream& diags) {
   TypeEnv env;
-  env.scopes.emplace_back();
+  env.PushScope();
   (void)AddBinding(env, "self", self_type);
   return CheckPredicateExpr(ctx, invariant.predicate, MakeTypePrim("()"), env,
                             ContractPhase::Precondition, diags);
@@ -1595,7 +1607,7 @@ static bool CheckProcedureDecl(ScopeContext& ctx,
   }
 
   TypeEnv env;
-  env.scopes.emplace_back();
+  env.PushScope();
   for (const auto& [name, type] : binds) {
     (void)AddBinding(env, name, type);
   }
@@ -1670,7 +1682,7 @@ static bool CheckStaticDecl(const ScopeContext& ctx,
   }
 
   TypeEnv env;
-  env.scopes.emplace_back();
+  env.PushScope();
   const auto check = CheckExprAgainstType(ctx, decl.binding.init, ann.type,
                                           env, diags);
   if (!check.ok) {
@@ -1792,7 +1804,7 @@ static bool CheckRecordMethod(ScopeContext& ctx,
   }
 
   TypeEnv env;
-  env.scopes.emplace_back();
+  env.PushScope();
   for (const auto& [name, type] : binds) {
     (void)AddBinding(env, name, type);
   }
@@ -2081,7 +2093,7 @@ static bool CheckStateMethod(ScopeContext& ctx,
   }
 
   TypeEnv env;
-  env.scopes.emplace_back();
+  env.PushScope();
   for (const auto& [name, type] : binds) {
     (void)AddBinding(env, name, type);
   }
@@ -2160,7 +2172,7 @@ static bool CheckTransition(const ScopeContext& ctx,
   SPEC_RULE("WF-Transition");
 
   TypeEnv env;
-  env.scopes.emplace_back();
+  env.PushScope();
   for (const auto& [name, type] : binds) {
     (void)AddBinding(env, name, type);
   }
@@ -2365,7 +2377,7 @@ static bool CheckClassMethod(ScopeContext& ctx,
   }
 
   TypeEnv env;
-  env.scopes.emplace_back();
+  env.PushScope();
   for (const auto& [name, type] : binds) {
     (void)AddBinding(env, name, type);
   }
@@ -2563,6 +2575,197 @@ static bool DeclTypingItem(ScopeContext& ctx,
       item);
 }
 
+// `opaque C` return type, possibly under a permission. Bodies of such
+// procedures record the underlying type in Sigma::opaque_underlying.
+static bool ReturnsOpaque(const std::shared_ptr<syntax::Type>& type) {
+  if (!type) {
+    return false;
+  }
+  if (const auto* perm = std::get_if<syntax::TypePermType>(&type->node)) {
+    return ReturnsOpaque(perm->base);
+  }
+  return std::holds_alternative<syntax::TypeOpaque>(type->node);
+}
+
+static bool ItemDefinesOpaque(const syntax::ASTItem& item) {
+  if (const auto* proc = std::get_if<syntax::ProcedureDecl>(&item)) {
+    return ReturnsOpaque(proc->return_type_opt);
+  }
+  if (const auto* record = std::get_if<syntax::RecordDecl>(&item)) {
+    for (const auto& member : record->members) {
+      const auto* method = std::get_if<syntax::MethodDecl>(&member);
+      if (method && ReturnsOpaque(method->return_type_opt)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (const auto* modal = std::get_if<syntax::ModalDecl>(&item)) {
+    for (const auto& state : modal->states) {
+      for (const auto& member : state.members) {
+        const auto* method = std::get_if<syntax::StateMethodDecl>(&member);
+        if (method && ReturnsOpaque(method->return_type_opt)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+  if (const auto* class_decl = std::get_if<syntax::ClassDecl>(&item)) {
+    for (const auto& class_item : class_decl->items) {
+      const auto* method = std::get_if<syntax::ClassMethodDecl>(&class_item);
+      if (method && ReturnsOpaque(method->return_type_opt)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+struct DeclTask {
+  std::size_t module = 0;
+  const syntax::ASTItem* item = nullptr;
+  bool defines_opaque = false;
+};
+
+struct DeclTaskOutput {
+  core::DiagnosticStream diags;
+  ExprTypeMap expr_types;
+};
+
+struct OpaqueDef {
+  std::size_t task = 0;
+  const syntax::Type* origin = nullptr;
+  TypeRef underlying;
+};
+
+static std::size_t DeclTypingJobs(std::size_t tasks) {
+  // Trace lines are recorded as rules fire; keep them in item order.
+  if (core::SpecTrace::Enabled()) {
+    return 1;
+  }
+  std::size_t jobs = std::thread::hardware_concurrency();
+  if (const char* env = std::getenv("CURSIVE0_TYPECHECK_JOBS")) {
+    jobs = static_cast<std::size_t>(std::strtoul(env, nullptr, 10));
+  }
+  return std::min(std::max<std::size_t>(jobs, 1), tasks);
+}
+
+// Types every item on `jobs` threads, each with its own ScopeContext copy,
+// ExprTypeMap shard and diagnostic buffer, merged back in item order.
+//
+// Items are independent once Sigma is fixed, except that a body returning
+// `opaque C` publishes its underlying type for items after it. Those items
+// are typed first, serially, and each later item is given exactly the
+// entries from items before it, so results match the serial walk. Returns
+// false (with ctx unchanged) if an item published an entry that was not
+// predicted; the caller then types serially.
+static bool DeclTypingParallel(ScopeContext& ctx,
+                               const std::vector<syntax::ASTModule>& modules,
+                               const std::vector<ScopeList>& module_scopes,
+                               const std::vector<DeclTask>& tasks,
+                               std::size_t jobs,
+                               core::DiagnosticStream& diags) {
+  const auto type_task = [&](ScopeContext& local, std::size_t index,
+                             DeclTaskOutput& out) {
+    const auto& task = tasks[index];
+    local.current_module = modules[task.module].path;
+    local.scopes = module_scopes[task.module];
+    local.expr_types = &out.expr_types;
+    (void)DeclTypingItem(local, modules[task.module].path, *task.item,
+                         out.diags);
+  };
+
+  std::vector<DeclTaskOutput> outputs(tasks.size());
+
+  ScopeContext opaque_ctx = ctx;
+  std::vector<OpaqueDef> opaque_defs;
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    if (!tasks[i].defines_opaque) {
+      continue;
+    }
+    type_task(opaque_ctx, i, outputs[i]);
+    for (const auto& [origin, underlying] : opaque_ctx.sigma.opaque_underlying) {
+      if (!ctx.sigma.opaque_underlying.count(origin) &&
+          std::none_of(opaque_defs.begin(), opaque_defs.end(),
+                       [&](const OpaqueDef& def) {
+                         return def.origin == origin;
+                       })) {
+        opaque_defs.push_back(OpaqueDef{i, origin, underlying});
+      }
+    }
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> unpredicted(false);
+  std::exception_ptr failure;
+  std::mutex failure_mutex;
+  const auto worker = [&]() {
+    try {
+      ScopeContext local = ctx;
+      std::size_t published = 0;
+      while (!unpredicted.load()) {
+        // Indices only grow per worker, so entries are only ever added.
+        const std::size_t i = next.fetch_add(1);
+        if (i >= tasks.size()) {
+          break;
+        }
+        if (tasks[i].defines_opaque) {
+          continue;
+        }
+        for (; published < opaque_defs.size() &&
+               opaque_defs[published].task < i;
+             ++published) {
+          local.sigma.opaque_underlying[opaque_defs[published].origin] =
+              opaque_defs[published].underlying;
+        }
+        const std::size_t known = local.sigma.opaque_underlying.size();
+        type_task(local, i, outputs[i]);
+        if (local.sigma.opaque_underlying.size() != known) {
+          unpredicted.store(true);
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(failure_mutex);
+      if (!failure) {
+        failure = std::current_exception();
+      }
+      unpredicted.store(true);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(jobs - 1);
+  for (std::size_t j = 1; j < jobs; ++j) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+  if (unpredicted.load()) {
+    return false;
+  }
+
+  for (auto& out : outputs) {
+    diags.insert(diags.end(), out.diags.begin(), out.diags.end());
+    if (ctx.expr_types) {
+      for (auto& [expr, type] : out.expr_types) {
+        (*ctx.expr_types)[expr] = std::move(type);
+      }
+    }
+  }
+  ctx.sigma.opaque_underlying = std::move(opaque_ctx.sigma.opaque_underlying);
+  if (!modules.empty()) {
+    ctx.current_module = modules.back().path;
+    ctx.scopes = module_scopes.back();
+  }
+  return true;
+}
+
 }  // namespace
 
 DeclTypingResult DeclTypingModules(ScopeContext& ctx,
@@ -2570,14 +2773,32 @@ DeclTypingResult DeclTypingModules(ScopeContext& ctx,
                                    const NameMapTable& name_maps) {
   SpecDefsDeclTyping();
   DeclTypingResult result;
-  for (const auto& module : modules) {
-    ctx.current_module = module.path;
+  std::vector<ScopeList> module_scopes;
+  module_scopes.reserve(modules.size());
+  std::vector<DeclTask> tasks;
+  for (std::size_t m = 0; m < modules.size(); ++m) {
     Scope module_scope;
-    const auto map_it = name_maps.find(PathKeyOf(module.path));
+    const auto map_it = name_maps.find(PathKeyOf(modules[m].path));
     if (map_it != name_maps.end()) {
       module_scope = map_it->second;
     }
-    ctx.scopes = {Scope{}, std::move(module_scope), UniverseBindings()};
+    module_scopes.push_back({Scope{}, std::move(module_scope), UniverseBindings()});
+    for (const auto& item : modules[m].items) {
+      tasks.push_back(DeclTask{m, &item, ItemDefinesOpaque(item)});
+    }
+  }
+
+  const std::size_t jobs = DeclTypingJobs(tasks.size());
+  if (jobs > 1 &&
+      DeclTypingParallel(ctx, modules, module_scopes, tasks, jobs, result.diags)) {
+    result.ok = !core::HasError(result.diags);
+    return result;
+  }
+
+  for (std::size_t m = 0; m < modules.size(); ++m) {
+    const auto& module = modules[m];
+    ctx.current_module = module.path;
+    ctx.scopes = module_scopes[m];
     for (const auto& item : module.items) {
       (void)DeclTypingItem(ctx, module.path, item, result.diags);
     }
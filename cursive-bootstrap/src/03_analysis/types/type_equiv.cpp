@@ -15,6 +15,7 @@
 #include "cursive0/03_analysis/resolve/scopes.h"
 #include "cursive0/03_analysis/resolve/scopes_lookup.h"
 #include "cursive0/03_analysis/resolve/visibility.h"
+#include "cursive0/03_analysis/types/type_memo.h"
 
 namespace cursive0::analysis {
 
@@ -383,7 +384,8 @@ ConstLenResult ConstLen(const ScopeContext& ctx, const syntax::ExprPtr& expr) {
       expr->node);
 }
 
-TypeEquivResult TypeEquiv(const TypeRef& lhs, const TypeRef& rhs) {
+static TypeEquivResult TypeEquivUncached(const TypeRef& lhs,
+                                         const TypeRef& rhs) {
   SpecDefsTypeEquiv();
   if (!lhs || !rhs) {
     return {true, std::nullopt, false};
@@ -598,4 +600,8 @@ TypeEquivResult TypeEquiv(const TypeRef& lhs, const TypeRef& rhs) {
       lhs->node);
 }
 
+TypeEquivResult TypeEquiv(const TypeRef& lhs, const TypeRef& rhs) {
+  return MemoTypeEquiv(lhs, rhs, TypeEquivUncached);
+}
+
 }  // namespace cursive0::analysis
@@ -16,6 +16,7 @@
 #include "cursive0/03_analysis/resolve/scopes.h"
 #include "cursive0/03_analysis/types/type_lower.h"
 #include "cursive0/03_analysis/types/types.h"
+#include "cursive0/04_codegen/layout/layout.h"
 
 namespace cursive0::analysis {
 
@@ -166,63 +167,6 @@ static auto ModalDeclLayout(const ScopeContext& ctx,
   return std::make_pair(size, align);
 }
 
-static auto EnumDeclLayout(const ScopeContext& ctx, const syntax::EnumDecl& decl)
-    -> std::optional<std::pair<std::uint64_t, std::uint64_t>> {
-  if (decl.variants.empty()) {
-    return std::nullopt;
-  }
-  const auto discs = EnumDiscriminants(decl);
-  if (!discs.ok || discs.discs.empty()) {
-    return std::nullopt;
-  }
-  const auto disc_layout = DiscTypeLayout(discs.max_disc);
-  if (!disc_layout.has_value()) {
-    return std::nullopt;
-  }
-
-  std::uint64_t payload_size = 0;
-  std::uint64_t payload_align = 1;
-  for (const auto& variant : decl.variants) {
-    std::optional<std::pair<std::uint64_t, std::uint64_t>> layout;
-    if (!variant.payload_opt.has_value()) {
-      layout = std::make_pair(0ull, 1ull);
-    } else if (const auto* tuple =
-                   std::get_if<syntax::VariantPayloadTuple>(&*variant.payload_opt)) {
-      std::vector<TypeRef> elements;
-      elements.reserve(tuple->elements.size());
-      for (const auto& elem : tuple->elements) {
-        const auto lowered = LowerType(ctx, elem);
-        if (!lowered.ok) {
-          return std::nullopt;
-        }
-        elements.push_back(lowered.type);
-      }
-      layout = LayoutOfSeq(ctx, elements);
-    } else if (const auto* rec =
-                   std::get_if<syntax::VariantPayloadRecord>(&*variant.payload_opt)) {
-      std::vector<TypeRef> fields;
-      fields.reserve(rec->fields.size());
-      for (const auto& field : rec->fields) {
-        const auto lowered = LowerType(ctx, field.type);
-        if (!lowered.ok) {
-          return std::nullopt;
-        }
-        fields.push_back(lowered.type);
-      }
-      layout = LayoutOfSeq(ctx, fields);
-    }
-    if (!layout.has_value()) {
-      return std::nullopt;
-    }
-    payload_size = std::max(payload_size, layout->first);
-    payload_align = std::max(payload_align, layout->second);
-  }
-
-  const std::uint64_t align = std::max(disc_layout->second, payload_align);
-  const std::uint64_t size = AlignUp(disc_layout->first + payload_size, align);
-  return std::make_pair(size, align);
-}
-
 static auto ComputeAsyncLayout(const ScopeContext& ctx,
                                const std::vector<TypeRef>& async_args)
     -> std::optional<std::pair<std::uint64_t, std::uint64_t>> {
@@ -510,10 +454,19 @@ static std::optional<std::pair<std::uint64_t, std::uint64_t>> LayoutOf(
           fields.push_back(lowered.type);
         }
       }
-      return LayoutOfSeq(ctx, fields);
+      // The emitted layout, which may reorder fields.
+      const auto layout = codegen::RecordDeclLayoutOf(ctx, *record, fields);
+      if (!layout.has_value()) {
+        return std::nullopt;
+      }
+      return std::make_pair(layout->layout.size, layout->layout.align);
     }
     if (const auto* enum_decl = std::get_if<syntax::EnumDecl>(&it->second)) {
-      return EnumDeclLayout(ctx, *enum_decl);
+      const auto layout = codegen::EnumLayoutOf(ctx, *enum_decl);
+      if (!layout.has_value()) {
+        return std::nullopt;
+      }
+      return std::make_pair(layout->layout.size, layout->layout.align);
     }
     if (const auto* modal_decl = std::get_if<syntax::ModalDecl>(&it->second)) {
       return ModalDeclLayout(ctx, *modal_decl);
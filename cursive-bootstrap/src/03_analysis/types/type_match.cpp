@@ -288,22 +288,11 @@ static const syntax::EnumDecl* LookupEnumDecl(const ScopeContext& ctx,
 }
 
 static bool InScope(const TypeEnv& env, const IdKey& key) {
-  if (env.scopes.empty()) {
-    return false;
-  }
-  return env.scopes.back().find(key) != env.scopes.back().end();
+  return env.InInnermost(key);
 }
 
 static bool InOuter(const TypeEnv& env, const IdKey& key) {
-  if (env.scopes.size() < 2) {
-    return false;
-  }
-  for (std::size_t i = 0; i + 1 < env.scopes.size(); ++i) {
-    if (env.scopes[i].find(key) != env.scopes[i].end()) {
-      return true;
-    }
-  }
-  return false;
+  return env.InOuter(key);
 }
 
 static IntroResult IntroBinding(const TypeEnv& env,
@@ -320,7 +309,7 @@ static IntroResult IntroBinding(const TypeEnv& env,
   }
 
   const auto key = IdKeyOf(name);
-  if (env.scopes.empty()) {
+  if (env.Empty()) {
     return {false, std::nullopt, env};
   }
 
@@ -332,11 +321,8 @@ static IntroResult IntroBinding(const TypeEnv& env,
     SPEC_RULE("Intro-Shadow-Required");
     if (std::getenv("CURSIVE0_DEBUG_SHADOW")) {
       std::cerr << "[cursivec0] shadow required for pattern `" << name << "`";
-      for (std::size_t i = 1; i < env.scopes.size(); ++i) {
-        if (env.scopes[i].count(key)) {
-          std::cerr << " (outer scope " << i << ")";
-          break;
-        }
+      if (const auto scope = env.ScopeOf(key)) {
+        std::cerr << " (outer scope " << *scope << ")";
       }
       std::cerr << "\n";
     }
@@ -344,7 +330,7 @@ static IntroResult IntroBinding(const TypeEnv& env,
   }
 
   TypeEnv out = env;
-  out.scopes.back().emplace(key, binding);
+  out.Bind(key, binding);
   SPEC_RULE("Intro-Ok");
   return {true, std::nullopt, std::move(out)};
 }
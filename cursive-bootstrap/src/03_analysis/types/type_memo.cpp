@@ -0,0 +1,309 @@
+#include "cursive0/03_analysis/types/type_memo.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+
+#include "cursive0/00_core/spec_trace.h"
+
+namespace cursive0::analysis {
+
+namespace {
+
+// Id of the open session, 0 when none is open.
+std::atomic<std::uint64_t> g_session{0};
+std::atomic<std::uint64_t> g_next_session{1};
+
+std::atomic<std::uint64_t> g_equiv_hits{0};
+std::atomic<std::uint64_t> g_equiv_misses{0};
+std::atomic<std::uint64_t> g_sub_hits{0};
+std::atomic<std::uint64_t> g_sub_misses{0};
+
+// 128-bit structural hash of a type.
+struct Fingerprint {
+  std::uint64_t hi = 0x243f6a8885a308d3ULL;
+  std::uint64_t lo = 0x13198a2e03707344ULL;
+
+  bool operator==(const Fingerprint& other) const {
+    return hi == other.hi && lo == other.lo;
+  }
+};
+
+std::uint64_t Mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+void Add(Fingerprint& fp, std::uint64_t value) {
+  fp.hi = Mix(fp.hi + value + 0x9e3779b97f4a7c15ULL);
+  fp.lo = Mix(fp.lo ^ (value * 0xc2b2ae3d27d4eb4fULL + 0x165667b19e3779f9ULL));
+}
+
+void Add(Fingerprint& fp, const Fingerprint& child) {
+  Add(fp, child.hi);
+  Add(fp, child.lo);
+}
+
+void Add(Fingerprint& fp, const std::string& text) {
+  Add(fp, text.size());
+  for (std::size_t i = 0; i < text.size(); i += 8) {
+    std::uint64_t chunk = 0;
+    std::memcpy(&chunk, text.data() + i, std::min<std::size_t>(8, text.size() - i));
+    Add(fp, chunk);
+  }
+}
+
+void Add(Fingerprint& fp, const TypePath& path) {
+  Add(fp, path.size());
+  for (const auto& seg : path) {
+    Add(fp, seg);
+  }
+}
+
+template <typename E>
+void Add(Fingerprint& fp, const std::optional<E>& state) {
+  Add(fp, state.has_value() ? static_cast<std::uint64_t>(*state) + 1 : 0);
+}
+
+void Add(Fingerprint& fp, const void* identity) {
+  Add(fp, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(identity)));
+}
+
+struct PairKey {
+  Fingerprint lhs;
+  Fingerprint rhs;
+  const Sigma* sigma = nullptr;  // Subtyping only
+
+  bool operator==(const PairKey& other) const {
+    return lhs == other.lhs && rhs == other.rhs && sigma == other.sigma;
+  }
+};
+
+struct PairKeyHash {
+  std::size_t operator()(const PairKey& key) const {
+    return static_cast<std::size_t>(
+        Mix(key.lhs.hi ^ Mix(key.rhs.lo + reinterpret_cast<std::uintptr_t>(key.sigma))));
+  }
+};
+
+// Entries keep their operands alive, so no other predicate or type can
+// take an address that one of their fingerprints is built from.
+template <typename R>
+struct MemoEntry {
+  TypeRef lhs;
+  TypeRef rhs;
+  R result;
+};
+
+struct CachedFingerprint {
+  std::weak_ptr<Type> owner;
+  Fingerprint fp;
+};
+
+struct MemoTables {
+  std::uint64_t session = 0;
+  std::unordered_map<const Type*, CachedFingerprint> fingerprints;
+  std::unordered_map<PairKey, MemoEntry<TypeEquivResult>, PairKeyHash> equiv;
+  std::unordered_map<PairKey, MemoEntry<SubtypingResult>, PairKeyHash> sub;
+
+  void Reset(std::uint64_t id) {
+    session = id;
+    fingerprints.clear();
+    equiv.clear();
+    sub.clear();
+  }
+};
+
+thread_local MemoTables t_tables;
+
+// Tables for the open session, or null when memoization is off.
+MemoTables* ActiveTables() {
+  const std::uint64_t session = g_session.load(std::memory_order_acquire);
+  if (session == 0) {
+    return nullptr;
+  }
+  if (t_tables.session != session) {
+    t_tables.Reset(session);
+  }
+  return &t_tables;
+}
+
+Fingerprint FingerprintOf(MemoTables& tables, const TypeRef& type) {
+  Fingerprint fp;
+  if (!type) {
+    return fp;
+  }
+  const auto cached = tables.fingerprints.find(type.get());
+  // A live owner means the address still holds the type it was computed for.
+  if (cached != tables.fingerprints.end() && !cached->second.owner.expired()) {
+    return cached->second.fp;
+  }
+
+  Add(fp, type->node.index());
+  std::visit(
+      [&](const auto& node) {
+        using T = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<T, TypePrim>) {
+          Add(fp, node.name);
+        } else if constexpr (std::is_same_v<T, TypePerm>) {
+          Add(fp, static_cast<std::uint64_t>(node.perm));
+          Add(fp, FingerprintOf(tables, node.base));
+        } else if constexpr (std::is_same_v<T, TypeUnion>) {
+          Add(fp, node.members.size());
+          for (const auto& member : node.members) {
+            Add(fp, FingerprintOf(tables, member));
+          }
+        } else if constexpr (std::is_same_v<T, TypeFunc>) {
+          Add(fp, node.params.size());
+          for (const auto& param : node.params) {
+            Add(fp, param.mode);
+            Add(fp, FingerprintOf(tables, param.type));
+          }
+          Add(fp, FingerprintOf(tables, node.ret));
+        } else if constexpr (std::is_same_v<T, TypeTuple>) {
+          Add(fp, node.elements.size());
+          for (const auto& elem : node.elements) {
+            Add(fp, FingerprintOf(tables, elem));
+          }
+        } else if constexpr (std::is_same_v<T, TypeArray>) {
+          Add(fp, node.length);
+          Add(fp, FingerprintOf(tables, node.element));
+        } else if constexpr (std::is_same_v<T, TypeSlice>) {
+          Add(fp, FingerprintOf(tables, node.element));
+        } else if constexpr (std::is_same_v<T, TypePtr>) {
+          Add(fp, node.state);
+          Add(fp, FingerprintOf(tables, node.element));
+        } else if constexpr (std::is_same_v<T, TypeRawPtr>) {
+          Add(fp, static_cast<std::uint64_t>(node.qual));
+          Add(fp, FingerprintOf(tables, node.element));
+        } else if constexpr (std::is_same_v<T, TypeString> ||
+                             std::is_same_v<T, TypeBytes>) {
+          Add(fp, node.state);
+        } else if constexpr (std::is_same_v<T, TypeDynamic>) {
+          Add(fp, node.path);
+        } else if constexpr (std::is_same_v<T, TypeModalState>) {
+          Add(fp, node.path);
+          Add(fp, node.state);
+          Add(fp, node.generic_args.size());
+          for (const auto& arg : node.generic_args) {
+            Add(fp, FingerprintOf(tables, arg));
+          }
+        } else if constexpr (std::is_same_v<T, TypePathType>) {
+          Add(fp, node.path);
+          Add(fp, node.generic_args.size());
+          for (const auto& arg : node.generic_args) {
+            Add(fp, FingerprintOf(tables, arg));
+          }
+        } else if constexpr (std::is_same_v<T, TypeOpaque>) {
+          Add(fp, node.class_path);
+          Add(fp, static_cast<const void*>(node.origin));
+          Add(fp, node.origin_span.file);
+          Add(fp, node.origin_span.start_offset);
+          Add(fp, node.origin_span.end_offset);
+        } else if constexpr (std::is_same_v<T, TypeRefine>) {
+          Add(fp, FingerprintOf(tables, node.base));
+          Add(fp, static_cast<const void*>(node.predicate.get()));
+        }
+        // TypeRange has no fields.
+      },
+      type->node);
+
+  tables.fingerprints[type.get()] = CachedFingerprint{type, fp};
+  return fp;
+}
+
+// Cheaper to compare directly than to look up.
+bool IsLeaf(const TypeRef& type) {
+  return std::holds_alternative<TypePrim>(type->node) ||
+         std::holds_alternative<TypeRange>(type->node) ||
+         std::holds_alternative<TypeString>(type->node) ||
+         std::holds_alternative<TypeBytes>(type->node);
+}
+
+bool Trivial(const TypeRef& lhs, const TypeRef& rhs) {
+  return !lhs || !rhs || lhs.get() == rhs.get() || (IsLeaf(lhs) && IsLeaf(rhs));
+}
+
+}  // namespace
+
+TypeMemoSession::TypeMemoSession() {
+  if (std::getenv("CURSIVE0_NO_TYPE_MEMO") || core::SpecTrace::Enabled()) {
+    return;
+  }
+  std::uint64_t expected = 0;
+  const std::uint64_t id = g_next_session.fetch_add(1);
+  // A nested session reuses the outer one.
+  active_ = g_session.compare_exchange_strong(expected, id);
+  if (active_) {
+    g_equiv_hits = 0;
+    g_equiv_misses = 0;
+    g_sub_hits = 0;
+    g_sub_misses = 0;
+  }
+}
+
+TypeMemoSession::~TypeMemoSession() {
+  if (!active_) {
+    return;
+  }
+  g_session.store(0, std::memory_order_release);
+  t_tables.Reset(0);
+  if (std::getenv("CURSIVE0_TYPE_MEMO_STATS")) {
+    std::cerr << "[cursivec0] type-memo equiv_hits=" << g_equiv_hits
+              << " equiv_misses=" << g_equiv_misses
+              << " sub_hits=" << g_sub_hits
+              << " sub_misses=" << g_sub_misses << "\n";
+  }
+}
+
+TypeEquivResult MemoTypeEquiv(const TypeRef& lhs,
+                              const TypeRef& rhs,
+                              TypeEquivFn compute) {
+  MemoTables* tables = Trivial(lhs, rhs) ? nullptr : ActiveTables();
+  if (!tables) {
+    return compute(lhs, rhs);
+  }
+  const PairKey key{FingerprintOf(*tables, lhs), FingerprintOf(*tables, rhs)};
+  if (const auto it = tables->equiv.find(key); it != tables->equiv.end()) {
+    g_equiv_hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second.result;
+  }
+  g_equiv_misses.fetch_add(1, std::memory_order_relaxed);
+  const auto result = compute(lhs, rhs);
+  tables->equiv.emplace(key, MemoEntry<TypeEquivResult>{lhs, rhs, result});
+  return result;
+}
+
+SubtypingResult MemoSubtyping(const ScopeContext& ctx,
+                              const TypeRef& lhs,
+                              const TypeRef& rhs,
+                              SubtypingFn compute) {
+  MemoTables* tables = Trivial(lhs, rhs) ? nullptr : ActiveTables();
+  if (!tables) {
+    return compute(ctx, lhs, rhs);
+  }
+  const PairKey key{FingerprintOf(*tables, lhs), FingerprintOf(*tables, rhs),
+                    &ctx.sigma};
+  if (const auto it = tables->sub.find(key); it != tables->sub.end()) {
+    g_sub_hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second.result;
+  }
+  g_sub_misses.fetch_add(1, std::memory_order_relaxed);
+  const auto result = compute(ctx, lhs, rhs);
+  tables->sub.emplace(key, MemoEntry<SubtypingResult>{lhs, rhs, result});
+  return result;
+}
+
+}  // namespace cursive0::analysis
@@ -265,21 +265,6 @@ static syntax::ExprPtr SubstituteResultEntry(const syntax::ExprPtr& expr,
       expr->node);
 }
 
-static void CollectContractFacts(const syntax::ExprPtr& expr,
-                                 StaticProofContext& ctx) {
-  if (!expr) {
-    return;
-  }
-  if (const auto* binary = std::get_if<syntax::BinaryExpr>(&expr->node)) {
-    if (binary->op == "&&") {
-      CollectContractFacts(binary->lhs, ctx);
-      CollectContractFacts(binary->rhs, ctx);
-      return;
-    }
-  }
-  AddFact(ctx, expr, expr->span);
-}
-
 static std::optional<std::string_view> VerifyPostconditionAtReturn(
     const ScopeContext& ctx,
     const StmtTypeContext& type_ctx,
@@ -291,11 +276,11 @@ static std::optional<std::string_view> VerifyPostconditionAtReturn(
       return_value ? return_value : MakeUnitExpr(type_ctx.contract->postcondition->span);
   const auto pred =
       SubstituteResultEntry(type_ctx.contract->postcondition, result_expr);
-  StaticProofContext proof_ctx;
-  if (type_ctx.contract->precondition) {
-    CollectContractFacts(type_ctx.contract->precondition, proof_ctx);
-  }
-  const auto proof = StaticProof(proof_ctx, pred);
+  // type_ctx.contract is set by TypeBlockForDecl, whose ProofSession holds
+  // the precondition.
+  static const StaticProofContext kNoFacts;
+  const StaticProofContext* proof_ctx = CurrentProofContext();
+  const auto proof = StaticProof(proof_ctx ? *proof_ctx : kNoFacts, pred);
   if (!proof.provable && !type_ctx.contract_dynamic) {
     return "E-SEM-2801";
   }
@@ -541,22 +526,11 @@ static LocalTypeLowerResult LocalLowerType(const ScopeContext& ctx,
 }
 
 static bool InScope(const TypeEnv& env, const IdKey& key) {
-  if (env.scopes.empty()) {
-    return false;
-  }
-  return env.scopes.back().find(key) != env.scopes.back().end();
+  return env.InInnermost(key);
 }
 
 static bool InOuter(const TypeEnv& env, const IdKey& key) {
-  if (env.scopes.size() < 2) {
-    return false;
-  }
-  for (std::size_t i = 0; i + 1 < env.scopes.size(); ++i) {
-    if (env.scopes[i].find(key) != env.scopes[i].end()) {
-      return true;
-    }
-  }
-  return false;
+  return env.InOuter(key);
 }
 
 static IntroResult IntroBinding(const TypeEnv& env,
@@ -573,7 +547,7 @@ static IntroResult IntroBinding(const TypeEnv& env,
   }
 
   const auto key = IdKeyOf(name);
-  if (env.scopes.empty()) {
+  if (env.Empty()) {
     return {false, std::nullopt, env};
   }
 
@@ -590,7 +564,7 @@ static IntroResult IntroBinding(const TypeEnv& env,
   }
 
   TypeEnv out = env;
-  out.scopes.back().emplace(key, binding);
+  out.Bind(key, binding);
   SPEC_RULE("Intro-Ok");
   return {true, std::nullopt, std::move(out)};
 }
@@ -609,7 +583,7 @@ static IntroResult ShadowIntroBinding(const TypeEnv& env,
   }
 
   const auto key = IdKeyOf(name);
-  if (env.scopes.empty()) {
+  if (env.Empty()) {
     return {false, std::nullopt, env};
   }
   if (InScope(env, key)) {
@@ -621,7 +595,7 @@ static IntroResult ShadowIntroBinding(const TypeEnv& env,
   }
 
   TypeEnv out = env;
-  out.scopes.back().emplace(key, binding);
+  out.Bind(key, binding);
   SPEC_RULE("Shadow-Ok");
   return {true, std::nullopt, std::move(out)};
 }
@@ -1392,33 +1366,243 @@ static std::optional<TypeRef> IterElementType(const TypeRef& iter_type) {
 
 }  // namespace
 
+TypeEnv::TypeEnv(const TypeEnv& other)
+    : store_(other.store_), len_(other.len_), marks_(other.marks_) {
+  Attach();
+}
+
+TypeEnv::TypeEnv(TypeEnv&& other) noexcept
+    : store_(std::move(other.store_)),
+      len_(other.len_),
+      marks_(std::move(other.marks_)) {
+  other.len_ = 0;
+  other.marks_.clear();
+}
+
+TypeEnv& TypeEnv::operator=(const TypeEnv& other) {
+  if (this != &other) {
+    Detach();
+    store_ = other.store_;
+    len_ = other.len_;
+    marks_ = other.marks_;
+    Attach();
+  }
+  return *this;
+}
+
+TypeEnv& TypeEnv::operator=(TypeEnv&& other) noexcept {
+  if (this != &other) {
+    Detach();
+    store_ = std::move(other.store_);
+    len_ = other.len_;
+    marks_ = std::move(other.marks_);
+    other.len_ = 0;
+    other.marks_.clear();
+  }
+  return *this;
+}
+
+TypeEnv::~TypeEnv() {
+  Detach();
+}
+
+void TypeEnv::Attach() {
+  if (!store_) {
+    return;
+  }
+  if (store_->views.size() <= len_) {
+    store_->views.resize(len_ + 1, 0);
+  }
+  ++store_->views[len_];
+}
+
+void TypeEnv::Detach() {
+  if (store_) {
+    --store_->views[len_];
+  }
+}
+
+void TypeEnv::SetLen(std::size_t len) {
+  Detach();
+  len_ = len;
+  Attach();
+}
+
+bool TypeEnv::TailObserved() const {
+  const auto& views = store_->views;
+  const std::size_t end = std::min(views.size(), store_->entries.size() + 1);
+  for (std::size_t i = len_ + 1; i < end; ++i) {
+    if (views[i] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TypeEnv::Truncate() {
+  auto& entries = store_->entries;
+  while (entries.size() > len_) {
+    const Entry& entry = entries.back();
+    if (entry.prev == kNone) {
+      store_->newest.erase(entry.key);
+    } else {
+      store_->newest[entry.key] = entry.prev;
+    }
+    entries.pop_back();
+  }
+}
+
+void TypeEnv::PushScope() {
+  marks_.push_back(len_);
+}
+
+void TypeEnv::PopScope() {
+  if (marks_.empty()) {
+    return;
+  }
+  SetLen(marks_.back());
+  marks_.pop_back();
+}
+
+void TypeEnv::Bind(const IdKey& key, const TypeBinding& binding) {
+  if (marks_.empty()) {
+    marks_.push_back(len_);
+  }
+  if (!store_) {
+    store_ = std::make_shared<Store>();
+    Attach();
+  } else if (len_ != store_->entries.size()) {
+    // Entries below len_ are immutable. The tail is dropped in place when
+    // no live view can see it (e.g. after a scope pop) and copied away
+    // otherwise.
+    if (TailObserved()) {
+      Unshare();
+    } else {
+      Truncate();
+    }
+  }
+  const auto found = store_->newest.find(key);
+  const std::size_t prev =
+      found == store_->newest.end() ? kNone : found->second;
+  store_->entries.push_back(Entry{key, binding, prev});
+  store_->newest[key] = len_;
+  SetLen(len_ + 1);
+}
+
+bool TypeEnv::Rebind(const IdKey& key, const TypeBinding& binding) {
+  if (EntryBelow(key, len_) == kNone) {
+    return false;
+  }
+  if (store_.use_count() > 1 || len_ != store_->entries.size()) {
+    Unshare();
+  }
+  store_->entries[EntryBelow(key, len_)].binding = binding;
+  return true;
+}
+
+void TypeEnv::Unshare() {
+  auto fork = std::make_shared<Store>();
+  if (store_) {
+    fork->entries.assign(store_->entries.begin(),
+                         store_->entries.begin() + len_);
+  }
+  for (std::size_t i = 0; i < fork->entries.size(); ++i) {
+    auto& entry = fork->entries[i];
+    const auto found = fork->newest.find(entry.key);
+    entry.prev = found == fork->newest.end() ? kNone : found->second;
+    fork->newest[entry.key] = i;
+  }
+  Detach();
+  store_ = std::move(fork);
+  Attach();
+}
+
+std::size_t TypeEnv::EntryBelow(const IdKey& key, std::size_t limit) const {
+  if (!store_) {
+    return kNone;
+  }
+  const auto found = store_->newest.find(key);
+  if (found == store_->newest.end()) {
+    return kNone;
+  }
+  std::size_t index = found->second;
+  while (index != kNone && index >= limit) {
+    index = store_->entries[index].prev;
+  }
+  return index;
+}
+
+const TypeBinding* TypeEnv::Find(const IdKey& key) const {
+  const std::size_t index = EntryBelow(key, len_);
+  return index == kNone ? nullptr : &store_->entries[index].binding;
+}
+
+bool TypeEnv::InInnermost(const IdKey& key) const {
+  if (marks_.empty()) {
+    return false;
+  }
+  const std::size_t index = EntryBelow(key, len_);
+  return index != kNone && index >= ScopeStart();
+}
+
+bool TypeEnv::InOuter(const IdKey& key) const {
+  if (marks_.size() < 2) {
+    return false;
+  }
+  return EntryBelow(key, ScopeStart()) != kNone;
+}
+
+std::optional<std::size_t> TypeEnv::ScopeOf(const IdKey& key) const {
+  const std::size_t index = EntryBelow(key, len_);
+  if (index == kNone) {
+    return std::nullopt;
+  }
+  const auto it = std::upper_bound(marks_.begin(), marks_.end(), index);
+  if (it == marks_.begin()) {
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(it - marks_.begin()) - 1;
+}
+
+void TypeEnv::ForEachBinding(
+    std::size_t scope,
+    const std::function<void(const IdKey&, const TypeBinding&)>& fn) const {
+  if (scope >= marks_.size() || !store_) {
+    return;
+  }
+  const std::size_t begin = marks_[scope];
+  const std::size_t end =
+      scope + 1 < marks_.size() ? marks_[scope + 1] : len_;
+  for (std::size_t i = begin; i < end; ++i) {
+    const auto& entry = store_->entries[i];
+    // Skip entries a later Bind in the same scope replaced.
+    if (EntryBelow(entry.key, end) == i) {
+      fn(entry.key, entry.binding);
+    }
+  }
+}
+
 TypeEnv PushScope(const TypeEnv& env) {
   SpecDefsTypeStmt();
   TypeEnv out = env;
-  out.scopes.emplace_back();
+  out.PushScope();
   return out;
 }
 
 TypeEnv PopScope(const TypeEnv& env) {
   SpecDefsTypeStmt();
-  if (env.scopes.empty()) {
-    return env;
-  }
   TypeEnv out = env;
-  out.scopes.pop_back();
+  out.PopScope();
   return out;
 }
 
 std::optional<TypeBinding> BindOf(const TypeEnv& env, std::string_view name) {
   SpecDefsTypeStmt();
-  const auto key = IdKeyOf(name);
-  for (auto it = env.scopes.rbegin(); it != env.scopes.rend(); ++it) {
-    const auto found = it->find(key);
-    if (found != it->end()) {
-      return found->second;
-    }
+  const TypeBinding* binding = env.Find(IdKeyOf(name));
+  if (!binding) {
+    return std::nullopt;
   }
-  return std::nullopt;
+  return *binding;
 }
 
 std::optional<syntax::Mutability> MutOf(const TypeEnv& env,
@@ -166,10 +166,9 @@ static TypeWfResult TypeWFImpl(const ScopeContext& ctx, const TypeRef& type) {
             return {false, std::nullopt};
           }
           TypeEnv env;
-          TypeScope scope;
-          scope.emplace(IdKeyOf("self"),
-                        TypeBinding{syntax::Mutability::Let, node.base});
-          env.scopes.push_back(std::move(scope));
+          env.PushScope();
+          env.Bind(IdKeyOf("self"),
+                   TypeBinding{syntax::Mutability::Let, node.base});
           StmtTypeContext type_ctx;
           type_ctx.return_type = MakeTypePrim("bool");
           const auto pred_type = TypeExpr(ctx, type_ctx, node.predicate, env);
@@ -6,12 +6,14 @@
 #include "cursive0/03_analysis/resolve/collect_toplevel.h"
 #include "cursive0/03_analysis/memory/init_planner.h"
 #include "cursive0/03_analysis/types/type_decls.h"
+#include "cursive0/03_analysis/types/type_memo.h"
 
 namespace cursive0::analysis {
 
 TypecheckResult TypecheckModules(ScopeContext& ctx,
                                  const std::vector<syntax::ASTModule>& modules) {
   TypecheckResult result;
+  const TypeMemoSession type_memo;
   ExprTypeMap* prev_expr_types = ctx.expr_types;
   ctx.expr_types = &result.expr_types;
   struct ExprTypesReset {
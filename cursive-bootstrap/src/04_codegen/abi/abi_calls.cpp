@@ -257,6 +257,17 @@ std::optional<std::string> BuiltinMethodSym(std::string_view cap_class,
     return sym;
   }
 
+  // (BuiltinMethodSym-Reactor)
+  // BuiltinSym(Reactor::name) ⇓ sym; run is lowered as a reactor-driven sync.
+  if (cap_class == "Reactor") {
+    SPEC_RULE("BuiltinMethodSym-Reactor");
+    const std::string sym = BuiltinSym(std::string("Reactor::") + std::string(name));
+    if (sym.empty()) {
+      return std::nullopt;
+    }
+    return sym;
+  }
+
   if (cap_class == "ExecutionDomain" || cap_class == "CpuDomain" ||
       cap_class == "GpuDomain" || cap_class == "InlineDomain") {
     SPEC_RULE("BuiltinMethodSym-ExecutionDomain");
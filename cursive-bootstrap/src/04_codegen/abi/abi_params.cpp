@@ -19,6 +19,8 @@ const std::unordered_set<std::string_view>& RuntimeSymbols() {
       "cursive::runtime::panic",
       // ContextInitSym
       "cursive::runtime::context_init",
+      // RuntimeShutdownSym
+      "cursive::runtime::shutdown",
       // SpecTraceSym
       "cursive::runtime::spec_trace::emit",
       // StringDropSym
@@ -73,6 +75,7 @@ const std::unordered_set<std::string_view>& RuntimeSymbols() {
       "cursive::runtime::fs::write_file",
       "cursive::runtime::fs::write_stdout",
       "cursive::runtime::fs::write_stderr",
+      "cursive::runtime::fs::flush_std",
       "cursive::runtime::fs::exists",
       "cursive::runtime::fs::remove",
       "cursive::runtime::fs::open_dir",
@@ -80,6 +83,11 @@ const std::unordered_set<std::string_view>& RuntimeSymbols() {
       "cursive::runtime::fs::ensure_dir",
       "cursive::runtime::fs::kind",
       "cursive::runtime::fs::restrict",
+      // Reactor symbols
+      "cursive::runtime::reactor::read",
+      "cursive::runtime::reactor::write",
+      "cursive::runtime::reactor::open_read",
+      "cursive::runtime::reactor::wait",
       // Heap symbols
       "cursive::runtime::heap::with_quota",
       "cursive::runtime::heap::alloc_raw",
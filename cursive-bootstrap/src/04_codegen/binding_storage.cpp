@@ -60,7 +60,7 @@ void LLVMEmitter::EmitBindVar(const IRBindVar& bind) {
             }
         }
     }
-    const bool use_region = prov == analysis::ProvenanceKind::Region;
+    const bool use_region = prov == analysis::ProvenanceKind::Region && !bind.stack_slot;
 
     const auto* derived = current_ctx_ ? current_ctx_->LookupDerivedValue(bind.value) : nullptr;
     if (derived && derived->kind == DerivedValueInfo::Kind::LoadFromAddr) {
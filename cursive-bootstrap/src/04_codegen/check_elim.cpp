@@ -0,0 +1,998 @@
+#include "cursive0/04_codegen/check_elim.h"
+
+#include "cursive0/04_codegen/lower/lower_expr.h"
+#include "cursive0/03_analysis/resolve/collect_toplevel.h"
+#include "cursive0/03_analysis/types/type_expr.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cursive0::codegen {
+
+namespace {
+
+// Bounds at or above this are not combined, so the sum or product of two
+// tracked bounds cannot wrap a u64.
+constexpr std::uint64_t kMaxTrackedBound = std::uint64_t{1} << 32;
+
+// Largest value every integer type can hold (i8); used when neither operand
+// of an arithmetic op has a known type.
+constexpr std::uint64_t kAnyIntMax = 127;
+constexpr unsigned kAnyIntBits = 8;
+
+// Closed interval over non-negative values. A missing lo means the value may
+// be negative (signed types); a missing hi means no upper bound is known.
+struct Interval {
+  std::optional<std::uint64_t> lo;
+  std::optional<std::uint64_t> hi;
+
+  bool Bounded() const { return lo.has_value() && hi.has_value(); }
+  bool Empty() const { return !lo.has_value() && !hi.has_value(); }
+};
+
+Interval Meet(const Interval& a, const Interval& b) {
+  Interval out = a;
+  if (b.lo.has_value() && (!out.lo.has_value() || *b.lo > *out.lo)) {
+    out.lo = b.lo;
+  }
+  if (b.hi.has_value() && (!out.hi.has_value() || *b.hi < *out.hi)) {
+    out.hi = b.hi;
+  }
+  return out;
+}
+
+struct Facts {
+  std::unordered_map<std::string, Interval> bounds;        // value key -> range
+  std::unordered_map<std::string, std::uint64_t> min_len;  // base key -> len >= n
+  // Canonical key of a check that already passed -> value keys it reads.
+  std::map<std::string, std::vector<std::string>> proven;
+
+  void Kill(const std::string& key) {
+    bounds.erase(key);
+    min_len.erase(key);
+    for (auto it = proven.begin(); it != proven.end();) {
+      const auto& deps = it->second;
+      if (std::find(deps.begin(), deps.end(), key) != deps.end()) {
+        it = proven.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+};
+
+struct IntPrimInfo {
+  bool is_signed = false;
+  unsigned bits = 0;
+};
+
+std::optional<IntPrimInfo> IntPrimOf(const analysis::TypeRef& type) {
+  const auto stripped = analysis::StripPerm(type);
+  if (!stripped) {
+    return std::nullopt;
+  }
+  const auto* prim = std::get_if<analysis::TypePrim>(&stripped->node);
+  if (!prim) {
+    return std::nullopt;
+  }
+  static const std::pair<std::string_view, IntPrimInfo> kPrims[] = {
+      {"i8", {true, 8}},     {"u8", {false, 8}},     {"i16", {true, 16}},
+      {"u16", {false, 16}},  {"i32", {true, 32}},    {"u32", {false, 32}},
+      {"i64", {true, 64}},   {"u64", {false, 64}},   {"i128", {true, 128}},
+      {"u128", {false, 128}}, {"isize", {true, 64}}, {"usize", {false, 64}},
+  };
+  for (const auto& [name, info] : kPrims) {
+    if (prim->name == name) {
+      return info;
+    }
+  }
+  return std::nullopt;
+}
+
+std::uint64_t IntMax(const IntPrimInfo& info) {
+  if (info.bits >= 64) {
+    return info.is_signed
+               ? static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())
+               : std::numeric_limits<std::uint64_t>::max();
+  }
+  const unsigned value_bits = info.is_signed ? info.bits - 1 : info.bits;
+  return (std::uint64_t{1} << value_bits) - 1;
+}
+
+std::string StripIntSuffix(std::string text) {
+  static const char* suffixes[] = {
+      "isize", "usize", "i128", "u128", "i64", "u64", "i32", "u32", "i16", "u16", "i8", "u8"
+  };
+  for (const char* suf : suffixes) {
+    const std::string_view sv{suf};
+    if (text.size() >= sv.size() &&
+        text.compare(text.size() - sv.size(), sv.size(), sv) == 0) {
+      return text.substr(0, text.size() - sv.size());
+    }
+  }
+  return text;
+}
+
+// Integer literal value of an immediate, read from its lexeme. Immediate
+// bytes are left alone since their byte order depends on how they were made.
+std::optional<std::uint64_t> ImmediateU64(const IRValue& value) {
+  if (value.kind != IRValue::Kind::Immediate || value.name.empty()) {
+    return std::nullopt;
+  }
+  std::string text = StripIntSuffix(value.name);
+  text.erase(std::remove(text.begin(), text.end(), '_'), text.end());
+  unsigned base = 10;
+  if (text.size() > 2 && text[0] == '0') {
+    const char p = text[1];
+    if (p == 'x' || p == 'X') {
+      base = 16;
+    } else if (p == 'b' || p == 'B') {
+      base = 2;
+    } else if (p == 'o' || p == 'O') {
+      base = 8;
+    }
+    if (base != 10) {
+      text.erase(0, 2);
+    }
+  }
+  if (text.empty()) {
+    return std::nullopt;
+  }
+  std::uint64_t out = 0;
+  for (char c : text) {
+    unsigned digit = 0;
+    if (c >= '0' && c <= '9') {
+      digit = static_cast<unsigned>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      digit = static_cast<unsigned>(c - 'a') + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = static_cast<unsigned>(c - 'A') + 10;
+    } else {
+      return std::nullopt;
+    }
+    if (digit >= base) {
+      return std::nullopt;
+    }
+    if (out > (std::numeric_limits<std::uint64_t>::max() - digit) / base) {
+      return std::nullopt;
+    }
+    out = out * base + digit;
+  }
+  return out;
+}
+
+// Root binding of a place repr: `*p.f[i]` -> `p`.
+std::string PlaceRoot(const IRPlace& place) {
+  std::string_view repr = place.repr;
+  while (!repr.empty() && repr.front() == '*') {
+    repr.remove_prefix(1);
+  }
+  const auto end = repr.find_first_of(".[");
+  return std::string(repr.substr(0, end));
+}
+
+std::string LocalKey(const std::string& name) {
+  return "L:" + name;
+}
+
+template <typename Fn>
+void ForEachChild(const IR& ir, Fn&& fn) {
+  std::visit(
+      [&](const auto& node) {
+        using T = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<T, IRSeq>) {
+          for (const auto& item : node.items) {
+            fn(item);
+          }
+        } else if constexpr (std::is_same_v<T, IRIf>) {
+          fn(node.then_ir);
+          fn(node.else_ir);
+        } else if constexpr (std::is_same_v<T, IRBlock>) {
+          fn(node.setup);
+          fn(node.body);
+        } else if constexpr (std::is_same_v<T, IRLoop>) {
+          fn(node.iter_ir);
+          fn(node.cond_ir);
+          fn(node.body_ir);
+        } else if constexpr (std::is_same_v<T, IRMatch>) {
+          for (const auto& arm : node.arms) {
+            fn(arm.body);
+          }
+        } else if constexpr (std::is_same_v<T, IRRegion> ||
+                             std::is_same_v<T, IRFrame> ||
+                             std::is_same_v<T, IRParallel>) {
+          fn(node.body);
+        } else if constexpr (std::is_same_v<T, IRPanicCheck> ||
+                             std::is_same_v<T, IRLowerPanic>) {
+          fn(node.cleanup_ir);
+        } else if constexpr (std::is_same_v<T, IRSpawn> ||
+                             std::is_same_v<T, IRDispatch>) {
+          fn(node.captured_env);
+          fn(node.body);
+        } else if constexpr (std::is_same_v<T, IRSync>) {
+          fn(node.wait_ir);
+        } else if constexpr (std::is_same_v<T, IRRaceReturn> ||
+                             std::is_same_v<T, IRRaceYield>) {
+          for (const auto& arm : node.arms) {
+            fn(arm.async_ir);
+            fn(arm.handler_ir);
+          }
+        } else if constexpr (std::is_same_v<T, IRAll>) {
+          for (const auto& item : node.async_irs) {
+            fn(item);
+          }
+        }
+      },
+      ir.node);
+}
+
+void AddPatternNames(const std::shared_ptr<syntax::Pattern>& pattern,
+                     std::unordered_set<std::string>& names) {
+  if (!pattern) {
+    return;
+  }
+  for (const auto& name : analysis::PatNames(pattern)) {
+    names.insert(name);
+  }
+}
+
+// Binding names a subtree introduces (binds_only) or may write.
+void CollectNames(const IRPtr& ir,
+                  bool binds_only,
+                  std::unordered_set<std::string>& names) {
+  if (!ir) {
+    return;
+  }
+  std::visit(
+      [&](const auto& node) {
+        using T = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<T, IRBindVar>) {
+          names.insert(node.name);
+        } else if constexpr (std::is_same_v<T, IRStoreVar> ||
+                             std::is_same_v<T, IRStoreVarNoDrop>) {
+          if (!binds_only) {
+            names.insert(node.name);
+          }
+        } else if constexpr (std::is_same_v<T, IRWritePlace> ||
+                             std::is_same_v<T, IRAddrOf> ||
+                             std::is_same_v<T, IRMoveState>) {
+          if (!binds_only) {
+            names.insert(PlaceRoot(node.place));
+          }
+        } else if constexpr (std::is_same_v<T, IRLoop>) {
+          AddPatternNames(node.pattern, names);
+        } else if constexpr (std::is_same_v<T, IRMatch>) {
+          for (const auto& arm : node.arms) {
+            AddPatternNames(arm.pattern, names);
+          }
+        } else if constexpr (std::is_same_v<T, IRRegion>) {
+          if (node.alias.has_value()) {
+            names.insert(*node.alias);
+          }
+        }
+      },
+      ir->node);
+  ForEachChild(*ir, [&](const IRPtr& child) {
+    CollectNames(child, binds_only, names);
+  });
+}
+
+void CollectAddressTaken(const IRPtr& ir, std::unordered_set<std::string>& names) {
+  if (!ir) {
+    return;
+  }
+  if (const auto* addr = std::get_if<IRAddrOf>(&ir->node)) {
+    names.insert(PlaceRoot(addr->place));
+  }
+  ForEachChild(*ir, [&](const IRPtr& child) {
+    CollectAddressTaken(child, names);
+  });
+}
+
+// True when control never falls out of the end of `ir`.
+bool Diverges(const IRPtr& ir) {
+  if (!ir) {
+    return false;
+  }
+  return std::visit(
+      [&](const auto& node) -> bool {
+        using T = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<T, IRReturn> ||
+                      std::is_same_v<T, IRBreak> ||
+                      std::is_same_v<T, IRContinue> ||
+                      std::is_same_v<T, IRLowerPanic>) {
+          return true;
+        } else if constexpr (std::is_same_v<T, IRSeq>) {
+          return std::any_of(node.items.begin(), node.items.end(), Diverges);
+        } else if constexpr (std::is_same_v<T, IRBlock>) {
+          return Diverges(node.setup) || Diverges(node.body);
+        } else if constexpr (std::is_same_v<T, IRIf>) {
+          return Diverges(node.then_ir) && Diverges(node.else_ir);
+        } else {
+          return false;
+        }
+      },
+      ir->node);
+}
+
+std::string NegateRelation(const std::string& rel) {
+  if (rel == "<") return ">=";
+  if (rel == "<=") return ">";
+  if (rel == ">") return "<=";
+  if (rel == ">=") return "<";
+  if (rel == "==") return "!=";
+  if (rel == "!=") return "==";
+  return {};
+}
+
+bool IsRelation(const std::string& op) {
+  return op == "<" || op == "<=" || op == ">" || op == ">=" || op == "==" ||
+         op == "!=";
+}
+
+// Result interval of a checked +, -, * when it provably fits `max`.
+std::optional<Interval> ProveArith(const std::string& op,
+                                   const Interval& a,
+                                   const Interval& b,
+                                   std::uint64_t max) {
+  if (!a.Bounded() || !b.Bounded() || *a.hi >= kMaxTrackedBound ||
+      *b.hi >= kMaxTrackedBound) {
+    return std::nullopt;
+  }
+  Interval out;
+  if (op == "+") {
+    out.lo = *a.lo + *b.lo;
+    out.hi = *a.hi + *b.hi;
+  } else if (op == "-") {
+    if (*a.lo < *b.hi) {
+      return std::nullopt;
+    }
+    out.lo = *a.lo - *b.hi;
+    out.hi = *a.hi - *b.lo;
+  } else if (op == "*") {
+    out.lo = *a.lo * *b.lo;
+    out.hi = *a.hi * *b.hi;
+  } else {
+    return std::nullopt;
+  }
+  if (*out.hi > max) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+class CheckElim {
+ public:
+  CheckElim(const LowerCtx& ctx,
+            const syntax::ExprPtr& precondition,
+            const IR* entry_check)
+      : ctx_(ctx), precondition_(precondition), entry_check_(entry_check) {}
+
+  void Prepare(const ProcIR& proc) {
+    for (const auto& param : proc.params) {
+      local_types_[param.name] = param.type;
+    }
+    CollectAddressTaken(proc.body, exposed_);
+    ctx_.derived_values.ForEach([&](const DerivedValueInfo& info) {
+      if (info.kind == DerivedValueInfo::Kind::AddrLocal) {
+        exposed_.insert(info.name);
+      }
+    });
+  }
+
+  // Conjuncts of the precondition comparing parameters and integer literals.
+  void AssumePredicate(const syntax::ExprPtr& pred, Facts& f) {
+    if (!pred) {
+      return;
+    }
+    const auto* bin = std::get_if<syntax::BinaryExpr>(&pred->node);
+    if (!bin) {
+      return;
+    }
+    if (bin->op == "&&") {
+      AssumePredicate(bin->lhs, f);
+      AssumePredicate(bin->rhs, f);
+      return;
+    }
+    if (!IsRelation(bin->op)) {
+      return;
+    }
+    const auto lhs = PredicateOperand(bin->lhs);
+    const auto rhs = PredicateOperand(bin->rhs);
+    if (lhs.has_value() && rhs.has_value()) {
+      AssumeRelation(*lhs, bin->op, *rhs, f);
+    }
+  }
+
+  // Returns true when `ir` was a check that got removed.
+  bool Walk(IRPtr& ir, Facts& f) {
+    if (!ir) {
+      return false;
+    }
+    bool removed = false;
+    std::visit(
+        [&](auto& node) {
+          using T = std::decay_t<decltype(node)>;
+          if constexpr (std::is_same_v<T, IRSeq>) {
+            WalkSeq(node, f);
+          } else if constexpr (std::is_same_v<T, IRBindVar>) {
+            const Interval value = IntervalOf(node.value, f);
+            f.Kill(LocalKey(node.name));
+            local_types_[node.name] = node.type;
+            SetLocal(node.name, value, f);
+          } else if constexpr (std::is_same_v<T, IRStoreVar> ||
+                               std::is_same_v<T, IRStoreVarNoDrop>) {
+            const Interval value = IntervalOf(node.value, f);
+            f.Kill(LocalKey(node.name));
+            SetLocal(node.name, value, f);
+          } else if constexpr (std::is_same_v<T, IRWritePlace>) {
+            const std::string root = PlaceRoot(node.place);
+            const Interval value = IntervalOf(node.value, f);
+            f.Kill(LocalKey(root));
+            if (root == node.place.repr) {
+              SetLocal(root, value, f);
+            }
+          } else if constexpr (std::is_same_v<T, IRAddrOf> ||
+                               std::is_same_v<T, IRMoveState>) {
+            f.Kill(LocalKey(PlaceRoot(node.place)));
+          } else if constexpr (std::is_same_v<T, IRBinaryOp>) {
+            VisitBinaryOp(node, f);
+          } else if constexpr (std::is_same_v<T, IRCast>) {
+            VisitCast(node, f);
+          } else if constexpr (std::is_same_v<T, IRCheckIndex>) {
+            removed = VisitCheckIndex(node, f);
+          } else if constexpr (std::is_same_v<T, IRCheckRange>) {
+            removed = VisitCheckRange(node, f);
+          } else if constexpr (std::is_same_v<T, IRCheckSliceLen>) {
+            removed = VisitCheckSliceLen(node, f);
+          } else if constexpr (std::is_same_v<T, IRCheckOp>) {
+            removed = VisitCheckOp(node, f);
+          } else if constexpr (std::is_same_v<T, IRIf>) {
+            VisitIf(node, f);
+          } else if constexpr (std::is_same_v<T, IRBlock>) {
+            const auto saved_types = local_types_;
+            Walk(node.setup, f);
+            Walk(node.body, f);
+            KillNames(ir, true, f);
+            local_types_ = saved_types;
+          } else if constexpr (std::is_same_v<T, IRRegion> ||
+                               std::is_same_v<T, IRFrame>) {
+            const auto saved_types = local_types_;
+            Walk(node.body, f);
+            KillNames(ir, true, f);
+            local_types_ = saved_types;
+          } else if constexpr (std::is_same_v<T, IRLoop>) {
+            VisitLoop(ir, node, f);
+          } else if constexpr (std::is_same_v<T, IRMatch>) {
+            VisitMatch(ir, node, f);
+          } else if constexpr (std::is_same_v<T, IRPanicCheck> ||
+                               std::is_same_v<T, IRLowerPanic>) {
+            // Cleanup runs only on the way out of the procedure.
+          } else {
+            // Concurrency and async bodies are left as emitted; only their
+            // writes are accounted for.
+            KillNames(ir, false, f);
+          }
+        },
+        ir->node);
+    if (removed) {
+      ir = EmptyIR();
+      ++stats_.removed;
+    }
+    return removed;
+  }
+
+  CheckElimStats Stats() const { return stats_; }
+
+ private:
+  const LowerCtx& ctx_;
+  syntax::ExprPtr precondition_;
+  const IR* entry_check_ = nullptr;
+  std::unordered_set<std::string> exposed_;
+  std::unordered_map<std::string, analysis::TypeRef> local_types_;
+  std::unordered_map<std::uint32_t, const IRBinaryOp*> compares_;  // by temp id
+  CheckElimStats stats_;
+
+  void WalkSeq(IRSeq& seq, Facts& f) {
+    for (std::size_t i = 0; i < seq.items.size(); ++i) {
+      const bool is_entry_check =
+          entry_check_ && seq.items[i].get() == entry_check_;
+      const bool removed = Walk(seq.items[i], f);
+      if (is_entry_check) {
+        // Past the [[dynamic]] entry check the precondition holds.
+        AssumePredicate(precondition_, f);
+      }
+      if (!removed) {
+        continue;
+      }
+      // The PanicCheck after a removed check has nothing left to observe.
+      if (i + 1 < seq.items.size() && seq.items[i + 1] &&
+          std::holds_alternative<IRPanicCheck>(seq.items[i + 1]->node)) {
+        seq.items[i + 1] = EmptyIR();
+        ++i;
+      }
+    }
+  }
+
+  void KillNames(const IRPtr& ir, bool binds_only, Facts& f) {
+    std::unordered_set<std::string> names;
+    CollectNames(ir, binds_only, names);
+    for (const auto& name : names) {
+      f.Kill(LocalKey(name));
+    }
+  }
+
+  std::optional<std::string> Key(const IRValue& value) const {
+    switch (value.kind) {
+      case IRValue::Kind::Immediate:
+        if (value.name.empty()) {
+          return std::nullopt;
+        }
+        return "#" + value.name;
+      case IRValue::Kind::Local:
+        if (exposed_.count(value.name)) {
+          return std::nullopt;
+        }
+        return LocalKey(value.name);
+      case IRValue::Kind::Opaque:
+        // Derived values are re-read from their base at each use.
+        // Only numbered temps are tracked; fixed names ("unit") carry no facts.
+        if (value.id == 0 || ctx_.LookupDerivedValue(value)) {
+          return std::nullopt;
+        }
+        return "T:" + std::to_string(value.id);
+      default:
+        return std::nullopt;
+    }
+  }
+
+  analysis::TypeRef TypeOf(const IRValue& value) const {
+    if (value.kind == IRValue::Kind::Local) {
+      const auto it = local_types_.find(value.name);
+      return it == local_types_.end() ? nullptr : it->second;
+    }
+    if (value.kind == IRValue::Kind::Opaque) {
+      return ctx_.LookupValueType(value);
+    }
+    return nullptr;
+  }
+
+  bool IsIntValue(const IRValue& value) const {
+    if (value.kind == IRValue::Kind::Immediate) {
+      return ImmediateU64(value).has_value();
+    }
+    return IntPrimOf(TypeOf(value)).has_value();
+  }
+
+  Interval IntervalOf(const IRValue& value, const Facts& f) const {
+    if (value.kind == IRValue::Kind::Immediate) {
+      const auto n = ImmediateU64(value);
+      return n.has_value() ? Interval{n, n} : Interval{};
+    }
+    const auto prim = IntPrimOf(TypeOf(value));
+    if (!prim.has_value()) {
+      return {};
+    }
+    Interval out;
+    if (!prim->is_signed) {
+      out.lo = 0;
+    }
+    out.hi = IntMax(*prim);
+    if (const auto key = Key(value)) {
+      const auto it = f.bounds.find(*key);
+      if (it != f.bounds.end()) {
+        out = Meet(out, it->second);
+      }
+    }
+    return out;
+  }
+
+  void SetLocal(const std::string& name, const Interval& value, Facts& f) {
+    if (exposed_.count(name) || value.Empty()) {
+      return;
+    }
+    f.bounds[LocalKey(name)] = value;
+  }
+
+  void Narrow(const IRValue& value, const Interval& by, Facts& f) {
+    if (value.kind == IRValue::Kind::Immediate || by.Empty()) {
+      return;
+    }
+    const auto key = Key(value);
+    if (!key.has_value()) {
+      return;
+    }
+    auto& slot = f.bounds[*key];
+    slot = Meet(slot, by);
+  }
+
+  // Largest result the operand type of an arithmetic op can hold; nullopt
+  // for non-integer operands.
+  std::optional<std::uint64_t> OperandMax(const IRValue& lhs,
+                                          const IRValue& rhs) const {
+    for (const IRValue* v : {&lhs, &rhs}) {
+      const auto type = TypeOf(*v);
+      if (!type) {
+        continue;
+      }
+      const auto prim = IntPrimOf(type);
+      if (!prim.has_value()) {
+        return std::nullopt;
+      }
+      return IntMax(*prim);
+    }
+    if (!IsIntValue(lhs) || !IsIntValue(rhs)) {
+      return std::nullopt;
+    }
+    return kAnyIntMax;
+  }
+
+  void AssumeRelation(const IRValue& lhs,
+                      std::string rel,
+                      const IRValue& rhs,
+                      Facts& f) {
+    if (!IsIntValue(lhs) || !IsIntValue(rhs)) {
+      return;
+    }
+    const IRValue* a = &lhs;
+    const IRValue* b = &rhs;
+    if (rel == ">" || rel == ">=") {
+      std::swap(a, b);
+      rel = rel == ">" ? "<" : "<=";
+    }
+    const Interval ia = IntervalOf(*a, f);
+    const Interval ib = IntervalOf(*b, f);
+    if (rel == "==") {
+      Narrow(*a, ib, f);
+      Narrow(*b, ia, f);
+      return;
+    }
+    if (rel != "<" && rel != "<=") {
+      return;
+    }
+    const std::uint64_t strict = rel == "<" ? 1 : 0;
+    if (ib.hi.has_value() && *ib.hi >= strict) {
+      Narrow(*a, Interval{std::nullopt, *ib.hi - strict}, f);
+    }
+    if (ia.lo.has_value() && *ia.lo < std::numeric_limits<std::uint64_t>::max()) {
+      Narrow(*b, Interval{*ia.lo + strict, std::nullopt}, f);
+    }
+  }
+
+  void AssumeCondition(const IRValue& cond, bool truth, Facts& f) {
+    if (cond.kind != IRValue::Kind::Opaque) {
+      return;
+    }
+    const auto it = compares_.find(cond.id);
+    if (it == compares_.end()) {
+      return;
+    }
+    const IRBinaryOp& cmp = *it->second;
+    const std::string rel = truth ? cmp.op : NegateRelation(cmp.op);
+    AssumeRelation(cmp.lhs, rel, cmp.rhs, f);
+  }
+
+  std::optional<IRValue> PredicateOperand(const syntax::ExprPtr& expr) const {
+    if (!expr) {
+      return std::nullopt;
+    }
+    IRValue value;
+    if (const auto* ident = std::get_if<syntax::IdentifierExpr>(&expr->node)) {
+      if (!local_types_.count(ident->name)) {
+        return std::nullopt;
+      }
+      value.kind = IRValue::Kind::Local;
+      value.name = ident->name;
+      return value;
+    }
+    if (const auto* lit = std::get_if<syntax::LiteralExpr>(&expr->node)) {
+      if (lit->literal.kind != syntax::TokenKind::IntLiteral) {
+        return std::nullopt;
+      }
+      value.kind = IRValue::Kind::Immediate;
+      value.name = lit->literal.lexeme;
+      return value;
+    }
+    return std::nullopt;
+  }
+
+  void VisitBinaryOp(IRBinaryOp& op, Facts& f) {
+    if (IsRelation(op.op)) {
+      if (op.result.id != 0) {
+        compares_[op.result.id] = &op;
+      }
+      return;
+    }
+    const auto result_key = Key(op.result);
+    const auto max = OperandMax(op.lhs, op.rhs);
+    if (!max.has_value()) {
+      return;
+    }
+    const Interval lhs = IntervalOf(op.lhs, f);
+    const Interval rhs = IntervalOf(op.rhs, f);
+    if (op.op == "%" && lhs.lo.has_value() && rhs.Bounded() && *rhs.lo >= 1) {
+      if (result_key) {
+        f.bounds[*result_key] = Interval{0, *rhs.hi - 1};
+      }
+      return;
+    }
+    const auto result = ProveArith(op.op, lhs, rhs, *max);
+    if (!result.has_value()) {
+      return;
+    }
+    if (!op.unchecked) {
+      op.unchecked = true;
+      ++stats_.unchecked_ops;
+    }
+    if (result_key) {
+      f.bounds[*result_key] = *result;
+    }
+  }
+
+  void VisitCast(const IRCast& cast, Facts& f) {
+    const auto target = IntPrimOf(cast.target);
+    const auto key = Key(cast.result);
+    if (!target.has_value() || !key.has_value() || !IsIntValue(cast.value)) {
+      return;
+    }
+    const Interval value = IntervalOf(cast.value, f);
+    if (value.Bounded() && *value.hi <= IntMax(*target)) {
+      f.bounds[*key] = value;
+    }
+  }
+
+  std::optional<std::uint64_t> LenLowerBound(const IRValue& base,
+                                             const Facts& f) const {
+    const auto stripped = analysis::StripPerm(TypeOf(base));
+    if (stripped) {
+      if (const auto* array = std::get_if<analysis::TypeArray>(&stripped->node)) {
+        return array->length;
+      }
+    }
+    if (const auto key = Key(base)) {
+      const auto it = f.min_len.find(*key);
+      if (it != f.min_len.end()) {
+        return it->second;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void RaiseMinLen(const IRValue& base, std::uint64_t len, Facts& f) {
+    const auto key = Key(base);
+    if (!key.has_value() || len == 0) {
+      return;
+    }
+    auto& slot = f.min_len[*key];
+    slot = std::max(slot, len);
+  }
+
+  // Records `parts` as a passed check; returns true when it already was one.
+  bool SeenOrRecord(const std::vector<std::optional<std::string>>& parts,
+                    Facts& f) {
+    std::string key;
+    std::vector<std::string> deps;
+    for (const auto& part : parts) {
+      if (!part.has_value()) {
+        return false;
+      }
+      key += *part;
+      key += '\x1f';
+      deps.push_back(*part);
+    }
+    if (f.proven.count(key)) {
+      return true;
+    }
+    f.proven.emplace(std::move(key), std::move(deps));
+    return false;
+  }
+
+  std::optional<std::string> OptKey(const std::optional<IRValue>& value) const {
+    if (!value.has_value()) {
+      return std::string("-");
+    }
+    return Key(*value);
+  }
+
+  bool VisitCheckIndex(const IRCheckIndex& check, Facts& f) {
+    ++stats_.checks;
+    const Interval idx = IntervalOf(check.index, f);
+    const auto len = LenLowerBound(check.base, f);
+    if (idx.Bounded() && len.has_value() && *idx.hi < *len) {
+      return true;
+    }
+    if (SeenOrRecord({std::string("index"), Key(check.base), Key(check.index)}, f)) {
+      return true;
+    }
+    if (idx.lo.has_value() && *idx.lo < std::numeric_limits<std::uint64_t>::max()) {
+      RaiseMinLen(check.base, *idx.lo + 1, f);
+    }
+    return false;
+  }
+
+  bool VisitCheckRange(const IRCheckRange& check, Facts& f) {
+    ++stats_.checks;
+    const auto& range = check.range;
+    if (range.kind == syntax::RangeKind::Full) {
+      return true;
+    }
+    const Interval lo =
+        range.lo.has_value() ? IntervalOf(*range.lo, f) : Interval{0, 0};
+    const Interval hi = range.hi.has_value() ? IntervalOf(*range.hi, f) : Interval{};
+    const bool inclusive = range.kind == syntax::RangeKind::ToInclusive ||
+                           range.kind == syntax::RangeKind::Inclusive;
+    // Interval of the exclusive end bound, when the range has one.
+    Interval end;
+    if (range.kind != syntax::RangeKind::From && hi.Bounded() &&
+        *hi.hi < kMaxTrackedBound) {
+      end = Interval{*hi.lo + (inclusive ? 1 : 0), *hi.hi + (inclusive ? 1 : 0)};
+    }
+    const auto len = LenLowerBound(check.base, f);
+    if (len.has_value()) {
+      bool ok = false;
+      switch (range.kind) {
+        case syntax::RangeKind::From:
+          ok = lo.Bounded() && *lo.hi <= *len;
+          break;
+        case syntax::RangeKind::To:
+        case syntax::RangeKind::ToInclusive:
+          ok = end.Bounded() && *end.hi <= *len;
+          break;
+        case syntax::RangeKind::Exclusive:
+        case syntax::RangeKind::Inclusive:
+          ok = lo.Bounded() && end.Bounded() && *end.hi <= *len &&
+               *lo.hi <= *end.lo;
+          break;
+        default:
+          break;
+      }
+      if (ok) {
+        return true;
+      }
+    }
+    if (SeenOrRecord({std::string("range"),
+                      std::to_string(static_cast<int>(range.kind)),
+                      Key(check.base), OptKey(range.lo), OptKey(range.hi)},
+                     f)) {
+      return true;
+    }
+    if (end.lo.has_value()) {
+      RaiseMinLen(check.base, *end.lo, f);
+    } else if (range.kind == syntax::RangeKind::From && lo.lo.has_value()) {
+      RaiseMinLen(check.base, *lo.lo, f);
+    }
+    return false;
+  }
+
+  bool VisitCheckSliceLen(const IRCheckSliceLen& check, Facts& f) {
+    ++stats_.checks;
+    return SeenOrRecord({std::string("slice_len"),
+                         std::to_string(static_cast<int>(check.range.kind)),
+                         Key(check.base), OptKey(check.range.lo),
+                         OptKey(check.range.hi), Key(check.value)},
+                        f);
+  }
+
+  bool VisitCheckOp(const IRCheckOp& check, Facts& f) {
+    ++stats_.checks;
+    if (check.rhs.has_value()) {
+      const IRValue& rhs_value = *check.rhs;
+      const auto max = OperandMax(check.lhs, rhs_value);
+      if (max.has_value()) {
+        const Interval lhs = IntervalOf(check.lhs, f);
+        const Interval rhs = IntervalOf(rhs_value, f);
+        if (check.op == "/" || check.op == "%") {
+          // rhs >= 1 rules out both a zero divisor and MIN / -1.
+          if (rhs.lo.has_value() && *rhs.lo >= 1) {
+            return true;
+          }
+        } else if (check.op == "<<" || check.op == ">>") {
+          const auto prim = IntPrimOf(TypeOf(check.lhs));
+          const unsigned bits = prim.has_value() ? prim->bits : kAnyIntBits;
+          if (rhs.Bounded() && *rhs.hi < bits) {
+            return true;
+          }
+        } else if (ProveArith(check.op, lhs, rhs, *max).has_value()) {
+          return true;
+        }
+      }
+    }
+    return SeenOrRecord({std::string("op"), check.op, Key(check.lhs),
+                         OptKey(check.rhs)},
+                        f);
+  }
+
+  void VisitIf(IRIf& node, Facts& f) {
+    const auto saved_types = local_types_;
+    Facts then_f = f;
+    AssumeCondition(node.cond, true, then_f);
+    Walk(node.then_ir, then_f);
+    local_types_ = saved_types;
+
+    Facts else_f = f;
+    AssumeCondition(node.cond, false, else_f);
+    Walk(node.else_ir, else_f);
+    local_types_ = saved_types;
+
+    const bool then_exits = Diverges(node.then_ir);
+    const bool else_exits = Diverges(node.else_ir);
+    if (else_exits && !then_exits) {
+      f = std::move(then_f);
+      KillNames(node.then_ir, true, f);
+    } else if (then_exits && !else_exits) {
+      f = std::move(else_f);
+      KillNames(node.else_ir, true, f);
+    } else {
+      KillNames(node.then_ir, false, f);
+      KillNames(node.else_ir, false, f);
+    }
+  }
+
+  void VisitLoop(const IRPtr& ir, IRLoop& node, Facts& f) {
+    Walk(node.iter_ir, f);
+    KillNames(ir, false, f);
+
+    const auto saved_types = local_types_;
+    if (node.pattern) {
+      for (const auto& name : analysis::PatNames(node.pattern)) {
+        local_types_.erase(name);
+      }
+    }
+    // Facts that survive every iteration's writes hold at the loop head.
+    Facts body_f = f;
+    Walk(node.cond_ir, body_f);
+    if (node.kind == IRLoopKind::Conditional && node.cond_value.has_value()) {
+      AssumeCondition(*node.cond_value, true, body_f);
+    }
+    Walk(node.body_ir, body_f);
+    local_types_ = saved_types;
+  }
+
+  void VisitMatch(const IRPtr& ir, IRMatch& node, Facts& f) {
+    const auto saved_types = local_types_;
+    for (auto& arm : node.arms) {
+      Facts arm_f = f;
+      if (arm.pattern) {
+        for (const auto& name : analysis::PatNames(arm.pattern)) {
+          arm_f.Kill(LocalKey(name));
+          local_types_.erase(name);
+        }
+      }
+      Walk(arm.body, arm_f);
+      local_types_ = saved_types;
+    }
+    KillNames(ir, false, f);
+  }
+};
+
+}  // namespace
+
+CheckElimStats EliminateChecks(ProcIR& proc,
+                               const LowerCtx& ctx,
+                               const syntax::ExprPtr& precondition,
+                               const IR* entry_check) {
+  CheckElim elim(ctx, entry_check ? precondition : nullptr, entry_check);
+  elim.Prepare(proc);
+  Facts facts;
+  elim.Walk(proc.body, facts);
+  const CheckElimStats stats = elim.Stats();
+  if (std::getenv("CURSIVE0_CHECK_ELIM_STATS")) {
+    std::cerr << "[cursivec0] check_elim proc=" << proc.symbol
+              << " checks=" << stats.checks << " removed=" << stats.removed
+              << " unchecked_ops=" << stats.unchecked_ops << "\n";
+  }
+  return stats;
+}
+
+}  // namespace cursive0::codegen
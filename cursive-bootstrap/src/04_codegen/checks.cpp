@@ -61,11 +61,12 @@ std::vector<std::string> PoisonSetFor(const std::string& module_path,
 
   out.reserve(n);
   for (std::size_t i = 0; i < n; ++i) {
-    if (visited[i]) {
+    // Poison-free modules never get a flag.
+    if (visited[i] && !ctx.PoisonFree(ctx.init_modules[i])) {
       out.push_back(core::StringOfPath(ctx.init_modules[i]));
     }
   }
-  if (out.empty()) {
+  if (out.empty() && !ctx.PoisonFree(module_path)) {
     out.push_back(module_path);
   }
   return out;
@@ -388,6 +389,10 @@ IRPtr PanicCheck(LowerCtx& ctx) {
 // §6.8 InitPanicHandle - module init panic handling
 IRPtr InitPanicHandle(const std::string& module_path, LowerCtx& ctx) {
   SPEC_RULE("InitPanicHandle");
+  if (ctx.PoisonFree(module_path)) {
+    // Nothing in this module's initializers can panic.
+    return EmptyIR();
+  }
   IRInitPanicHandle handle;
   handle.module = module_path;
   handle.poison_modules = PoisonSetFor(module_path, ctx);
@@ -784,6 +784,39 @@ static IRPtr EmitDropMethodCall(const analysis::TypeRef& type,
   }
   return MakeIR(std::move(call));
 }
+// Glue bodies at or below this cost are expanded at the drop site.
+constexpr std::size_t kMaxInlineDropCost = 5;
+
+// Rough size of an expanded drop: one per emitted node, with matches whose
+// arms drop nothing costing zero.
+static std::size_t DropIRCost(const IRPtr& ir) {
+  if (IsNoopIR(ir)) {
+    return 0;
+  }
+  return std::visit(
+      [&](const auto& node) -> std::size_t {
+        using T = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<T, IRSeq>) {
+          std::size_t cost = 0;
+          for (const auto& item : node.items) {
+            cost += DropIRCost(item);
+          }
+          return cost;
+        } else if constexpr (std::is_same_v<T, IRMatch>) {
+          std::size_t cost = 0;
+          for (const auto& arm : node.arms) {
+            cost += DropIRCost(arm.body);
+          }
+          return cost == 0 ? 0 : cost + 1;
+        } else if constexpr (std::is_same_v<T, IRIf>) {
+          return 1 + DropIRCost(node.then_ir) + DropIRCost(node.else_ir);
+        } else {
+          return 1;
+        }
+      },
+      ir->node);
+}
+
 // ============================================================================
 // §6.8 EmitDrop - Emit IR to drop a value of a given type
 // ============================================================================
@@ -807,6 +840,34 @@ static IRPtr EmitDropImpl(const analysis::TypeRef& type,
   }
 
   auto call_drop_glue = [&]() -> IRPtr {
+    // Trivial glue is never referenced and small glue is expanded here, so
+    // only types with a real destructor body pull in a glue procedure.
+    if (!std::getenv("CURSIVE0_NO_DROP_GLUE_PLAN")) {
+      const std::string plan_key = analysis::TypeToString(type);
+      const auto known = ctx.drop_glue_plans.find(plan_key);
+      if (known != ctx.drop_glue_plans.end() &&
+          known->second == DropGluePlan::Trivial) {
+        return EmptyIR();
+      }
+      if (known == ctx.drop_glue_plans.end() ||
+          known->second == DropGluePlan::Inline) {
+        IRPtr body = EmitDropImpl(type, value, ctx, false, panic_out);
+        const std::size_t cost = DropIRCost(body);
+        DropGluePlan plan = DropGluePlan::Call;
+        if (cost == 0) {
+          plan = DropGluePlan::Trivial;
+        } else if (cost <= kMaxInlineDropCost) {
+          plan = DropGluePlan::Inline;
+        }
+        ctx.drop_glue_plans[plan_key] = plan;
+        if (plan == DropGluePlan::Trivial) {
+          return EmptyIR();
+        }
+        if (plan == DropGluePlan::Inline) {
+          return body;
+        }
+      }
+    }
     std::string drop_sym = DropGlueSym(type, ctx);
     IRCall call;
     call.callee.kind = IRValue::Kind::Symbol;
@@ -886,9 +947,7 @@ static IRPtr EmitDropImpl(const analysis::TypeRef& type,
 
     for (std::size_t i = arr_type.length; i > 0; --i) {
       const std::size_t index = i - 1;
-      IRValue elem;
-      elem.kind = IRValue::Kind::Opaque;
-      elem.name = value.name + "[" + std::to_string(index) + "]";
+      IRValue elem = ctx.FreshTempValue("drop_elem");
       ctx.RegisterValueType(elem, arr_type.element);
       {
         DerivedValueInfo info;
@@ -910,9 +969,7 @@ static IRPtr EmitDropImpl(const analysis::TypeRef& type,
 
     for (std::size_t i = tuple_type.elements.size(); i > 0; --i) {
       const std::size_t index = i - 1;
-      IRValue elem;
-      elem.kind = IRValue::Kind::Opaque;
-      elem.name = value.name + "_" + std::to_string(index);
+      IRValue elem = ctx.FreshTempValue("drop_elem");
       ctx.RegisterValueType(elem, tuple_type.elements[index]);
       {
         DerivedValueInfo info;
@@ -949,9 +1006,7 @@ static IRPtr EmitDropImpl(const analysis::TypeRef& type,
       pattern->node = std::move(typed);
       pattern->span = core::Span{};
 
-      IRValue case_val;
-      case_val.kind = IRValue::Kind::Opaque;
-      case_val.name = value.name + "_case_" + std::to_string(i);
+      IRValue case_val = ctx.FreshTempValue("drop_case");
       ctx.RegisterValueType(case_val, uni_type.members[i]);
       {
         DerivedValueInfo info;
@@ -1017,9 +1072,7 @@ static IRPtr EmitDropImpl(const analysis::TypeRef& type,
       drops.push_back(drop_method);
     }
     for (auto rit = fields->rbegin(); rit != fields->rend(); ++rit) {
-      IRValue field_val;
-      field_val.kind = IRValue::Kind::Opaque;
-      field_val.name = value.name + "_" + rit->first;
+      IRValue field_val = ctx.FreshTempValue("drop_field");
       ctx.RegisterValueType(field_val, rit->second);
       {
         DerivedValueInfo info;
@@ -1096,9 +1149,7 @@ static IRPtr EmitDropImpl(const analysis::TypeRef& type,
                 continue;
               }
               const std::size_t index = i - 1;
-              IRValue elem;
-              elem.kind = IRValue::Kind::Opaque;
-              elem.name = value.name + "_payload_" + std::to_string(index);
+              IRValue elem = ctx.FreshTempValue("drop_payload");
               ctx.RegisterValueType(elem, *lowered);
               {
                 DerivedValueInfo info;
@@ -1120,9 +1171,7 @@ static IRPtr EmitDropImpl(const analysis::TypeRef& type,
               if (!lowered.has_value()) {
                 continue;
               }
-              IRValue field_val;
-              field_val.kind = IRValue::Kind::Opaque;
-              field_val.name = value.name + "_payload_" + field.name;
+              IRValue field_val = ctx.FreshTempValue("drop_payload");
               ctx.RegisterValueType(field_val, *lowered);
               {
                 DerivedValueInfo info;
@@ -1313,9 +1362,7 @@ IRPtr EmitDropFields(const analysis::TypeRef& type,
     //
     // Create field value representation using opaque IR value pattern
     // (consistent with EmitDrop for tuples and arrays)
-    IRValue field_val;
-    field_val.kind = IRValue::Kind::Opaque;
-    field_val.name = value.name + "." + field->name;
+    IRValue field_val = ctx.FreshTempValue("drop_field");
 
     // Lower field type from syntax::Type to analysis::TypeRef
     analysis::TypeRef field_type;
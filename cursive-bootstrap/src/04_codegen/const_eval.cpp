@@ -0,0 +1,663 @@
+#include "cursive0/04_codegen/const_eval.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "cursive0/04_codegen/globals.h"
+#include "cursive0/04_codegen/layout/layout.h"
+#include "cursive0/04_codegen/lower/lower_expr.h"
+#include "cursive0/03_analysis/resolve/scopes.h"
+
+namespace cursive0::codegen {
+
+namespace {
+
+// Larger statics keep their runtime initializer.
+constexpr std::uint64_t kMaxConstBytes = std::uint64_t{1} << 20;
+// Bound on alias chains.
+constexpr int kMaxTypeDepth = 16;
+// Bound on initializer expression nesting.
+constexpr int kMaxExprDepth = 256;
+
+using Bytes = std::vector<std::uint8_t>;
+
+struct IntType {
+  bool is_signed = false;
+  unsigned bits = 0;
+};
+
+std::optional<IntType> IntTypeOf(const analysis::TypeRef& type) {
+  const auto* prim = type ? std::get_if<analysis::TypePrim>(&type->node) : nullptr;
+  if (!prim) {
+    return std::nullopt;
+  }
+  // 128-bit integers are left to the runtime initializer.
+  static constexpr std::string_view kInts[] = {
+      "i8", "i16", "i32", "i64", "isize", "u8", "u16", "u32", "u64", "usize"};
+  for (const auto name : kInts) {
+    if (prim->name == name) {
+      const auto size = PrimSize(name);
+      if (!size.has_value()) {
+        return std::nullopt;
+      }
+      return IntType{name[0] == 'i', static_cast<unsigned>(*size * 8)};
+    }
+  }
+  return std::nullopt;
+}
+
+bool IsPrim(const analysis::TypeRef& type, std::string_view name) {
+  const auto* prim = type ? std::get_if<analysis::TypePrim>(&type->node) : nullptr;
+  return prim && prim->name == name;
+}
+
+std::uint64_t LoadLE(const Bytes& bytes) {
+  std::uint64_t value = 0;
+  for (std::size_t i = 0; i < bytes.size() && i < 8; ++i) {
+    value |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+  }
+  return value;
+}
+
+Bytes StoreLE(std::uint64_t value, std::size_t size) {
+  Bytes out(size, 0);
+  for (std::size_t i = 0; i < size && i < 8; ++i) {
+    out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+  }
+  return out;
+}
+
+std::uint64_t Mask(std::uint64_t value, unsigned bits) {
+  return bits >= 64 ? value : value & ((std::uint64_t{1} << bits) - 1);
+}
+
+std::int64_t SignExtend(std::uint64_t raw, unsigned bits) {
+  if (bits >= 64) {
+    return static_cast<std::int64_t>(raw);
+  }
+  const std::uint64_t sign = std::uint64_t{1} << (bits - 1);
+  return static_cast<std::int64_t>((Mask(raw, bits) ^ sign) - sign);
+}
+
+std::int64_t SignedMin(unsigned bits) {
+  return bits >= 64 ? std::numeric_limits<std::int64_t>::min()
+                    : -(std::int64_t{1} << (bits - 1));
+}
+
+std::int64_t SignedMax(unsigned bits) {
+  return bits >= 64 ? std::numeric_limits<std::int64_t>::max()
+                    : (std::int64_t{1} << (bits - 1)) - 1;
+}
+
+bool MulOverflows(std::int64_t a, std::int64_t b) {
+  constexpr auto kMin = std::numeric_limits<std::int64_t>::min();
+  constexpr auto kMax = std::numeric_limits<std::int64_t>::max();
+  if (a == 0 || b == 0) {
+    return false;
+  }
+  if (a > 0) {
+    return b > 0 ? a > kMax / b : b < kMin / a;
+  }
+  return b > 0 ? a < kMin / b : a < kMax / b;
+}
+
+// Mirrors the IRCheckOp/IRBinaryOp semantics: any case that would panic at
+// runtime yields nullopt.
+std::optional<std::uint64_t> SignedBinary(std::string_view op,
+                                          unsigned bits,
+                                          std::int64_t a,
+                                          std::int64_t b) {
+  constexpr auto kMin = std::numeric_limits<std::int64_t>::min();
+  constexpr auto kMax = std::numeric_limits<std::int64_t>::max();
+  std::int64_t r = 0;
+  if (op == "+") {
+    if ((b > 0 && a > kMax - b) || (b < 0 && a < kMin - b)) {
+      return std::nullopt;
+    }
+    r = a + b;
+  } else if (op == "-") {
+    if ((b < 0 && a > kMax + b) || (b > 0 && a < kMin + b)) {
+      return std::nullopt;
+    }
+    r = a - b;
+  } else if (op == "*") {
+    if (MulOverflows(a, b)) {
+      return std::nullopt;
+    }
+    r = a * b;
+  } else if (op == "/" || op == "%") {
+    if (b == 0 || (a == SignedMin(bits) && b == -1)) {
+      return std::nullopt;
+    }
+    r = op == "/" ? a / b : a % b;
+  } else {
+    return std::nullopt;
+  }
+  if (r < SignedMin(bits) || r > SignedMax(bits)) {
+    return std::nullopt;
+  }
+  return Mask(static_cast<std::uint64_t>(r), bits);
+}
+
+std::optional<std::uint64_t> UnsignedBinary(std::string_view op,
+                                            unsigned bits,
+                                            std::uint64_t a,
+                                            std::uint64_t b) {
+  std::uint64_t r = 0;
+  if (op == "+") {
+    r = a + b;
+    if (r < a) {
+      return std::nullopt;
+    }
+  } else if (op == "-") {
+    if (a < b) {
+      return std::nullopt;
+    }
+    r = a - b;
+  } else if (op == "*") {
+    if (a != 0 && b > std::numeric_limits<std::uint64_t>::max() / a) {
+      return std::nullopt;
+    }
+    r = a * b;
+  } else if (op == "/" || op == "%") {
+    if (b == 0) {
+      return std::nullopt;
+    }
+    r = op == "/" ? a / b : a % b;
+  } else {
+    return std::nullopt;
+  }
+  if (Mask(r, bits) != r) {
+    return std::nullopt;
+  }
+  return r;
+}
+
+bool ImplementsDrop(const std::vector<syntax::ClassPath>& implements) {
+  for (const auto& cls : implements) {
+    if (!cls.empty() && analysis::IdEq(cls.back(), "Drop")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+class StaticEvaluator {
+ public:
+  StaticEvaluator(const analysis::ScopeContext& scope, const LowerCtx& ctx)
+      : scope_(scope), ctx_(ctx) {}
+
+  std::optional<Bytes> Eval(const syntax::Expr& expr,
+                            const analysis::TypeRef& declared,
+                            int depth = 0) {
+    if (depth > kMaxExprDepth) {
+      return std::nullopt;
+    }
+    const analysis::TypeRef type = Plain(declared);
+    if (!type) {
+      return std::nullopt;
+    }
+    return std::visit(
+        [&](const auto& node) -> std::optional<Bytes> {
+          using T = std::decay_t<decltype(node)>;
+          if constexpr (std::is_same_v<T, syntax::LiteralExpr>) {
+            return EvalLiteral(node, type);
+          } else if constexpr (std::is_same_v<T, syntax::IdentifierExpr>) {
+            return EvalStatic(node.name, type);
+          } else if constexpr (std::is_same_v<T, syntax::UnaryExpr>) {
+            return EvalUnary(node, type, depth);
+          } else if constexpr (std::is_same_v<T, syntax::BinaryExpr>) {
+            return EvalBinary(node, type, depth);
+          } else if constexpr (std::is_same_v<T, syntax::TupleExpr>) {
+            return EvalTuple(node, type, depth);
+          } else if constexpr (std::is_same_v<T, syntax::ArrayExpr>) {
+            return EvalArray(node, type, depth);
+          } else if constexpr (std::is_same_v<T, syntax::ArrayRepeatExpr>) {
+            return EvalArrayRepeat(node, type, depth);
+          } else if constexpr (std::is_same_v<T, syntax::RecordExpr>) {
+            return EvalRecord(node, type, depth);
+          } else if constexpr (std::is_same_v<T, syntax::EnumLiteralExpr>) {
+            return EvalEnum(node, type);
+          } else {
+            return std::nullopt;
+          }
+        },
+        expr.node);
+  }
+
+ private:
+  const analysis::ScopeContext& scope_;
+  const LowerCtx& ctx_;
+
+  const analysis::TypeDecl* DeclOf(const analysis::TypePathType& path) const {
+    syntax::Path syntax_path(path.path.begin(), path.path.end());
+    const auto it = scope_.sigma.types.find(analysis::PathKeyOf(syntax_path));
+    return it == scope_.sigma.types.end() ? nullptr : &it->second;
+  }
+
+  // `type` with const permissions and aliases removed; nullptr for unique or
+  // shared values, which may be written after initialization.
+  analysis::TypeRef Plain(analysis::TypeRef type) const {
+    for (int i = 0; type && i < kMaxTypeDepth; ++i) {
+      if (const auto* perm = std::get_if<analysis::TypePerm>(&type->node)) {
+        if (perm->perm != analysis::Permission::Const) {
+          return nullptr;
+        }
+        type = perm->base;
+        continue;
+      }
+      const auto* path = std::get_if<analysis::TypePathType>(&type->node);
+      if (!path || !path->generic_args.empty()) {
+        return type;
+      }
+      const auto* decl = DeclOf(*path);
+      const auto* alias =
+          decl ? std::get_if<syntax::TypeAliasDecl>(decl) : nullptr;
+      if (!alias) {
+        return type;
+      }
+      const auto lowered = LowerTypeForLayout(scope_, alias->type);
+      if (!lowered.has_value()) {
+        return nullptr;
+      }
+      type = *lowered;
+    }
+    return nullptr;
+  }
+
+  analysis::TypeRef OperandType(const syntax::ExprPtr& expr) const {
+    if (!expr || !ctx_.expr_type) {
+      return nullptr;
+    }
+    return Plain(ctx_.expr_type(*expr));
+  }
+
+  std::optional<Bytes> EvalLiteral(const syntax::LiteralExpr& lit,
+                                   const analysis::TypeRef& type) const {
+    if (!IsPrim(type, "bool") && !IsPrim(type, "char") &&
+        !IsPrim(type, "f16") && !IsPrim(type, "f32") && !IsPrim(type, "f64") &&
+        !IntTypeOf(type).has_value()) {
+      return std::nullopt;
+    }
+    auto bytes = EncodeConst(type, lit.literal);
+    if (!bytes.has_value()) {
+      return std::nullopt;
+    }
+    if (const auto int_type = IntTypeOf(type)) {
+      // A literal is non-negative; a set sign bit means it did not fit.
+      if (int_type->is_signed &&
+          SignExtend(LoadLE(*bytes), int_type->bits) < 0) {
+        return std::nullopt;
+      }
+    }
+    return bytes;
+  }
+
+  std::optional<Bytes> EvalStatic(const std::string& name,
+                                  const analysis::TypeRef& type) const {
+    const auto it = ctx_.const_statics.find(
+        StaticSymPath(scope_.current_module, name));
+    if (it == ctx_.const_statics.end()) {
+      return std::nullopt;
+    }
+    const auto size = SizeOf(scope_, type);
+    if (!size.has_value() || *size != it->second.size()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  std::optional<Bytes> EvalUnary(const syntax::UnaryExpr& expr,
+                                 const analysis::TypeRef& type,
+                                 int depth) {
+    if (!expr.value) {
+      return std::nullopt;
+    }
+    auto operand = Eval(*expr.value, type, depth + 1);
+    if (!operand.has_value()) {
+      return std::nullopt;
+    }
+    if (expr.op == "!" && IsPrim(type, "bool")) {
+      return StoreLE(LoadLE(*operand) == 0 ? 1 : 0, 1);
+    }
+    if (expr.op == "-" &&
+        (IsPrim(type, "f16") || IsPrim(type, "f32") || IsPrim(type, "f64"))) {
+      if (operand->empty()) {
+        return std::nullopt;
+      }
+      operand->back() ^= 0x80;
+      return operand;
+    }
+    const auto int_type = IntTypeOf(type);
+    if (!int_type.has_value()) {
+      return std::nullopt;
+    }
+    const std::uint64_t raw = LoadLE(*operand);
+    if (expr.op == "~") {
+      return StoreLE(Mask(~raw, int_type->bits), operand->size());
+    }
+    if (expr.op == "-") {
+      // Lowered as 0 - x with an overflow check.
+      const auto r = int_type->is_signed
+                         ? SignedBinary("-", int_type->bits, 0,
+                                        SignExtend(raw, int_type->bits))
+                         : UnsignedBinary("-", int_type->bits, 0, raw);
+      if (!r.has_value()) {
+        return std::nullopt;
+      }
+      return StoreLE(*r, operand->size());
+    }
+    return std::nullopt;
+  }
+
+  std::optional<Bytes> EvalBinary(const syntax::BinaryExpr& expr,
+                                  const analysis::TypeRef& type,
+                                  int depth) {
+    if (!expr.lhs || !expr.rhs) {
+      return std::nullopt;
+    }
+    const std::string_view op = expr.op;
+    if (IsPrim(type, "bool")) {
+      if (op == "&&" || op == "||") {
+        const auto lhs = Eval(*expr.lhs, type, depth + 1);
+        const auto rhs = lhs ? Eval(*expr.rhs, type, depth + 1) : std::nullopt;
+        if (!rhs.has_value()) {
+          return std::nullopt;
+        }
+        const bool l = LoadLE(*lhs) != 0;
+        const bool r = LoadLE(*rhs) != 0;
+        return StoreLE(op == "&&" ? (l && r) : (l || r), 1);
+      }
+      return EvalCompare(expr, depth);
+    }
+
+    const auto int_type = IntTypeOf(type);
+    if (!int_type.has_value()) {
+      return std::nullopt;
+    }
+    const auto lhs = Eval(*expr.lhs, type, depth + 1);
+    if (!lhs.has_value()) {
+      return std::nullopt;
+    }
+    const std::size_t size = lhs->size();
+    const std::uint64_t a = LoadLE(*lhs);
+
+    if (op == "<<" || op == ">>") {
+      const auto rhs_type = OperandType(expr.rhs);
+      const auto rhs_int = IntTypeOf(rhs_type);
+      if (!rhs_int.has_value()) {
+        return std::nullopt;
+      }
+      const auto rhs = Eval(*expr.rhs, rhs_type, depth + 1);
+      if (!rhs.has_value()) {
+        return std::nullopt;
+      }
+      // The shift check compares the amount, zero-extended, against the width.
+      const std::uint64_t amount = Mask(LoadLE(*rhs), rhs_int->bits);
+      if (amount >= int_type->bits) {
+        return std::nullopt;
+      }
+      std::uint64_t r = 0;
+      if (op == "<<") {
+        r = a << amount;
+      } else if (int_type->is_signed) {
+        r = static_cast<std::uint64_t>(SignExtend(a, int_type->bits) >>
+                                       amount);
+      } else {
+        r = a >> amount;
+      }
+      return StoreLE(Mask(r, int_type->bits), size);
+    }
+
+    const auto rhs = Eval(*expr.rhs, type, depth + 1);
+    if (!rhs.has_value()) {
+      return std::nullopt;
+    }
+    const std::uint64_t b = LoadLE(*rhs);
+    if (op == "&") {
+      return StoreLE(a & b, size);
+    }
+    if (op == "|") {
+      return StoreLE(a | b, size);
+    }
+    if (op == "^") {
+      return StoreLE(a ^ b, size);
+    }
+    const auto r =
+        int_type->is_signed
+            ? SignedBinary(op, int_type->bits, SignExtend(a, int_type->bits),
+                           SignExtend(b, int_type->bits))
+            : UnsignedBinary(op, int_type->bits, a, b);
+    if (!r.has_value()) {
+      return std::nullopt;
+    }
+    return StoreLE(*r, size);
+  }
+
+  std::optional<Bytes> EvalCompare(const syntax::BinaryExpr& expr, int depth) {
+    const std::string_view op = expr.op;
+    const bool equality = op == "==" || op == "!=";
+    if (!equality && op != "<" && op != "<=" && op != ">" && op != ">=") {
+      return std::nullopt;
+    }
+    const auto operand_type = OperandType(expr.lhs);
+    const auto int_type = IntTypeOf(operand_type);
+    const bool is_char = IsPrim(operand_type, "char");
+    if (!int_type.has_value() && !is_char &&
+        !(equality && IsPrim(operand_type, "bool"))) {
+      return std::nullopt;
+    }
+    const auto lhs = Eval(*expr.lhs, operand_type, depth + 1);
+    const auto rhs = lhs ? Eval(*expr.rhs, operand_type, depth + 1)
+                         : std::nullopt;
+    if (!rhs.has_value()) {
+      return std::nullopt;
+    }
+    const std::uint64_t a = LoadLE(*lhs);
+    const std::uint64_t b = LoadLE(*rhs);
+    int cmp = 0;
+    if (int_type.has_value() && int_type->is_signed) {
+      const auto sa = SignExtend(a, int_type->bits);
+      const auto sb = SignExtend(b, int_type->bits);
+      cmp = sa < sb ? -1 : (sa > sb ? 1 : 0);
+    } else {
+      cmp = a < b ? -1 : (a > b ? 1 : 0);
+    }
+    bool result = false;
+    if (op == "==") {
+      result = cmp == 0;
+    } else if (op == "!=") {
+      result = cmp != 0;
+    } else if (op == "<") {
+      result = cmp < 0;
+    } else if (op == "<=") {
+      result = cmp <= 0;
+    } else if (op == ">") {
+      result = cmp > 0;
+    } else {
+      result = cmp >= 0;
+    }
+    return StoreLE(result ? 1 : 0, 1);
+  }
+
+  std::optional<Bytes> EvalTuple(const syntax::TupleExpr& expr,
+                                 const analysis::TypeRef& type,
+                                 int depth) {
+    if (expr.elements.empty() && IsPrim(type, "()")) {
+      return Bytes{};
+    }
+    const auto* tuple = std::get_if<analysis::TypeTuple>(&type->node);
+    if (!tuple || tuple->elements.size() != expr.elements.size()) {
+      return std::nullopt;
+    }
+    std::vector<Bytes> fields;
+    fields.reserve(expr.elements.size());
+    for (std::size_t i = 0; i < expr.elements.size(); ++i) {
+      if (!expr.elements[i]) {
+        return std::nullopt;
+      }
+      auto bytes = Eval(*expr.elements[i], tuple->elements[i], depth + 1);
+      if (!bytes.has_value()) {
+        return std::nullopt;
+      }
+      fields.push_back(std::move(*bytes));
+    }
+    return Place(fields, tuple->elements);
+  }
+
+  std::optional<Bytes> EvalArray(const syntax::ArrayExpr& expr,
+                                 const analysis::TypeRef& type,
+                                 int depth) {
+    const auto* array = std::get_if<analysis::TypeArray>(&type->node);
+    if (!array || array->length != expr.elements.size()) {
+      return std::nullopt;
+    }
+    Bytes out;
+    for (const auto& elem : expr.elements) {
+      if (!elem) {
+        return std::nullopt;
+      }
+      const auto bytes = Eval(*elem, array->element, depth + 1);
+      if (!bytes.has_value()) {
+        return std::nullopt;
+      }
+      out.insert(out.end(), bytes->begin(), bytes->end());
+    }
+    return out;
+  }
+
+  std::optional<Bytes> EvalArrayRepeat(const syntax::ArrayRepeatExpr& expr,
+                                       const analysis::TypeRef& type,
+                                       int depth) {
+    const auto* array = std::get_if<analysis::TypeArray>(&type->node);
+    if (!array || !expr.value || !expr.count) {
+      return std::nullopt;
+    }
+    // The count is fixed by the array type; it only has to be constant.
+    if (!Eval(*expr.count, OperandType(expr.count), depth + 1).has_value()) {
+      return std::nullopt;
+    }
+    const auto elem = Eval(*expr.value, array->element, depth + 1);
+    if (!elem.has_value()) {
+      return std::nullopt;
+    }
+    Bytes out;
+    out.reserve(static_cast<std::size_t>(elem->size() * array->length));
+    for (std::uint64_t i = 0; i < array->length; ++i) {
+      out.insert(out.end(), elem->begin(), elem->end());
+    }
+    return out;
+  }
+
+  std::optional<Bytes> EvalRecord(const syntax::RecordExpr& expr,
+                                  const analysis::TypeRef& type,
+                                  int depth) {
+    const auto* path = std::get_if<analysis::TypePathType>(&type->node);
+    if (!path || !path->generic_args.empty() ||
+        !std::holds_alternative<syntax::TypePath>(expr.target)) {
+      return std::nullopt;
+    }
+    const auto* decl = DeclOf(*path);
+    const auto* record =
+        decl ? std::get_if<syntax::RecordDecl>(decl) : nullptr;
+    if (!record || record->generic_params.has_value() ||
+        record->invariant.has_value() || ImplementsDrop(record->implements)) {
+      return std::nullopt;
+    }
+    std::vector<Bytes> fields;
+    std::vector<analysis::TypeRef> field_types;
+    for (const auto& member : record->members) {
+      const auto* field = std::get_if<syntax::FieldDecl>(&member);
+      if (!field) {
+        continue;
+      }
+      const syntax::FieldInit* init = nullptr;
+      for (const auto& candidate : expr.fields) {
+        if (analysis::IdEq(candidate.name, field->name)) {
+          init = &candidate;
+          break;
+        }
+      }
+      const auto field_type = LowerTypeForLayout(scope_, field->type);
+      if (!init || !init->value || !field_type.has_value()) {
+        return std::nullopt;
+      }
+      auto bytes = Eval(*init->value, *field_type, depth + 1);
+      if (!bytes.has_value()) {
+        return std::nullopt;
+      }
+      fields.push_back(std::move(*bytes));
+      field_types.push_back(*field_type);
+    }
+    if (fields.size() != expr.fields.size()) {
+      return std::nullopt;
+    }
+    return Place(fields, field_types, record);
+  }
+
+  std::optional<Bytes> EvalEnum(const syntax::EnumLiteralExpr& expr,
+                                const analysis::TypeRef& type) const {
+    const auto* path = std::get_if<analysis::TypePathType>(&type->node);
+    if (!path || !path->generic_args.empty() || expr.payload_opt.has_value() ||
+        expr.path.empty()) {
+      return std::nullopt;
+    }
+    const auto* decl = DeclOf(*path);
+    const auto* enum_decl = decl ? std::get_if<syntax::EnumDecl>(decl) : nullptr;
+    if (!enum_decl || enum_decl->generic_params.has_value() ||
+        enum_decl->invariant.has_value() ||
+        ImplementsDrop(enum_decl->implements)) {
+      return std::nullopt;
+    }
+    Value value;
+    value.node = EnumVal{expr.path.back(), std::nullopt};
+    return ValueBits(scope_, type, value);
+  }
+
+  // Fields at their record layout offsets (`record`'s when given), padding
+  // zeroed.
+  std::optional<Bytes> Place(const std::vector<Bytes>& fields,
+                             const std::vector<analysis::TypeRef>& types,
+                             const syntax::RecordDecl* record = nullptr) const {
+    const auto layout = record ? RecordDeclLayoutOf(scope_, *record, types)
+                               : RecordLayoutOf(scope_, types);
+    if (!layout.has_value() || layout->offsets.size() != fields.size()) {
+      return std::nullopt;
+    }
+    Bytes out(static_cast<std::size_t>(layout->layout.size), 0);
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+      const std::uint64_t off = layout->offsets[i];
+      if (off + fields[i].size() > out.size()) {
+        return std::nullopt;
+      }
+      std::copy(fields[i].begin(), fields[i].end(), out.begin() + off);
+    }
+    return out;
+  }
+};
+
+}  // namespace
+
+std::optional<std::vector<std::uint8_t>> ConstEvalStatic(
+    const syntax::Expr& expr,
+    const analysis::TypeRef& type,
+    const analysis::ScopeContext& scope,
+    const LowerCtx& ctx) {
+  const auto size = SizeOf(scope, type);
+  if (!size.has_value() || *size > kMaxConstBytes) {
+    return std::nullopt;
+  }
+  StaticEvaluator evaluator(scope, ctx);
+  auto bytes = evaluator.Eval(expr, type);
+  if (!bytes.has_value() || bytes->size() != *size) {
+    return std::nullopt;
+  }
+  return bytes;
+}
+
+}  // namespace cursive0::codegen
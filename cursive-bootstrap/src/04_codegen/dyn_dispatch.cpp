@@ -1,5 +1,6 @@
 #include "cursive0/04_codegen/dyn_dispatch.h"
 
+#include <set>
 #include <variant>
 
 #include "cursive0/04_codegen/checks.h"
@@ -9,6 +10,7 @@
 #include "cursive0/00_core/assert_spec.h"
 #include "cursive0/03_analysis/composite/classes.h"
 #include "cursive0/03_analysis/composite/record_methods.h"
+#include "cursive0/03_analysis/resolve/scopes.h"
 #include "cursive0/03_analysis/types/type_expr.h"
 
 namespace cursive0::codegen {
@@ -326,12 +328,84 @@ DynPackResult DynPack(const analysis::TypeRef& type,
   return result;
 }
 
+// ============================================================================
+// Devirtualization
+// ============================================================================
+
+namespace {
+
+// One pass over sigma: every type is recorded under each class it
+// implements, directly or through a superclass (ClassSubtypes).
+void BuildClassImplementors(LowerCtx& ctx) {
+  auto& index = *ctx.class_implementors;
+  index.built = true;
+  analysis::ScopeContext scope;
+  scope.sigma = *ctx.sigma;
+  scope.current_module = ctx.module_path;
+
+  for (const auto& mod : ctx.sigma->mods) {
+    for (const auto& item : mod.items) {
+      std::visit(
+          [&](const auto& decl) {
+            using T = std::decay_t<decltype(decl)>;
+            if constexpr (std::is_same_v<T, syntax::RecordDecl> ||
+                          std::is_same_v<T, syntax::EnumDecl> ||
+                          std::is_same_v<T, syntax::ModalDecl>) {
+              std::set<analysis::PathKey> classes;
+              for (const auto& impl : decl.implements) {
+                classes.insert(analysis::PathKeyOf(impl));
+                const auto lin = analysis::LinearizeClass(scope, impl);
+                if (!lin.ok) {
+                  continue;
+                }
+                for (const auto& entry : lin.order) {
+                  classes.insert(analysis::PathKeyOf(entry));
+                }
+              }
+              analysis::TypePath path = mod.path;
+              path.push_back(decl.name);
+              for (const auto& key : classes) {
+                const auto [it, inserted] = index.sole.emplace(key, path);
+                // Generic implementers have one vtable per instantiation.
+                if (!inserted || decl.generic_params.has_value()) {
+                  it->second.reset();
+                }
+              }
+            }
+          },
+          item);
+    }
+  }
+}
+
+}  // namespace
+
+std::string SoleDispatchSym(const analysis::TypePath& class_path,
+                            const syntax::ClassDecl& class_decl,
+                            const std::string& method_name,
+                            LowerCtx& ctx) {
+  if (!ctx.sigma) {
+    return "";
+  }
+  if (!ctx.class_implementors->built) {
+    BuildClassImplementors(ctx);
+  }
+  const auto& sole = ctx.class_implementors->sole;
+  const auto it = sole.find(analysis::PathKeyOf(class_path));
+  if (it == sole.end() || !it->second.has_value()) {
+    return "";
+  }
+  return DispatchSym(analysis::MakeTypePath(*it->second), class_path,
+                     method_name, class_decl, ctx);
+}
+
 // ============================================================================
 // §6.10 LowerDynCall - Dynamic dispatch call lowering
 // ============================================================================
 
 LowerResult LowerDynCall(const IRValue& base_ptr,
                          const std::string& vtable_sym,
+                         const analysis::TypePath& class_path,
                          const syntax::ClassDecl& class_decl,
                          const std::string& method_name,
                          const std::vector<IRValue>& args,
@@ -357,6 +431,7 @@ LowerResult LowerDynCall(const IRValue& base_ptr,
   call.base = base_ptr;
   call.slot = slot;
   call.args = args;
+  call.devirt_sym = SoleDispatchSym(class_path, class_decl, method_name, ctx);
 
   // Result value
   IRValue result_value = ctx.FreshTempValue("dyncall_result");
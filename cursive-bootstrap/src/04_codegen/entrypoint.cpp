@@ -223,6 +223,11 @@ void LLVMEmitter::EmitEntryPoint() {
     EmitIR(deinit_ir);
   }
 
+  // Drain buffered writes after deinit so static destructors' output lands.
+  if (llvm::Function* shutdown_fn = GetFunction(RuntimeShutdownSym())) {
+    builder->CreateCall(shutdown_fn);
+  }
+
   llvm::Value* ret = GetTempValue(ret_value);
   if (!ret) {
     ret = llvm::ConstantInt::get(int_ty, 0);
@@ -0,0 +1,287 @@
+#include "cursive0/04_codegen/escape.h"
+
+#include "cursive0/04_codegen/layout/layout.h"
+#include "cursive0/04_codegen/lower/lower_expr.h"
+#include "cursive0/03_analysis/types/type_predicates.h"
+#include "cursive0/runtime/runtime_interface.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace cursive0::codegen {
+
+namespace {
+
+// Larger allocations stay in the region to keep stack frames small.
+constexpr std::uint64_t kMaxPromotedBytes = 4096;
+
+// An IRRegion enclosing the current node.
+struct RegionFrame {
+  std::optional<std::string> alias;  // reset once a binding shadows it
+  std::size_t loop_depth = 0;        // loops open when the region was entered
+  std::string owner;                 // local holding the region value
+  bool may_reset = false;            // body may release allocations early
+};
+
+bool IsRegionType(const analysis::TypeRef& type) {
+  const auto stripped = type ? analysis::StripPerm(type) : type;
+  if (!stripped) {
+    return false;
+  }
+  if (const auto* modal = std::get_if<analysis::TypeModalState>(&stripped->node)) {
+    return modal->path.size() == 1 && analysis::IdEq(modal->path[0], "Region");
+  }
+  if (const auto* path = std::get_if<analysis::TypePathType>(&stripped->node)) {
+    return path->path.size() == 1 && analysis::IdEq(path->path[0], "Region");
+  }
+  return false;
+}
+
+class AllocPromoter {
+ public:
+  explicit AllocPromoter(const LowerCtx& ctx)
+      : ctx_(ctx),
+        reset_syms_{RegionSymMark(), RegionSymResetTo(),
+                    RegionSymResetUnchecked(), RegionSymFreeUnchecked()} {
+    if (ctx.sigma) {
+      scope_.sigma = *ctx.sigma;
+    }
+    scope_.current_module = ctx.module_path;
+  }
+
+  void Walk(const IRPtr& ir) {
+    if (!ir) {
+      return;
+    }
+    std::visit(
+        [&](auto& node) {
+          using T = std::decay_t<decltype(node)>;
+          if constexpr (std::is_same_v<T, IRSeq>) {
+            for (const auto& item : node.items) {
+              Walk(item);
+            }
+          } else if constexpr (std::is_same_v<T, IRBlock>) {
+            Walk(node.setup);
+            Walk(node.body);
+          } else if constexpr (std::is_same_v<T, IRIf>) {
+            Walk(node.then_ir);
+            Walk(node.else_ir);
+          } else if constexpr (std::is_same_v<T, IRMatch>) {
+            for (const auto& arm : node.arms) {
+              Walk(arm.body);
+            }
+          } else if constexpr (std::is_same_v<T, IRLoop>) {
+            Walk(node.iter_ir);
+            ++loop_depth_;
+            Walk(node.cond_ir);
+            Walk(node.body_ir);
+            --loop_depth_;
+          } else if constexpr (std::is_same_v<T, IRRegion>) {
+            regions_.push_back(
+                RegionFrame{node.alias, loop_depth_, node.owner.name});
+            regions_.back().may_reset = MayReset(node.body);
+            Walk(node.body);
+            regions_.pop_back();
+          } else if constexpr (std::is_same_v<T, IRFrame>) {
+            // Frames reuse the enclosing region between a mark and a
+            // reset_to, and a stack slot is never expired by the reset.
+            ++frame_depth_;
+            Walk(node.body);
+            --frame_depth_;
+          } else if constexpr (std::is_same_v<T, IRAlloc>) {
+            VisitAlloc(node);
+          } else if constexpr (std::is_same_v<T, IRBindVar>) {
+            VisitBind(node);
+          }
+          // Anything else either has no children or runs its body outside
+          // this frame (parallel, spawn, dispatch, async), so its
+          // allocations stay in the region.
+        },
+        ir->node);
+  }
+
+  EscapeStats Stats() const { return stats_; }
+
+ private:
+  const LowerCtx& ctx_;
+  analysis::ScopeContext scope_;
+  std::unordered_set<std::string> reset_syms_;
+  std::vector<RegionFrame> regions_;
+  std::size_t loop_depth_ = 0;
+  std::size_t frame_depth_ = 0;
+  EscapeStats stats_;
+
+  // Locals are matched against the open regions by name: their binding
+  // scopes are already closed, so LookupValueType only knows temps.
+  bool PassesRegion(const std::vector<IRValue>& args) const {
+    for (const auto& arg : args) {
+      if (arg.kind == IRValue::Kind::Local) {
+        for (const auto& region : regions_) {
+          if ((!region.owner.empty() && arg.name == region.owner) ||
+              (region.alias.has_value() && arg.name == *region.alias)) {
+            return true;
+          }
+        }
+        continue;
+      }
+      if (IsRegionType(ctx_.LookupValueType(arg))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Whether ir may run mark, reset_to, reset_unchecked or free_unchecked on
+  // some region: directly, through a frame or a deferred block, or by handing
+  // a region to a callee. Region allocations carry the tag of the innermost
+  // mark and expire on reset; a stack slot has no tag, so addr_is_active would
+  // keep reporting it live and a deref after the reset would not panic.
+  bool MayReset(const IRPtr& ir) const {
+    if (!ir) {
+      return false;
+    }
+    return std::visit(
+        [&](const auto& node) -> bool {
+          using T = std::decay_t<decltype(node)>;
+          if constexpr (std::is_same_v<T, IRCall>) {
+            return (node.callee.kind == IRValue::Kind::Symbol &&
+                    reset_syms_.count(node.callee.name) != 0) ||
+                   PassesRegion(node.args);
+          } else if constexpr (std::is_same_v<T, IRCallVTable>) {
+            return PassesRegion(node.args);
+          } else if constexpr (std::is_same_v<T, IRFrame> ||
+                               std::is_same_v<T, IRDefer>) {
+            return true;
+          } else if constexpr (std::is_same_v<T, IRSeq>) {
+            for (const auto& item : node.items) {
+              if (MayReset(item)) {
+                return true;
+              }
+            }
+            return false;
+          } else if constexpr (std::is_same_v<T, IRBlock>) {
+            return MayReset(node.setup) || MayReset(node.body);
+          } else if constexpr (std::is_same_v<T, IRIf>) {
+            return MayReset(node.then_ir) || MayReset(node.else_ir);
+          } else if constexpr (std::is_same_v<T, IRMatch>) {
+            for (const auto& arm : node.arms) {
+              if (MayReset(arm.body)) {
+                return true;
+              }
+            }
+            return false;
+          } else if constexpr (std::is_same_v<T, IRLoop>) {
+            return MayReset(node.iter_ir) || MayReset(node.cond_ir) ||
+                   MayReset(node.body_ir);
+          } else if constexpr (std::is_same_v<T, IRRegion> ||
+                               std::is_same_v<T, IRParallel>) {
+            return MayReset(node.body);
+          } else if constexpr (std::is_same_v<T, IRSpawn> ||
+                               std::is_same_v<T, IRDispatch>) {
+            return MayReset(node.captured_env) || MayReset(node.body);
+          } else if constexpr (std::is_same_v<T, IRPanicCheck> ||
+                               std::is_same_v<T, IRLowerPanic>) {
+            return MayReset(node.cleanup_ir);
+          } else if constexpr (std::is_same_v<T, IRSync>) {
+            return MayReset(node.wait_ir);
+          } else if constexpr (std::is_same_v<T, IRRaceReturn> ||
+                               std::is_same_v<T, IRRaceYield>) {
+            for (const auto& arm : node.arms) {
+              if (MayReset(arm.async_ir) || MayReset(arm.handler_ir)) {
+                return true;
+              }
+            }
+            return false;
+          } else if constexpr (std::is_same_v<T, IRAll>) {
+            for (const auto& item : node.async_irs) {
+              if (MayReset(item)) {
+                return true;
+              }
+            }
+            return false;
+          } else {
+            return false;
+          }
+        },
+        ir->node);
+  }
+
+  // Region the allocation goes to, if it is opened in this procedure.
+  const RegionFrame* TargetRegion(const std::optional<std::string>& alias) const {
+    if (regions_.empty()) {
+      return nullptr;
+    }
+    if (!alias.has_value()) {
+      return &regions_.back();
+    }
+    for (auto it = regions_.rbegin(); it != regions_.rend(); ++it) {
+      if (it->alias.has_value() && *it->alias == *alias) {
+        return &*it;
+      }
+    }
+    return nullptr;
+  }
+
+  bool Promotable(const std::optional<std::string>& alias,
+                  const analysis::TypeRef& type) const {
+    const RegionFrame* region = TargetRegion(alias);
+    if (!region || region->loop_depth != loop_depth_ || region->may_reset ||
+        frame_depth_ != 0 || !type) {
+      return false;
+    }
+    const auto size = SizeOf(scope_, type);
+    return size.has_value() && *size <= kMaxPromotedBytes;
+  }
+
+  void VisitAlloc(IRAlloc& alloc) {
+    ++stats_.region_allocs;
+    std::optional<std::string> alias;
+    if (alloc.region.has_value()) {
+      if (alloc.region->kind != IRValue::Kind::Local) {
+        return;
+      }
+      alias = alloc.region->name;
+    }
+    if (Promotable(alias, alloc.type)) {
+      alloc.stack = true;
+      ++stats_.promoted;
+    }
+  }
+
+  void VisitBind(IRBindVar& bind) {
+    for (auto& region : regions_) {
+      if (region.alias.has_value() && *region.alias == bind.name) {
+        region.alias.reset();
+      }
+    }
+    if (bind.prov != analysis::ProvenanceKind::Region) {
+      return;
+    }
+    ++stats_.region_allocs;
+    if (Promotable(bind.prov_region, bind.type)) {
+      bind.stack_slot = true;
+      ++stats_.promoted;
+    }
+  }
+};
+
+}  // namespace
+
+EscapeStats PromoteNonEscapingAllocs(ProcIR& proc, const LowerCtx& ctx) {
+  AllocPromoter promoter(ctx);
+  promoter.Walk(proc.body);
+  const EscapeStats stats = promoter.Stats();
+  if (std::getenv("CURSIVE0_ESCAPE_STATS")) {
+    std::cerr << "[cursivec0] escape proc=" << proc.symbol
+              << " region_allocs=" << stats.region_allocs
+              << " promoted=" << stats.promoted << "\n";
+  }
+  return stats;
+}
+
+}  // namespace cursive0::codegen
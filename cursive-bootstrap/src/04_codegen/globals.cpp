@@ -1,8 +1,10 @@
 #include "cursive0/04_codegen/globals.h"
 
+#include <cstdlib>
 #include <cstring>
 #include <variant>
 
+#include "cursive0/04_codegen/const_eval.h"
 #include "cursive0/04_codegen/mangle.h"
 #include "cursive0/04_codegen/layout/layout.h"
 #include "cursive0/00_core/symbols.h"
@@ -28,6 +30,22 @@ static std::optional<std::vector<std::uint8_t>> ConstInit(analysis::TypeRef type
   return std::nullopt;
 }
 
+// Initializer bytes for an immutable static, evaluated at compile time.
+// CURSIVE0_NO_STATIC_CONST_EVAL limits this to bare literals.
+static std::optional<std::vector<std::uint8_t>> ConstEvalInit(
+    analysis::TypeRef type,
+    const syntax::Expr& expr,
+    const analysis::ScopeContext& scope,
+    const LowerCtx& ctx) {
+  if (auto bytes = ConstInit(type, expr)) {
+    return bytes;
+  }
+  if (!type || std::getenv("CURSIVE0_NO_STATIC_CONST_EVAL") != nullptr) {
+    return std::nullopt;
+  }
+  return ConstEvalStatic(expr, type, scope, ctx);
+}
+
 // ============================================================================
 // ยง6.7 Static Name Extraction
 // ============================================================================
@@ -212,11 +230,20 @@ EmitGlobalResult EmitGlobal(const syntax::StaticDecl& item,
     }
 
     if (binding.init) {
-      if (auto bytes = ConstInit(init_type, *binding.init)) {
+      const bool immutable = item.mut == syntax::Mutability::Let;
+      auto bytes = immutable
+                       ? ConstEvalInit(init_type, *binding.init, layout_scope, ctx)
+                       : ConstInit(init_type, *binding.init);
+      if (bytes) {
         SPEC_RULE("Emit-Static-Const");
         GlobalConst gc;
         gc.symbol = sym;
         gc.bytes = std::move(*bytes);
+        if (immutable) {
+          // Nothing writes it after this: no init store, no deinit drop.
+          gc.read_only = true;
+          ctx.const_statics[StaticSymPath(module_path, *static_name)] = gc.bytes;
+        }
         result.decls.push_back(std::move(gc));
         return result;
       }
@@ -180,6 +180,11 @@ IRPtr LowerStaticInitItem(const syntax::ModulePath& module_path,
   if (!binding.init) {
     return EmptyIR();
   }
+  if (const auto name = StaticName(binding);
+      name && ctx.const_statics.count(StaticSymPath(module_path, *name))) {
+    // Emitted fully initialized by EmitGlobal.
+    return EmptyIR();
+  }
 
   std::vector<IRPtr> ir_parts;
 
@@ -270,7 +275,8 @@ IRPtr LowerStaticDeinitNames(const syntax::ModulePath& module_path,
   };
 
   for (const auto& name : names) {
-    if (!has_resp) {
+    if (!has_resp ||
+        ctx.const_statics.count(StaticSymPath(module_path, name))) {
       SPEC_RULE("Lower-StaticDeinitNames-Cons-NoResp");
       continue;
     }
@@ -32,6 +32,11 @@ struct Dumper {
     return name.substr(0, underscore);
   }
 
+  static bool IsCallResultName(const std::string& name) {
+    return name == "call_result" || name == "method_call_result" ||
+           name == "dyncall_result";
+  }
+
   static bool IsSimpleIdent(const std::string& name) {
     if (name.empty()) {
       return false;
@@ -82,18 +87,20 @@ struct Dumper {
 
   void Dump(const IRValue& v) {
     switch (v.kind) {
-      case IRValue::Kind::Opaque:
-        if (v.name.empty()) {
+      case IRValue::Kind::Opaque: {
+        const std::string name = IRValueName(v);
+        if (name.empty()) {
           oss << "opaque";
         } else {
-          auto it = display_map.find(v.name);
+          auto it = display_map.find(name);
           if (it != display_map.end()) {
             oss << it->second;
           } else {
-            oss << NormalizeOpaqueName(v.name);
+            oss << NormalizeOpaqueName(name);
           }
         }
         break;
+      }
       case IRValue::Kind::Local:
         oss << "%" << v.name;
         break;
@@ -221,8 +228,7 @@ struct Dumper {
             if (auto bind = std::get_if<IRBindVar>(&next->node)) {
               const auto& val = bind->value;
               if (val.kind == IRValue::Kind::Opaque &&
-                  (val.name == "call_result" || val.name == "method_call_result" ||
-                   val.name == "dyncall_result")) {
+                  IsCallResultName(IRValueName(val))) {
                 Indent();
                 oss << "bind %" << bind->name << " = ";
                 DumpCall(*call);
@@ -242,12 +248,12 @@ struct Dumper {
             if (auto bind = std::get_if<IRBindVar>(&next->node)) {
               const auto& val = bind->value;
               if (val.kind == IRValue::Kind::Opaque &&
-                  NormalizeOpaqueName(val.name) == "addr_of" &&
+                  NormalizeOpaqueName(IRValueName(val)) == "addr_of" &&
                   ShouldCombineAddrOf(addr->place.repr)) {
-                if (addr->result.kind == IRValue::Kind::Opaque && !addr->result.name.empty()) {
-                  display_map[addr->result.name] = "addr_of";
+                if (addr->result.kind == IRValue::Kind::Opaque && !IRValueName(addr->result).empty()) {
+                  display_map[IRValueName(addr->result)] = "addr_of";
                   if (!addr->place.repr.empty()) {
-                    addr_place[addr->result.name] = addr->place.repr;
+                    addr_place[IRValueName(addr->result)] = addr->place.repr;
                   }
                 }
                 Indent();
@@ -270,7 +276,7 @@ struct Dumper {
           if (next) {
             if (auto bind = std::get_if<IRBindVar>(&next->node)) {
               const auto& val = bind->value;
-              if (val.kind == IRValue::Kind::Opaque && val.name == "alloc_ptr") {
+              if (val.kind == IRValue::Kind::Opaque && IRValueName(val) == "alloc_ptr") {
                 Indent();
                 oss << "bind %" << bind->name << " = alloc";
                 if (alloc->region.has_value()) {
@@ -301,10 +307,10 @@ struct Dumper {
   }
 
   void DumpNode(const IRBindVar& b) {
-    if (b.value.kind == IRValue::Kind::Opaque && !b.value.name.empty()) {
-      const std::string norm = NormalizeOpaqueName(b.value.name);
+    if (b.value.kind == IRValue::Kind::Opaque && !IRValueName(b.value).empty()) {
+      const std::string norm = NormalizeOpaqueName(IRValueName(b.value));
       if (norm == "addr_of") {
-        auto it = addr_place.find(b.value.name);
+        auto it = addr_place.find(IRValueName(b.value));
         if (it != addr_place.end() && ShouldCombineAddrOf(it->second)) {
           oss << "bind %" << b.name << " = addr_of";
           if (!it->second.empty()) {
@@ -324,6 +330,9 @@ struct Dumper {
     oss << "call_vtable ";
     Dump(c.base);
     oss << " [" << c.slot << "]";
+    if (!c.devirt_sym.empty()) {
+      oss << " devirt @" << c.devirt_sym;
+    }
     if (!c.args.empty()) {
       oss << " (";
       for (std::size_t i = 0; i < c.args.size(); ++i) {
@@ -369,10 +378,10 @@ struct Dumper {
   }
 
   void DumpNode(const IRAddrOf& a) {
-    if (a.result.kind == IRValue::Kind::Opaque && !a.result.name.empty()) {
-      display_map[a.result.name] = "addr_of";
+    if (a.result.kind == IRValue::Kind::Opaque && !IRValueName(a.result).empty()) {
+      display_map[IRValueName(a.result)] = "addr_of";
       if (!a.place.repr.empty()) {
-        addr_place[a.result.name] = a.place.repr;
+        addr_place[IRValueName(a.result)] = a.place.repr;
       }
     }
     oss << "addr_of";
@@ -384,13 +393,13 @@ struct Dumper {
   void DumpNode(const IRReadPtr& r) {
     if (r.ptr.kind == IRValue::Kind::Opaque &&
         r.result.kind == IRValue::Kind::Opaque &&
-        !r.ptr.name.empty() && !r.result.name.empty()) {
-      auto it = addr_place.find(r.ptr.name);
+        !IRValueName(r.ptr).empty() && !IRValueName(r.result).empty()) {
+      auto it = addr_place.find(IRValueName(r.ptr));
       if (it != addr_place.end()) {
         if (IsSimpleIdent(it->second)) {
-          display_map[r.result.name] = "%" + it->second;
+          display_map[IRValueName(r.result)] = "%" + it->second;
         } else {
-          display_map[r.result.name] = it->second;
+          display_map[IRValueName(r.result)] = it->second;
         }
       }
     }
@@ -399,8 +408,8 @@ struct Dumper {
   }
 
   void DumpNode(const IRWritePtr& w) {
-    if (w.ptr.kind == IRValue::Kind::Opaque && !w.ptr.name.empty()) {
-      auto it = addr_place.find(w.ptr.name);
+    if (w.ptr.kind == IRValue::Kind::Opaque && !IRValueName(w.ptr).empty()) {
+      auto it = addr_place.find(IRValueName(w.ptr));
       if (it != addr_place.end()) {
         oss << "rec_update";
         if (!it->second.empty()) {
@@ -425,6 +434,9 @@ struct Dumper {
     Dump(op.lhs);
     oss << ", ";
     Dump(op.rhs);
+    if (op.unchecked) {
+      oss << " unchecked";
+    }
   }
 
   void DumpNode(const IRCast& c) {
@@ -478,6 +490,9 @@ struct Dumper {
   }
 
   void DumpNode(const IRAlloc& a) {
+    if (a.stack) {
+      oss << "stack ";
+    }
     oss << "alloc";
     if (a.region.has_value()) {
       oss << " in ";
@@ -706,6 +721,10 @@ struct Dumper {
     Dump(sync.async_value);
     oss << " -> ";
     Dump(sync.result);
+    if (sync.wait_ir) {
+      oss << " wait ";
+      Dump(sync.wait_ir);
+    }
   }
 
   // §19.3.4 Race expression (first-completion)
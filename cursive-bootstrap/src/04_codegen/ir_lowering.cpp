@@ -30,6 +30,7 @@
 #include <cstring>
 #include <iostream>
 #include <limits>
+#include <unordered_map>
 
 namespace cursive0::codegen {
 
@@ -275,7 +276,7 @@ std::optional<FieldInfo> LookupRecordField(const analysis::ScopeContext& scope,
     }
   }
 
-  auto layout = RecordLayoutOf(scope, types);
+  auto layout = RecordDeclLayoutOf(scope, *record, types);
   if (!layout.has_value()) {
     return std::nullopt;
   }
@@ -437,6 +438,32 @@ std::optional<BaseAddress> GetBaseAddress(LLVMEmitter& emitter,
   return BaseAddress{alloca, stripped};
 }
 
+// Reads a field of a by-value small aggregate with extractvalue, so the
+// aggregate stays in registers instead of being spilled by GetBaseAddress.
+llvm::Value* ExtractAggregateField(LLVMEmitter& emitter,
+                                   llvm::IRBuilder<>* builder,
+                                   const IRValue& base,
+                                   const analysis::TypeRef& base_type,
+                                   const FieldInfo& field) {
+  if (!base_type || !field.type) {
+    return nullptr;
+  }
+  llvm::Type* agg_ty = emitter.GetLLVMType(base_type);
+  if (!IsSmallScalarAggregate(agg_ty)) {
+    return nullptr;
+  }
+  const auto index = StructElementAt(emitter, agg_ty, field.offset,
+                                     emitter.GetLLVMType(field.type));
+  if (!index.has_value()) {
+    return nullptr;
+  }
+  llvm::Value* val = emitter.EvaluateIRValue(base);
+  if (!val || val->getType() != agg_ty) {
+    return nullptr;
+  }
+  return builder->CreateExtractValue(val, {*index});
+}
+
 // ExtractSlicePtr and ExtractSliceLen moved to llvm_ir_utils.cpp
 
 llvm::Value* MaterializeDerivedAddress(LLVMEmitter& emitter,
@@ -474,9 +501,8 @@ llvm::Value* MaterializeDerivedAddress(LLVMEmitter& emitter,
         if (!field_info.has_value()) {
           return nullptr;
         }
-        return field_info->offset == 0
-                   ? base.ptr
-                   : ByteGEP(emitter, builder, base.ptr, field_info->offset);
+        return FieldGEP(emitter, builder, emitter.GetLLVMType(base.type),
+                        base.ptr, field_info->offset);
       }
       return nullptr;
     }
@@ -492,9 +518,8 @@ llvm::Value* MaterializeDerivedAddress(LLVMEmitter& emitter,
         if (!field_info.has_value()) {
           return nullptr;
         }
-        return field_info->offset == 0
-                   ? base.ptr
-                   : ByteGEP(emitter, builder, base.ptr, field_info->offset);
+        return FieldGEP(emitter, builder, emitter.GetLLVMType(base.type),
+                        base.ptr, field_info->offset);
       }
       return nullptr;
     }
@@ -539,7 +564,7 @@ llvm::Value* MaterializeDerivedAddress(LLVMEmitter& emitter,
 
       llvm::Value* idx = nullptr;
       if (info.index.kind != IRValue::Kind::Opaque || !info.index.name.empty() ||
-          !info.index.bytes.empty()) {
+          info.index.id != 0 || !info.index.bytes.empty()) {
         idx = emitter.EvaluateIRValue(info.index);
         idx = AsUSize(builder, idx, emitter.GetContext());
       } else if (info.range.kind != syntax::RangeKind::Full || info.range.lo.has_value() || info.range.hi.has_value()) {
@@ -591,6 +616,17 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
   switch (info.kind) {
     case DerivedValueInfo::Kind::Field: {
       auto base_type = ctx->LookupValueType(info.base);
+      if (const auto stripped = StripPerm(base_type)) {
+        if (auto* path = std::get_if<analysis::TypePathType>(&stripped->node)) {
+          const auto field_info = LookupRecordField(scope, *path, info.field);
+          if (field_info.has_value()) {
+            if (llvm::Value* val = ExtractAggregateField(
+                    emitter, builder, info.base, stripped, *field_info)) {
+              return val;
+            }
+          }
+        }
+      }
       auto base_opt = GetBaseAddress(emitter, builder, info.base, base_type);
       if (!base_opt) {
         return nullptr;
@@ -601,15 +637,25 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
         if (!field_info.has_value()) {
           return nullptr;
         }
-        llvm::Value* addr = field_info->offset == 0
-                                ? base.ptr
-                                : ByteGEP(emitter, builder, base.ptr, field_info->offset);
+        llvm::Value* addr = FieldGEP(emitter, builder, emitter.GetLLVMType(base.type),
+                                     base.ptr, field_info->offset);
         return load_typed(addr, field_info->type);
       }
       return nullptr;
     }
     case DerivedValueInfo::Kind::Tuple: {
       auto base_type = ctx->LookupValueType(info.base);
+      if (const auto stripped = StripPerm(base_type)) {
+        if (auto* tuple = std::get_if<analysis::TypeTuple>(&stripped->node)) {
+          const auto field_info = LookupTupleField(scope, *tuple, info.tuple_index);
+          if (field_info.has_value()) {
+            if (llvm::Value* val = ExtractAggregateField(
+                    emitter, builder, info.base, stripped, *field_info)) {
+              return val;
+            }
+          }
+        }
+      }
       auto base_opt = GetBaseAddress(emitter, builder, info.base, base_type);
       if (!base_opt) {
         return nullptr;
@@ -620,9 +666,8 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
         if (!field_info.has_value()) {
           return nullptr;
         }
-        llvm::Value* addr = field_info->offset == 0
-                                ? base.ptr
-                                : ByteGEP(emitter, builder, base.ptr, field_info->offset);
+        llvm::Value* addr = FieldGEP(emitter, builder, emitter.GetLLVMType(base.type),
+                                     base.ptr, field_info->offset);
         return load_typed(addr, field_info->type);
       }
       return nullptr;
@@ -782,9 +827,9 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
       if (!enum_layout.has_value()) {
         return nullptr;
       }
-      const auto disc_type = analysis::MakeTypePrim(enum_layout->disc_type);
-      const auto disc_size = SizeOf(scope, disc_type).value_or(0);
-      const std::uint64_t payload_offset = AlignUp(disc_size, enum_layout->payload_align);
+      const std::uint64_t payload_offset =
+          enum_layout->payload_offsets[static_cast<std::size_t>(
+              variant - enum_decl->variants.data())];
 
       if (const auto* tup = std::get_if<syntax::VariantPayloadTuple>(&*variant->payload_opt)) {
         if (info.kind != DerivedValueInfo::Kind::EnumPayloadIndex) {
@@ -1020,11 +1065,7 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
         return nullptr;
       }
       llvm::Type* llvm_ty = emitter.GetLLVMType(stripped);
-      auto* alloca = CreateEntryAlloca(emitter, builder, llvm_ty, "tuple");
-      if (!alloca) {
-        return nullptr;
-      }
-      builder->CreateStore(llvm::Constant::getNullValue(llvm_ty), alloca);
+      std::vector<std::pair<std::uint64_t, llvm::Value*>> elems;
       for (std::size_t i = 0; i < info.elements.size() && i < tuple->elements.size(); ++i) {
         const auto size_opt = SizeOf(scope, tuple->elements[i]);
         if (size_opt.has_value() && *size_opt == 0) {
@@ -1034,7 +1075,18 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
         if (!elem) {
           continue;
         }
-        StoreAtOffset(emitter, builder, alloca, layout->offsets[i], elem);
+        elems.emplace_back(layout->offsets[i], elem);
+      }
+      if (llvm::Value* agg = BuildSmallAggregate(emitter, builder, llvm_ty, elems)) {
+        return agg;
+      }
+      auto* alloca = CreateEntryAlloca(emitter, builder, llvm_ty, "tuple");
+      if (!alloca) {
+        return nullptr;
+      }
+      builder->CreateStore(llvm::Constant::getNullValue(llvm_ty), alloca);
+      for (const auto& [offset, elem] : elems) {
+        StoreAtOffset(emitter, builder, alloca, offset, elem);
       }
       return builder->CreateLoad(llvm_ty, alloca);
     }
@@ -1102,6 +1154,7 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
         return nullptr;
       }
       std::optional<std::pair<std::vector<std::string>, std::vector<analysis::TypeRef>>> fields_opt;
+      const syntax::RecordDecl* record_decl = nullptr;
       if (auto* path = std::get_if<analysis::TypePathType>(&stripped->node)) {
         fields_opt = [&, path]() -> std::optional<std::pair<std::vector<std::string>, std::vector<analysis::TypeRef>>> {
           syntax::Path syntax_path;
@@ -1117,6 +1170,7 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
           if (!record) {
             return std::nullopt;
           }
+          record_decl = record;
           auto result = CollectRecordFields(scope, *record);
           // §13.1 Instantiate: Substitute type parameters in field types for generic records
           if (result.has_value() && record->generic_params.has_value() && !path->generic_args.empty()) {
@@ -1146,16 +1200,13 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
       }
       auto& names = fields_opt->first;
       auto& types = fields_opt->second;
-      auto layout = RecordLayoutOf(scope, types);
+      auto layout = record_decl ? RecordDeclLayoutOf(scope, *record_decl, types)
+                                : RecordLayoutOf(scope, types);
       if (!layout.has_value()) {
         return nullptr;
       }
       llvm::Type* llvm_ty = emitter.GetLLVMType(stripped);
-      auto* alloca = CreateEntryAlloca(emitter, builder, llvm_ty, "record");
-      if (!alloca) {
-        return nullptr;
-      }
-      builder->CreateStore(llvm::Constant::getNullValue(llvm_ty), alloca);
+      std::vector<std::pair<std::uint64_t, llvm::Value*>> field_vals;
       for (std::size_t i = 0; i < names.size(); ++i) {
         const auto size_opt = SizeOf(scope, types[i]);
         if (size_opt.has_value() && *size_opt == 0) {
@@ -1170,7 +1221,18 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
         if (!field_val) {
           continue;
         }
-        StoreAtOffset(emitter, builder, alloca, layout->offsets[i], field_val);
+        field_vals.emplace_back(layout->offsets[i], field_val);
+      }
+      if (llvm::Value* agg = BuildSmallAggregate(emitter, builder, llvm_ty, field_vals)) {
+        return agg;
+      }
+      auto* alloca = CreateEntryAlloca(emitter, builder, llvm_ty, "record");
+      if (!alloca) {
+        return nullptr;
+      }
+      builder->CreateStore(llvm::Constant::getNullValue(llvm_ty), alloca);
+      for (const auto& [offset, field_val] : field_vals) {
+        StoreAtOffset(emitter, builder, alloca, offset, field_val);
       }
       return builder->CreateLoad(llvm_ty, alloca);
     }
@@ -1274,9 +1336,7 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
       if (!enum_layout.has_value()) {
         return nullptr;
       }
-      const auto disc_type = analysis::MakeTypePrim(enum_layout->disc_type);
-      const auto disc_size = SizeOf(scope, disc_type).value_or(0);
-      const std::uint64_t payload_offset = AlignUp(disc_size, enum_layout->payload_align);
+      const std::uint64_t payload_offset = enum_layout->payload_offsets[*variant_index];
 
       llvm::Type* llvm_ty = emitter.GetLLVMType(stripped);
       auto* alloca = CreateEntryAlloca(emitter, builder, llvm_ty, "enum");
@@ -1284,10 +1344,8 @@ llvm::Value* MaterializeDerivedValue(LLVMEmitter& emitter,
         return nullptr;
       }
       builder->CreateStore(llvm::Constant::getNullValue(llvm_ty), alloca);
-
-      llvm::Type* disc_ty = emitter.GetLLVMType(disc_type);
-      llvm::Value* disc_val = llvm::ConstantInt::get(disc_ty, discs.discs[*variant_index]);
-      StoreAtOffset(emitter, builder, alloca, 0, disc_val);
+      StoreEnumTag(emitter, builder, alloca, *enum_layout, *variant_index,
+                   discs.discs[*variant_index]);
 
       const auto& variant = enum_decl->variants[*variant_index];
       if (variant.payload_opt.has_value()) {
@@ -1531,6 +1589,26 @@ void EmitReturn(LLVMEmitter& emitter, llvm::IRBuilder<>* builder) {
   builder->CreateRet(llvm::Constant::getNullValue(ret_ty));
 }
 
+// Writes the panic record through the cold out-of-line helper, keeping the
+// two stores out of the caller. Init functions also poison modules, so they
+// keep the inline form.
+void StorePanicRecordCold(LLVMEmitter& emitter,
+                          llvm::IRBuilder<>* builder,
+                          std::uint16_t code) {
+  llvm::Function* func = builder->GetInsertBlock()->getParent();
+  llvm::Function* helper =
+      IsInitFunction(emitter, func) ? nullptr : emitter.PanicRecordHelper();
+  llvm::Value* ptr = helper ? LoadPanicOutPtr(emitter, builder) : nullptr;
+  if (!ptr) {
+    StorePanicRecord(emitter, builder, code);
+    return;
+  }
+  builder->CreateCall(
+      helper,
+      {ptr, llvm::ConstantInt::get(llvm::Type::getInt32Ty(emitter.GetContext()),
+                                   code)});
+}
+
 void EmitPanicIfFalse(LLVMEmitter& emitter,
                       llvm::IRBuilder<>* builder,
                       llvm::Value* ok,
@@ -1541,10 +1619,14 @@ void EmitPanicIfFalse(LLVMEmitter& emitter,
   llvm::Function* func = builder->GetInsertBlock()->getParent();
   llvm::BasicBlock* ok_bb = llvm::BasicBlock::Create(emitter.GetContext(), "check_ok", func);
   llvm::BasicBlock* fail_bb = llvm::BasicBlock::Create(emitter.GetContext(), "check_fail", func);
-  builder->CreateCondBr(ok, ok_bb, fail_bb);
+  builder->CreateCondBr(ok, ok_bb, fail_bb, emitter.CheckBranchWeights(false));
 
   builder->SetInsertPoint(fail_bb);
-  StorePanicRecord(emitter, builder, code);
+  if (emitter.ColdPanicPaths()) {
+    StorePanicRecordCold(emitter, builder, code);
+  } else {
+    StorePanicRecord(emitter, builder, code);
+  }
   builder->CreateBr(ok_bb);
 
   builder->SetInsertPoint(ok_bb);
@@ -1559,6 +1641,12 @@ void EmitPanicReturnIfFalse(LLVMEmitter& emitter,
   }
   llvm::Function* func = builder->GetInsertBlock()->getParent();
   llvm::BasicBlock* ok_bb = llvm::BasicBlock::Create(emitter.GetContext(), "check_ok", func);
+  if (emitter.ColdPanicPaths()) {
+    builder->CreateCondBr(ok, ok_bb, emitter.PanicReturnBlock(code),
+                          emitter.CheckBranchWeights(false));
+    builder->SetInsertPoint(ok_bb);
+    return;
+  }
   llvm::BasicBlock* fail_bb = llvm::BasicBlock::Create(emitter.GetContext(), "check_fail", func);
   builder->CreateCondBr(ok, ok_bb, fail_bb);
 
@@ -1672,11 +1760,11 @@ std::vector<std::string> PoisonSetForInit(const LowerCtx& ctx) {
   std::vector<std::string> out;
   out.reserve(n);
   for (std::size_t i = 0; i < n; ++i) {
-    if (visited[i]) {
+    if (visited[i] && !ctx.PoisonFree(ctx.init_modules[i])) {
       out.push_back(core::StringOfPath(ctx.init_modules[i]));
     }
   }
-  if (out.empty()) {
+  if (out.empty() && !ctx.PoisonFree(module_name)) {
     out.push_back(module_name);
   }
   return out;
@@ -1731,6 +1819,52 @@ void StoreInitPanicRecord(LLVMEmitter& emitter,
 
 
 }  // namespace
+
+llvm::BasicBlock* LLVMEmitter::PanicReturnBlock(std::uint16_t code) {
+  auto* builder = static_cast<llvm::IRBuilder<>*>(builder_.get());
+  llvm::Function* func = builder->GetInsertBlock()->getParent();
+  const auto key = std::make_pair(func, code);
+  if (const auto it = panic_return_blocks_.find(key);
+      it != panic_return_blocks_.end()) {
+    return it->second;
+  }
+  llvm::BasicBlock* block =
+      llvm::BasicBlock::Create(context_, "panic_ret", func);
+  {
+    llvm::IRBuilderBase::InsertPointGuard guard(*builder);
+    builder->SetInsertPoint(block);
+    StorePanicRecord(*this, builder, code);
+    EmitReturn(*this, builder);
+  }
+  panic_return_blocks_.emplace(key, block);
+  return block;
+}
+
+llvm::Value* LLVMEmitter::PoisonFlagValue(llvm::GlobalVariable* flag) {
+  auto* builder = static_cast<llvm::IRBuilder<>*>(builder_.get());
+  llvm::Function* func = builder->GetInsertBlock()->getParent();
+  llvm::Type* bool_ty = flag->getValueType();
+  const auto key = std::make_pair(func, flag);
+  const auto it = poison_flag_loads_.find(key);
+  if (it == poison_flag_loads_.end()) {
+    llvm::LoadInst* load = builder->CreateLoad(bool_ty, flag);
+    poison_flag_loads_.emplace(key, load);
+    return load;
+  }
+  llvm::LoadInst* load = it->second;
+  if (load->getParent() != &func->getEntryBlock()) {
+    // Second read: hoist the load so every check in the function shares it.
+    llvm::IRBuilder<> entry_builder(&func->getEntryBlock(),
+                                    func->getEntryBlock().begin());
+    llvm::LoadInst* hoisted = entry_builder.CreateLoad(bool_ty, flag);
+    load->replaceAllUsesWith(hoisted);
+    load->eraseFromParent();
+    it->second = hoisted;
+    load = hoisted;
+  }
+  return load;
+}
+
 // T-LLVM-009: IR Operation Lowering
 
 llvm::Value* LLVMEmitter::EvaluateIRValue(const IRValue& val) {
@@ -1921,7 +2055,7 @@ static std::optional<MatchValue> MakeMatchValue(LLVMEmitter& emitter,
   if (!type) {
     if (std::getenv("CURSIVE0_DEBUG_OBJ")) {
       std::cerr << "[cursivec0] match scrutinee type missing for "
-                << value.name << "\n";
+                << IRValueName(value) << "\n";
     }
     return std::nullopt;
   }
@@ -1929,7 +2063,7 @@ static std::optional<MatchValue> MakeMatchValue(LLVMEmitter& emitter,
   if (!val) {
     if (std::getenv("CURSIVE0_DEBUG_OBJ")) {
       std::cerr << "[cursivec0] match scrutinee value missing for "
-                << value.name << "\n";
+                << IRValueName(value) << "\n";
     }
     return std::nullopt;
   }
@@ -2044,9 +2178,8 @@ static std::optional<MatchValue> RecordFieldValue(LLVMEmitter& emitter,
   if (!field_info.has_value()) {
     return std::nullopt;
   }
-  llvm::Value* addr = field_info->offset == 0
-                          ? base.addr
-                          : ByteGEP(emitter, builder, base.addr, field_info->offset);
+  llvm::Value* addr = FieldGEP(emitter, builder, emitter.GetLLVMType(base.type),
+                               base.addr, field_info->offset);
   MatchValue out;
   out.addr = addr;
   out.type = field_info->type;
@@ -2069,9 +2202,8 @@ static std::optional<MatchValue> TupleElementValue(LLVMEmitter& emitter,
   if (!field_info.has_value()) {
     return std::nullopt;
   }
-  llvm::Value* addr = field_info->offset == 0
-                          ? base.addr
-                          : ByteGEP(emitter, builder, base.addr, field_info->offset);
+  llvm::Value* addr = FieldGEP(emitter, builder, emitter.GetLLVMType(base.type),
+                               base.addr, field_info->offset);
   MatchValue out;
   out.addr = addr;
   out.type = field_info->type;
@@ -2092,9 +2224,8 @@ static std::optional<MatchValue> EnumPayloadIndexValue(LLVMEmitter& emitter,
   if (!layout.has_value()) {
     return std::nullopt;
   }
-  const auto disc_type = analysis::MakeTypePrim(layout->disc_type);
-  const auto disc_size = SizeOf(scope, disc_type).value_or(0);
-  const std::uint64_t payload_offset = AlignUp(disc_size, layout->payload_align);
+  const std::uint64_t payload_offset = layout->payload_offsets[static_cast<std::size_t>(
+      &variant - decl.variants.data())];
 
   const auto* tuple_payload =
       std::get_if<syntax::VariantPayloadTuple>(&*variant.payload_opt);
@@ -2136,9 +2267,8 @@ static std::optional<MatchValue> EnumPayloadFieldValue(LLVMEmitter& emitter,
   if (!layout.has_value()) {
     return std::nullopt;
   }
-  const auto disc_type = analysis::MakeTypePrim(layout->disc_type);
-  const auto disc_size = SizeOf(scope, disc_type).value_or(0);
-  const std::uint64_t payload_offset = AlignUp(disc_size, layout->payload_align);
+  const std::uint64_t payload_offset = layout->payload_offsets[static_cast<std::size_t>(
+      &variant - decl.variants.data())];
 
   const auto* record_payload =
       std::get_if<syntax::VariantPayloadRecord>(&*variant.payload_opt);
@@ -2254,6 +2384,170 @@ static llvm::Value* LiteralConstValue(LLVMEmitter& emitter,
   return ConstBytes(llvm_ty, *bytes, emitter, ctx);
 }
 
+// Index of the union member a typed pattern selects, either by type or by the
+// synthesized __case<N> binder name.
+static std::optional<std::size_t> UnionMemberIndex(
+    const analysis::ScopeContext& scope,
+    const UnionLayout& layout,
+    const syntax::TypedPattern& node) {
+  const auto& members = layout.member_list;
+  std::optional<std::size_t> member_index;
+  std::optional<analysis::TypeRef> target;
+  if (node.type) {
+    target = LowerTypeForLayout(scope, node.type);
+  }
+  if (target.has_value()) {
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      if (analysis::TypeEquiv(*target, members[i]).equiv) {
+        member_index = i;
+        break;
+      }
+    }
+  }
+  if (!member_index.has_value() && !node.type) {
+    constexpr std::string_view kCasePrefix = "__case";
+    if (node.name.size() > kCasePrefix.size() &&
+        node.name.rfind(kCasePrefix, 0) == 0) {
+      std::size_t idx = 0;
+      bool ok = true;
+      for (std::size_t i = kCasePrefix.size(); i < node.name.size(); ++i) {
+        char c = node.name[i];
+        if (c < '0' || c > '9') {
+          ok = false;
+          break;
+        }
+        idx = idx * 10 + static_cast<std::size_t>(c - '0');
+        if (idx >= members.size()) {
+          ok = false;
+          break;
+        }
+      }
+      if (ok) {
+        member_index = idx;
+      }
+    }
+  }
+  return member_index;
+}
+
+// Head test of a match arm that can be dispatched through a switch: the
+// pattern's outermost test compares one integer loaded from the scrutinee
+// (the enum/modal/union discriminant, or the value itself for integer and
+// char literals) against a constant.
+struct MatchSwitchKey {
+  bool whole_value = false;  // compare the scrutinee rather than its disc
+  llvm::IntegerType* type = nullptr;
+  std::uint64_t value = 0;
+};
+
+// Shortest run of switchable arms worth a switch; a single arm keeps its
+// compare-and-branch.
+constexpr std::size_t kMatchSwitchMinArms = 2;
+
+// Shape of one lowered match, printed when CURSIVE0_MATCH_STATS is set.
+struct MatchCompileStats {
+  std::size_t arms = 0;
+  std::size_t switches = 0;
+  std::size_t cases = 0;
+  std::size_t linear_tests = 0;  // arms tested by their own head compare
+};
+
+static std::optional<MatchSwitchKey> MatchSwitchKeyOf(
+    LLVMEmitter& emitter,
+    LowerCtx* ctx,
+    const analysis::ScopeContext& scope,
+    const syntax::Pattern& pat,
+    const MatchValue& scrut) {
+  if (!scrut.addr || !scrut.type) {
+    return std::nullopt;
+  }
+  auto disc_key = [&](const analysis::TypeRef& disc_type,
+                      std::uint64_t value) -> std::optional<MatchSwitchKey> {
+    auto* int_ty = llvm::dyn_cast_or_null<llvm::IntegerType>(
+        emitter.GetLLVMType(disc_type));
+    if (!int_ty) {
+      return std::nullopt;
+    }
+    MatchSwitchKey key;
+    key.type = int_ty;
+    key.value = value;
+    return key;
+  };
+
+  if (const auto* lit = std::get_if<syntax::LiteralPattern>(&pat.node)) {
+    auto* constant = llvm::dyn_cast_or_null<llvm::ConstantInt>(
+        LiteralConstValue(emitter, ctx, scrut.type, lit->literal));
+    if (!constant || constant->getBitWidth() > 64 ||
+        constant->getType() != emitter.GetLLVMType(scrut.type)) {
+      return std::nullopt;
+    }
+    MatchSwitchKey key;
+    key.whole_value = true;
+    key.type = constant->getType();
+    key.value = constant->getZExtValue();
+    return key;
+  }
+
+  if (const auto* enum_pat = std::get_if<syntax::EnumPattern>(&pat.node)) {
+    const auto* path = std::get_if<analysis::TypePathType>(&scrut.type->node);
+    const auto* enum_decl = path ? LookupEnumDecl(scope, *path) : nullptr;
+    if (!enum_decl) {
+      return std::nullopt;
+    }
+    const auto discs = analysis::EnumDiscriminants(*enum_decl);
+    if (!discs.ok || discs.discs.size() != enum_decl->variants.size()) {
+      return std::nullopt;
+    }
+    const auto layout = EnumLayoutOf(scope, *enum_decl);
+    if (!layout.has_value() || layout->niche) {
+      return std::nullopt;
+    }
+    for (std::size_t i = 0; i < enum_decl->variants.size(); ++i) {
+      if (analysis::IdEq(enum_decl->variants[i].name, enum_pat->name)) {
+        return disc_key(analysis::MakeTypePrim(layout->disc_type),
+                        discs.discs[i]);
+      }
+    }
+    return std::nullopt;
+  }
+
+  if (const auto* modal_pat = std::get_if<syntax::ModalPattern>(&pat.node)) {
+    const auto* path = std::get_if<analysis::TypePathType>(&scrut.type->node);
+    const auto* decl = path ? LookupModalDecl(scope, path->path) : nullptr;
+    if (!decl) {
+      return std::nullopt;
+    }
+    const auto layout = ModalLayoutOf(scope, *decl);
+    if (!layout.has_value() || layout->niche || !layout->disc_type.has_value()) {
+      return std::nullopt;
+    }
+    for (std::size_t i = 0; i < decl->states.size(); ++i) {
+      if (analysis::IdEq(decl->states[i].name, modal_pat->state)) {
+        return disc_key(analysis::MakeTypePrim(*layout->disc_type), i);
+      }
+    }
+    return std::nullopt;
+  }
+
+  if (const auto* typed = std::get_if<syntax::TypedPattern>(&pat.node)) {
+    const auto* uni = std::get_if<analysis::TypeUnion>(&scrut.type->node);
+    if (!uni) {
+      return std::nullopt;
+    }
+    const auto layout = UnionLayoutOf(scope, *uni);
+    if (!layout.has_value() || layout->niche || !layout->disc_type.has_value()) {
+      return std::nullopt;
+    }
+    const auto member_index = UnionMemberIndex(scope, *layout, *typed);
+    if (!member_index.has_value()) {
+      return std::nullopt;
+    }
+    return disc_key(analysis::MakeTypePrim(*layout->disc_type), *member_index);
+  }
+
+  return std::nullopt;
+}
+
 static void LowerMatchIR(LLVMEmitter& emitter,
                          llvm::IRBuilder<>* builder,
                          LowerCtx* ctx,
@@ -2300,6 +2594,18 @@ static void LowerMatchIR(LLVMEmitter& emitter,
     }
   }
 
+  // Set while emitting an arm reached through a switch case: the head test of
+  // this pattern already holds and is skipped.
+  const syntax::Pattern* known_head = nullptr;
+  auto cond_br = [&](llvm::Value* cond, llvm::BasicBlock* true_bb,
+                     llvm::BasicBlock* false_bb) {
+    if (cond) {
+      builder->CreateCondBr(cond, true_bb, false_bb);
+    } else {
+      builder->CreateBr(true_bb);
+    }
+  };
+
   auto emit_pattern = [&](const auto& self,
                           const syntax::Pattern& pat,
                           const MatchValue& value,
@@ -2331,42 +2637,7 @@ static void LowerMatchIR(LLVMEmitter& emitter,
               return;
             }
             const auto& members = layout->member_list;
-            std::optional<std::size_t> member_index;
-            std::optional<analysis::TypeRef> target;
-            if (node.type) {
-              target = LowerTypeForLayout(scope, node.type);
-            }
-            if (target.has_value()) {
-              for (std::size_t i = 0; i < members.size(); ++i) {
-                if (analysis::TypeEquiv(*target, members[i]).equiv) {
-                  member_index = i;
-                  break;
-                }
-              }
-            }
-            if (!member_index.has_value() && !node.type) {
-              constexpr std::string_view kCasePrefix = "__case";
-              if (node.name.size() > kCasePrefix.size() &&
-                  node.name.rfind(kCasePrefix, 0) == 0) {
-                std::size_t idx = 0;
-                bool ok = true;
-                for (std::size_t i = kCasePrefix.size(); i < node.name.size(); ++i) {
-                  char c = node.name[i];
-                  if (c < '0' || c > '9') {
-                    ok = false;
-                    break;
-                  }
-                  idx = idx * 10 + static_cast<std::size_t>(c - '0');
-                  if (idx >= members.size()) {
-                    ok = false;
-                    break;
-                  }
-                }
-                if (ok) {
-                  member_index = idx;
-                }
-              }
-            }
+            const auto member_index = UnionMemberIndex(scope, *layout, node);
             if (!member_index.has_value()) {
               builder->CreateBr(no_match_bb);
               return;
@@ -2400,6 +2671,10 @@ static void LowerMatchIR(LLVMEmitter& emitter,
               builder->CreateCondBr(cond, match_bb, no_match_bb);
               return;
             }
+            if (&pat == known_head) {
+              builder->CreateBr(match_bb);
+              return;
+            }
             if (!layout->disc_type.has_value()) {
               builder->CreateBr(no_match_bb);
               return;
@@ -2423,6 +2698,10 @@ static void LowerMatchIR(LLVMEmitter& emitter,
             builder->CreateCondBr(cond, match_bb, no_match_bb);
           } else if constexpr (std::is_same_v<T, syntax::LiteralPattern>) {
             SPEC_RULE("Match-Literal");
+            if (&pat == known_head) {
+              builder->CreateBr(match_bb);
+              return;
+            }
             llvm::Value* val = LoadMatchValue(emitter, builder, value);
             if (!val || !value.type) {
               builder->CreateBr(no_match_bb);
@@ -2573,26 +2852,18 @@ static void LowerMatchIR(LLVMEmitter& emitter,
               builder->CreateBr(no_match_bb);
               return;
             }
-            const auto disc_type = analysis::MakeTypePrim(layout->disc_type);
-            llvm::Type* disc_ty = emitter.GetLLVMType(disc_type);
-            llvm::Value* disc =
-                LoadAtOffset(emitter, builder, value.addr, 0, disc_ty);
-            llvm::Value* expected =
-                llvm::ConstantInt::get(disc_ty, discs.discs[*variant_index]);
-            if (disc && expected && disc->getType() != expected->getType()) {
-              if (disc->getType()->isIntegerTy() &&
-                  expected->getType()->isIntegerTy()) {
-                expected = builder->CreateIntCast(expected, disc->getType(), false);
-              } else if (disc->getType()->isPointerTy() &&
-                         expected->getType()->isPointerTy()) {
-                expected = builder->CreateBitCast(expected, disc->getType());
-              }
+            // Null when a switch case already established the variant.
+            llvm::Value* tag_match = nullptr;
+            if (&pat != known_head) {
+              tag_match = EnumTagMatches(emitter, builder, value.addr, *layout,
+                                         enum_decl->variants.size(),
+                                         *variant_index,
+                                         discs.discs[*variant_index]);
             }
-            llvm::Value* tag_match = builder->CreateICmpEQ(disc, expected);
 
             if (!variant->payload_opt.has_value()) {
               SPEC_RULE("Match-Enum-Unit");
-              builder->CreateCondBr(tag_match, match_bb, no_match_bb);
+              cond_br(tag_match, match_bb, no_match_bb);
               return;
             }
 
@@ -2611,7 +2882,7 @@ static void LowerMatchIR(LLVMEmitter& emitter,
               }
               llvm::BasicBlock* payload_bb = llvm::BasicBlock::Create(
                   emitter.GetContext(), "pat_enum_payload", func);
-              builder->CreateCondBr(tag_match, payload_bb, no_match_bb);
+              cond_br(tag_match, payload_bb, no_match_bb);
               builder->SetInsertPoint(payload_bb);
               llvm::BasicBlock* next_bb = nullptr;
               for (std::size_t i = 0; i < tuple_pat->elements.size(); ++i) {
@@ -2648,7 +2919,7 @@ static void LowerMatchIR(LLVMEmitter& emitter,
             }
             llvm::BasicBlock* payload_bb = llvm::BasicBlock::Create(
                 emitter.GetContext(), "pat_enum_payload", func);
-            builder->CreateCondBr(tag_match, payload_bb, no_match_bb);
+            cond_br(tag_match, payload_bb, no_match_bb);
             builder->SetInsertPoint(payload_bb);
             std::vector<const syntax::FieldPattern*> explicit_fields;
             for (const auto& field : record_pat->fields) {
@@ -2718,8 +2989,10 @@ static void LowerMatchIR(LLVMEmitter& emitter,
               }
             }
 
+            // Stays null for state-specific scrutinees and when a switch case
+            // already established the state.
             llvm::Value* state_cond = nullptr;
-            if (!is_state_specific) {
+            if (!is_state_specific && &pat != known_head) {
               const auto layout = ModalLayoutOf(scope, *decl);
               if (!layout.has_value()) {
                 builder->CreateBr(no_match_bb);
@@ -2805,21 +3078,13 @@ static void LowerMatchIR(LLVMEmitter& emitter,
             }
 
             if (!has_fields) {
-              if (is_state_specific) {
-                builder->CreateBr(match_bb);
-              } else {
-                builder->CreateCondBr(state_cond, match_bb, no_match_bb);
-              }
+              cond_br(state_cond, match_bb, no_match_bb);
               return;
             }
 
             llvm::BasicBlock* payload_bb = llvm::BasicBlock::Create(
                 emitter.GetContext(), "pat_modal_payload", func);
-            if (is_state_specific) {
-              builder->CreateBr(payload_bb);
-            } else {
-              builder->CreateCondBr(state_cond, payload_bb, no_match_bb);
-            }
+            cond_br(state_cond, payload_bb, no_match_bb);
             builder->SetInsertPoint(payload_bb);
 
             std::vector<const syntax::FieldPattern*> explicit_fields;
@@ -2899,23 +3164,7 @@ static void LowerMatchIR(LLVMEmitter& emitter,
         pat.node);
   };
 
-  llvm::BasicBlock* next_bb = builder->GetInsertBlock();
-  for (std::size_t i = 0; i < match.arms.size(); ++i) {
-    llvm::BasicBlock* arm_body =
-        llvm::BasicBlock::Create(emitter.GetContext(), "match_arm", func);
-    llvm::BasicBlock* arm_next =
-        (i + 1 < match.arms.size())
-            ? llvm::BasicBlock::Create(emitter.GetContext(), "match_next", func)
-            : fail_bb;
-
-    builder->SetInsertPoint(next_bb);
-    if (!match.arms[i].pattern) {
-      builder->CreateBr(arm_body);
-    } else {
-      emit_pattern(emit_pattern, *match.arms[i].pattern, scrut, arm_body,
-                   arm_next);
-    }
-
+  auto emit_arm_body = [&](std::size_t i, llvm::BasicBlock* arm_body) {
     builder->SetInsertPoint(arm_body);
     if (ctx) {
       ctx->PushScope(false, false);
@@ -2942,8 +3191,120 @@ static void LowerMatchIR(LLVMEmitter& emitter,
         incoming.push_back({arm_val, arm_end});
       }
     }
+  };
+
+  // Arms whose head test reads the same integer are mutually exclusive unless
+  // their keys are equal, so a run of such arms is dispatched with one load
+  // and one switch. Each case then tries only the arms sharing its key, in
+  // source order, and falls back to the arms after the run. Everything else
+  // is tested arm by arm.
+  const std::size_t arm_count = match.arms.size();
+  std::vector<std::optional<MatchSwitchKey>> keys(arm_count);
+  for (std::size_t i = 0; i < arm_count; ++i) {
+    if (match.arms[i].pattern) {
+      keys[i] = MatchSwitchKeyOf(emitter, ctx, scope, *match.arms[i].pattern,
+                                 scrut);
+    }
+  }
+  auto same_test = [](const MatchSwitchKey& a, const MatchSwitchKey& b) {
+    return a.whole_value == b.whole_value && a.type == b.type;
+  };
+
+  MatchCompileStats stats;
+  stats.arms = arm_count;
+  llvm::BasicBlock* next_bb = builder->GetInsertBlock();
+  std::size_t i = 0;
+  while (i < arm_count) {
+    std::size_t run_end = i;
+    if (keys[i].has_value()) {
+      run_end = i + 1;
+      while (run_end < arm_count && keys[run_end].has_value() &&
+             same_test(*keys[run_end], *keys[i])) {
+        ++run_end;
+      }
+    }
+
+    if (run_end - i >= kMatchSwitchMinArms) {
+      llvm::BasicBlock* run_next =
+          run_end < arm_count
+              ? llvm::BasicBlock::Create(emitter.GetContext(), "match_next", func)
+              : fail_bb;
+      std::vector<std::uint64_t> case_values;
+      std::unordered_map<std::uint64_t, std::vector<std::size_t>> case_arms;
+      for (std::size_t k = i; k < run_end; ++k) {
+        auto& arms_for_key = case_arms[keys[k]->value];
+        if (arms_for_key.empty()) {
+          case_values.push_back(keys[k]->value);
+        }
+        arms_for_key.push_back(k);
+      }
+
+      builder->SetInsertPoint(next_bb);
+      llvm::IntegerType* key_ty = keys[i]->type;
+      llvm::Value* switch_val =
+          keys[i]->whole_value
+              ? LoadMatchValue(emitter, builder, scrut)
+              : LoadAtOffset(emitter, builder, scrut.addr, 0, key_ty);
+      llvm::SwitchInst* sw = builder->CreateSwitch(
+          switch_val, run_next, static_cast<unsigned>(case_values.size()));
+      stats.switches += 1;
+      stats.cases += case_values.size();
+
+      for (const std::uint64_t value : case_values) {
+        llvm::BasicBlock* case_bb =
+            llvm::BasicBlock::Create(emitter.GetContext(), "match_case", func);
+        sw->addCase(llvm::ConstantInt::get(key_ty, value), case_bb);
+        const auto& arms_for_key = case_arms[value];
+        llvm::BasicBlock* test_bb = case_bb;
+        for (std::size_t n = 0; n < arms_for_key.size(); ++n) {
+          const std::size_t k = arms_for_key[n];
+          llvm::BasicBlock* arm_body =
+              llvm::BasicBlock::Create(emitter.GetContext(), "match_arm", func);
+          llvm::BasicBlock* arm_next =
+              n + 1 < arms_for_key.size()
+                  ? llvm::BasicBlock::Create(emitter.GetContext(),
+                                             "match_case_next", func)
+                  : run_next;
+          builder->SetInsertPoint(test_bb);
+          known_head = match.arms[k].pattern.get();
+          emit_pattern(emit_pattern, *match.arms[k].pattern, scrut, arm_body,
+                       arm_next);
+          known_head = nullptr;
+          emit_arm_body(k, arm_body);
+          test_bb = arm_next;
+        }
+      }
+      next_bb = run_next;
+      i = run_end;
+      continue;
+    }
+
+    llvm::BasicBlock* arm_body =
+        llvm::BasicBlock::Create(emitter.GetContext(), "match_arm", func);
+    llvm::BasicBlock* arm_next =
+        (i + 1 < arm_count)
+            ? llvm::BasicBlock::Create(emitter.GetContext(), "match_next", func)
+            : fail_bb;
+
+    builder->SetInsertPoint(next_bb);
+    if (!match.arms[i].pattern) {
+      builder->CreateBr(arm_body);
+    } else {
+      emit_pattern(emit_pattern, *match.arms[i].pattern, scrut, arm_body,
+                   arm_next);
+      stats.linear_tests += 1;
+    }
+    emit_arm_body(i, arm_body);
 
     next_bb = arm_next;
+    ++i;
+  }
+  if (std::getenv("CURSIVE0_MATCH_STATS")) {
+    std::cerr << "[cursivec0] match_stats func="
+              << (func ? func->getName().str() : "<unknown>")
+              << " arms=" << stats.arms << " switches=" << stats.switches
+              << " cases=" << stats.cases
+              << " linear_tests=" << stats.linear_tests << "\n";
   }
 
   builder->SetInsertPoint(fail_bb);
@@ -2972,7 +3333,8 @@ static void LowerMatchIR(LLVMEmitter& emitter,
               const auto it = scope.sigma.types.find(analysis::PathKeyOf(syntax_path));
               if (it != scope.sigma.types.end()) {
                 if (const auto* enum_decl = std::get_if<syntax::EnumDecl>(&it->second)) {
-                  if (const auto layout = EnumLayoutOf(scope, *enum_decl)) {
+                  const auto layout = EnumLayoutOf(scope, *enum_decl);
+                  if (layout.has_value() && !layout->niche) {
                     const auto disc_type = analysis::MakeTypePrim(layout->disc_type);
                     llvm::Type* disc_ty = emitter.GetLLVMType(disc_type);
                     disc_val = LoadAtOffset(emitter, builder, scrut.addr, 0, disc_ty);
@@ -3121,6 +3483,35 @@ struct IRVisitor {
     return builder->CreateZExt(i1, bool_ty);
   }
 
+  // Panics with InitPanic if `module` is poisoned. Returns false after
+  // reporting a codegen failure.
+  bool CheckModulePoison(const std::vector<std::string>& module) {
+    if (ctx && ctx->PoisonFree(module)) {
+      return true;
+    }
+    llvm::GlobalVariable* flag = GetOrCreatePoisonFlag(emitter, module);
+    if (!flag) {
+      SPEC_RULE("CheckPoison-Err");
+      if (ctx) {
+        ctx->ReportCodegenFailure();
+      }
+      return false;
+    }
+    llvm::Type* bool_ty = emitter.GetLLVMType(analysis::MakeTypePrim("bool"));
+    if (!bool_ty) {
+      SPEC_RULE("CheckPoison-Err");
+      if (ctx) {
+        ctx->ReportCodegenFailure();
+      }
+      return false;
+    }
+    llvm::Value* flag_val = emitter.PoisonFlagValue(flag);
+    llvm::Value* ok = builder->CreateICmpEQ(
+        flag_val, llvm::Constant::getNullValue(bool_ty));
+    EmitPanicIfFalse(emitter, builder, ok, PanicCode(PanicReason::InitPanic));
+    return true;
+  }
+
   llvm::Value* CoerceToType(llvm::Value* v, llvm::Type* target, bool is_unsigned) {
     if (!v || !target) {
       return v;
@@ -3491,22 +3882,9 @@ struct IRVisitor {
 
     if (ctx && !sym.empty()) {
       if (const auto* mod = ctx->LookupProcModule(sym)) {
-        llvm::GlobalVariable* flag = GetOrCreatePoisonFlag(emitter, *mod);
-        if (!flag) {
-          SPEC_RULE("CheckPoison-Err");
-          ctx->ReportCodegenFailure();
-          return;
-        }
-        llvm::Type* bool_ty = emitter.GetLLVMType(analysis::MakeTypePrim("bool"));
-        if (!bool_ty) {
-          SPEC_RULE("CheckPoison-Err");
-          ctx->ReportCodegenFailure();
+        if (!CheckModulePoison(*mod)) {
           return;
         }
-        llvm::Value* flag_val = builder->CreateLoad(bool_ty, flag);
-        llvm::Value* ok = builder->CreateICmpEQ(
-            flag_val, llvm::Constant::getNullValue(bool_ty));
-        EmitPanicIfFalse(emitter, builder, ok, PanicCode(PanicReason::InitPanic));
       }
     }
 
@@ -3757,6 +4135,35 @@ struct IRVisitor {
     }
   }
 
+  // Function in `slot` of the vtable carried by the dynamic value `dyn_val`,
+  // when that vtable is a constant global visible here (e.g. the value was
+  // packed in this function).
+  static llvm::Function* KnownVTableSlot(llvm::Value* dyn_val, std::size_t slot) {
+    llvm::Value* vtable = nullptr;
+    for (llvm::Value* cur = dyn_val; cur != nullptr;) {
+      if (auto* insert = llvm::dyn_cast<llvm::InsertValueInst>(cur)) {
+        if (insert->getNumIndices() == 1 && insert->getIndices()[0] == 1) {
+          vtable = insert->getInsertedValueOperand();
+          break;
+        }
+        cur = insert->getAggregateOperand();
+      } else if (auto* constant = llvm::dyn_cast<llvm::Constant>(cur)) {
+        vtable = constant->getAggregateElement(1u);
+        break;
+      } else {
+        break;
+      }
+    }
+    auto* global = vtable ? llvm::dyn_cast<llvm::GlobalVariable>(vtable->stripPointerCasts())
+                          : nullptr;
+    if (!global || !global->isConstant() || !global->hasDefinitiveInitializer()) {
+      return nullptr;
+    }
+    llvm::Constant* entry =
+        global->getInitializer()->getAggregateElement(static_cast<unsigned>(slot + 3));
+    return entry ? llvm::dyn_cast<llvm::Function>(entry->stripPointerCasts()) : nullptr;
+  }
+
   void operator()(const IRCallVTable& call) {
     SPEC_RULE("LowerIR-CallVTable");
     SPEC_RULE("Lower-CallVTable");
@@ -3771,12 +4178,6 @@ struct IRVisitor {
       return;
     }
 
-    std::uint64_t slot_index = static_cast<std::uint64_t>(call.slot + 3);
-    llvm::Value* offset = llvm::ConstantInt::get(
-        llvm::Type::getInt64Ty(emitter.GetContext()), slot_index * kPtrSize);
-    llvm::Value* slot_addr = ByteGEP(emitter, builder, vtable_ptr, offset);
-    llvm::Value* slot_fn = builder->CreateLoad(emitter.GetOpaquePtr(), slot_addr);
-
     std::vector<llvm::Value*> args;
     args.reserve(call.args.size() + 1);
     args.push_back(data_ptr);
@@ -3796,7 +4197,57 @@ struct IRVisitor {
       }
       ft = llvm::FunctionType::get(ret_ty, arg_tys, false);
     }
-    llvm::CallInst* call_inst = builder->CreateCall(ft, slot_fn, args);
+
+    llvm::Value* call_inst = nullptr;
+    if (llvm::Function* known = KnownVTableSlot(base_val, call.slot)) {
+      // The vtable is a constant we can see: call its slot directly.
+      call_inst = builder->CreateCall(ft, known, args);
+    } else {
+      std::uint64_t slot_index = static_cast<std::uint64_t>(call.slot + 3);
+      llvm::Value* offset = llvm::ConstantInt::get(
+          llvm::Type::getInt64Ty(emitter.GetContext()), slot_index * kPtrSize);
+      llvm::Value* slot_addr = ByteGEP(emitter, builder, vtable_ptr, offset);
+      llvm::LoadInst* slot_fn = builder->CreateLoad(emitter.GetOpaquePtr(), slot_addr);
+      // Vtables are immutable, so slot loads can be hoisted and CSE'd.
+      slot_fn->setMetadata(llvm::LLVMContext::MD_invariant_load,
+                           llvm::MDNode::get(emitter.GetContext(), {}));
+
+      llvm::Function* guess = nullptr;
+      if (!call.devirt_sym.empty()) {
+        guess = emitter.GetFunction(call.devirt_sym);
+        if (!guess) {
+          guess = emitter.GetModule().getFunction(call.devirt_sym);
+        }
+      }
+      if (!guess) {
+        call_inst = builder->CreateCall(ft, slot_fn, args);
+      } else {
+        // Guarded direct call to the sole implementation, indirect fallback.
+        llvm::Function* func = builder->GetInsertBlock()->getParent();
+        auto& llvm_ctx = emitter.GetContext();
+        llvm::BasicBlock* direct_bb = llvm::BasicBlock::Create(llvm_ctx, "devirt_direct", func);
+        llvm::BasicBlock* indirect_bb = llvm::BasicBlock::Create(llvm_ctx, "devirt_indirect", func);
+        llvm::BasicBlock* join_bb = llvm::BasicBlock::Create(llvm_ctx, "devirt_join", func);
+        llvm::Value* is_guess = builder->CreateICmpEQ(slot_fn, guess);
+        builder->CreateCondBr(is_guess, direct_bb, indirect_bb);
+
+        builder->SetInsertPoint(direct_bb);
+        llvm::Value* direct_result = builder->CreateCall(ft, guess, args);
+        builder->CreateBr(join_bb);
+
+        builder->SetInsertPoint(indirect_bb);
+        llvm::Value* indirect_result = builder->CreateCall(ft, slot_fn, args);
+        builder->CreateBr(join_bb);
+
+        builder->SetInsertPoint(join_bb);
+        if (!ret_ty->isVoidTy()) {
+          llvm::PHINode* phi = builder->CreatePHI(ret_ty, 2);
+          phi->addIncoming(direct_result, direct_bb);
+          phi->addIncoming(indirect_result, indirect_bb);
+          call_inst = phi;
+        }
+      }
+    }
     if (ret_ty->isVoidTy()) {
       if (ret_type) {
         StoreTemp(call.result, llvm::Constant::getNullValue(emitter.GetLLVMType(ret_type)));
@@ -4097,7 +4548,23 @@ struct IRVisitor {
     bool is_unsigned = IsUnsignedValue(op.lhs);
     llvm::Value* result = nullptr;
 
-    if (op.op == "+") {
+    if (op.unchecked && lhs->getType()->isIntegerTy() &&
+        rhs->getType()->isIntegerTy() &&
+        (op.op == "+" || op.op == "-" || op.op == "*")) {
+      // Range already proven by EliminateChecks; no overflow branch needed.
+      if (lhs->getType() != rhs->getType()) {
+        rhs = CoerceToType(rhs, lhs->getType(), is_unsigned);
+      }
+      const bool nuw = is_unsigned;
+      const bool nsw = !is_unsigned;
+      if (op.op == "+") {
+        result = builder->CreateAdd(lhs, rhs, "", nuw, nsw);
+      } else if (op.op == "-") {
+        result = builder->CreateSub(lhs, rhs, "", nuw, nsw);
+      } else {
+        result = builder->CreateMul(lhs, rhs, "", nuw, nsw);
+      }
+    } else if (op.op == "+") {
       result = emitter.EmitCheckedAdd(lhs, rhs, !is_unsigned);
     } else if (op.op == "-") {
       result = emitter.EmitCheckedSub(lhs, rhs, !is_unsigned);
@@ -4503,6 +4970,10 @@ struct IRVisitor {
   void operator()(const IRAlloc& alloc) {
     SPEC_RULE("LowerIR-Alloc");
     llvm::Value* val = emitter.EvaluateIRValue(alloc.value);
+    if (alloc.stack) {
+      EmitStackAlloc(alloc, val);
+      return;
+    }
     const IRValue* region_value = nullptr;
     if (alloc.region.has_value()) {
       region_value = &*alloc.region;
@@ -4579,6 +5050,31 @@ struct IRVisitor {
     builder->CreateStore(val, typed_ptr);
   }
 
+  // Non-escaping allocation promoted by PromoteNonEscapingAllocs.
+  void EmitStackAlloc(const IRAlloc& alloc, llvm::Value* val) {
+    analysis::TypeRef value_type = alloc.type;
+    llvm::Type* llvm_ty = value_type ? emitter.GetLLVMType(value_type) : nullptr;
+    if (!llvm_ty) {
+      if (ctx) {
+        ctx->ReportCodegenFailure();
+      }
+      return;
+    }
+    llvm::AllocaInst* slot = CreateEntryAlloca(emitter, builder, llvm_ty, "alloc_slot");
+    if (!slot) {
+      if (ctx) {
+        ctx->ReportCodegenFailure();
+      }
+      return;
+    }
+    StoreTemp(alloc.result, slot);
+    if (!val) {
+      return;
+    }
+    val = CoerceToType(val, llvm_ty, IsUnsignedValue(alloc.value));
+    builder->CreateStore(val, slot);
+  }
+
   void operator()(const IRRegion& region) {
     SPEC_RULE("LowerIR-Region");
     SPEC_RULE("Lower-RegionIR");
@@ -4691,7 +5187,8 @@ struct IRVisitor {
     llvm::Function* func = builder->GetInsertBlock()->getParent();
     llvm::BasicBlock* ok_bb = llvm::BasicBlock::Create(emitter.GetContext(), "panic_ok", func);
     llvm::BasicBlock* fail_bb = llvm::BasicBlock::Create(emitter.GetContext(), "panic_fail", func);
-    builder->CreateCondBr(is_panic, fail_bb, ok_bb);
+    builder->CreateCondBr(is_panic, fail_bb, ok_bb,
+                          emitter.CheckBranchWeights(true));
 
     builder->SetInsertPoint(fail_bb);
     if (check.cleanup_ir) {
@@ -4724,7 +5221,8 @@ struct IRVisitor {
         llvm::BasicBlock::Create(emitter.GetContext(), "init_panic", func);
     llvm::BasicBlock* ok_bb =
         llvm::BasicBlock::Create(emitter.GetContext(), "init_ok", func);
-    builder->CreateCondBr(is_panic, panic_bb, ok_bb);
+    builder->CreateCondBr(is_panic, panic_bb, ok_bb,
+                          emitter.CheckBranchWeights(true));
 
     builder->SetInsertPoint(panic_bb);
     const auto& poison = handle.poison_modules;
@@ -4772,27 +5270,7 @@ struct IRVisitor {
     SPEC_RULE("LowerIR-CheckPoison");
     SPEC_RULE("LowerIRInstr-CheckPoison");
     SPEC_RULE("CheckPoison-Use");
-    const std::vector<std::string> path = SplitModulePathString(check.module);
-    llvm::GlobalVariable* flag = GetOrCreatePoisonFlag(emitter, path);
-    if (!flag) {
-      SPEC_RULE("CheckPoison-Err");
-      if (ctx) {
-        ctx->ReportCodegenFailure();
-      }
-      return;
-    }
-    llvm::Type* bool_ty = emitter.GetLLVMType(analysis::MakeTypePrim("bool"));
-    if (!bool_ty) {
-      SPEC_RULE("CheckPoison-Err");
-      if (ctx) {
-        ctx->ReportCodegenFailure();
-      }
-      return;
-    }
-    llvm::Value* flag_val = builder->CreateLoad(bool_ty, flag);
-    llvm::Value* ok = builder->CreateICmpEQ(
-        flag_val, llvm::Constant::getNullValue(bool_ty));
-    EmitPanicIfFalse(emitter, builder, ok, PanicCode(PanicReason::InitPanic));
+    CheckModulePoison(SplitModulePathString(check.module));
   }
 
   void operator()(const IRLowerPanic& panic) {
@@ -5048,22 +5526,7 @@ struct IRVisitor {
             std::holds_alternative<syntax::RecordDecl>(it->second)) {
           SPEC_RULE("Lower-ReadPathIR-Record");
           ctx->RegisterRecordCtor(sym, record_path);
-          llvm::GlobalVariable* flag = GetOrCreatePoisonFlag(emitter, read.path);
-          if (!flag) {
-            SPEC_RULE("CheckPoison-Err");
-            ctx->ReportCodegenFailure();
-            return;
-          }
-          llvm::Type* bool_ty = emitter.GetLLVMType(analysis::MakeTypePrim("bool"));
-          if (!bool_ty) {
-            SPEC_RULE("CheckPoison-Err");
-            ctx->ReportCodegenFailure();
-            return;
-          }
-          llvm::Value* flag_val = builder->CreateLoad(bool_ty, flag);
-          llvm::Value* ok = builder->CreateICmpEQ(
-              flag_val, llvm::Constant::getNullValue(bool_ty));
-          EmitPanicIfFalse(emitter, builder, ok, PanicCode(PanicReason::InitPanic));
+          CheckModulePoison(read.path);
           return;
         }
       }
@@ -5071,43 +5534,13 @@ struct IRVisitor {
       if (ctx->LookupStaticType(sym)) {
         if (ctx->LookupStaticModule(sym)) {
           SPEC_RULE("Lower-ReadPathIR-Static-User");
-          llvm::GlobalVariable* flag = GetOrCreatePoisonFlag(emitter, read.path);
-          if (!flag) {
-            SPEC_RULE("CheckPoison-Err");
-            ctx->ReportCodegenFailure();
-            return;
-          }
-          llvm::Type* bool_ty = emitter.GetLLVMType(analysis::MakeTypePrim("bool"));
-          if (!bool_ty) {
-            SPEC_RULE("CheckPoison-Err");
-            ctx->ReportCodegenFailure();
-            return;
-          }
-          llvm::Value* flag_val = builder->CreateLoad(bool_ty, flag);
-          llvm::Value* ok = builder->CreateICmpEQ(
-              flag_val, llvm::Constant::getNullValue(bool_ty));
-          EmitPanicIfFalse(emitter, builder, ok, PanicCode(PanicReason::InitPanic));
+          CheckModulePoison(read.path);
         } else {
           SPEC_RULE("Lower-ReadPathIR-Static-Gen");
         }
       } else if (const auto* mod = ctx->LookupProcModule(sym)) {
         SPEC_RULE("Lower-ReadPathIR-Proc-User");
-        llvm::GlobalVariable* flag = GetOrCreatePoisonFlag(emitter, *mod);
-        if (!flag) {
-          SPEC_RULE("CheckPoison-Err");
-          ctx->ReportCodegenFailure();
-          return;
-        }
-        llvm::Type* bool_ty = emitter.GetLLVMType(analysis::MakeTypePrim("bool"));
-        if (!bool_ty) {
-          SPEC_RULE("CheckPoison-Err");
-          ctx->ReportCodegenFailure();
-          return;
-        }
-        llvm::Value* flag_val = builder->CreateLoad(bool_ty, flag);
-        llvm::Value* ok = builder->CreateICmpEQ(
-            flag_val, llvm::Constant::getNullValue(bool_ty));
-        EmitPanicIfFalse(emitter, builder, ok, PanicCode(PanicReason::InitPanic));
+        CheckModulePoison(*mod);
       } else if (builtin.empty() && ctx->LookupProcSig(sym)) {
         SPEC_RULE("Lower-ReadPathIR-Proc-Gen");
       }
@@ -5946,6 +6379,10 @@ struct IRVisitor {
         }
         return;
       }
+      // Reactor::run parks here until an outstanding I/O op completes.
+      if (sync.wait_ir) {
+        emitter.EmitIR(sync.wait_ir);
+      }
       llvm::Value* input_ptr = llvm::Constant::getNullValue(emitter.GetOpaquePtr());
       llvm::Value* resumed = CallAsyncResume(emitter, builder, ctx,
                                              frame_ptr, input_ptr, async_type);
@@ -376,6 +376,14 @@ void AnchorIRExecRules() {
   SPEC_RULE("MoveState-Root");
 }
 
+std::string IRValueName(const IRValue& value) {
+  if (value.id == 0 || !value.name.empty()) {
+    return value.name;
+  }
+  return std::string(value.prefix ? value.prefix : "tmp") + "_" +
+         std::to_string(value.id - 1);
+}
+
 IRPtr SeqIR(std::vector<IRPtr> items) {
   // Remove null items
   items.erase(std::remove_if(items.begin(), items.end(),
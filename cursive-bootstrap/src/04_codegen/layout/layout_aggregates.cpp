@@ -1,8 +1,10 @@
 #include "cursive0/04_codegen/layout/layout.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "cursive0/00_core/assert_spec.h"
+#include "cursive0/03_analysis/resolve/scopes.h"
 
 namespace cursive0::codegen {
 namespace {
@@ -18,6 +20,12 @@ std::uint64_t AlignUp(std::uint64_t value, std::uint64_t align) {
   return value + (align - rem);
 }
 
+// Read once: layouts are queried for every variant access.
+bool EnumNicheDisabled() {
+  static const bool disabled = std::getenv("CURSIVE0_NO_ENUM_NICHE") != nullptr;
+  return disabled;
+}
+
 std::optional<std::string> DiscTypeName(std::uint64_t max_disc) {
   if (max_disc <= 0xFFu) {
     return std::string("u8");
@@ -54,6 +62,206 @@ std::optional<RecordLayout> RangeLayoutInternal(
   return RecordLayoutOf(ctx, fields);
 }
 
+std::uint64_t MaxUnsigned(std::string_view name) {
+  if (name == "u8") {
+    return 0xFFu;
+  }
+  if (name == "u16") {
+    return 0xFFFFu;
+  }
+  if (name == "u32") {
+    return 0xFFFFFFFFu;
+  }
+  return ~std::uint64_t{0};
+}
+
+// Unused values [start, start + count) of the niche_type field at offset.
+struct Niche {
+  std::uint64_t offset = 0;
+  std::string type;
+  std::uint64_t start = 0;
+  std::uint64_t count = 0;
+};
+
+std::optional<Niche> NicheOf(const cursive0::analysis::ScopeContext& ctx,
+                             const cursive0::analysis::TypeRef& type);
+
+std::optional<Niche> FieldsNiche(
+    const cursive0::analysis::ScopeContext& ctx,
+    const std::vector<cursive0::analysis::TypeRef>& fields,
+    const std::vector<std::uint64_t>& offsets) {
+  std::optional<Niche> best;
+  for (std::size_t i = 0; i < fields.size() && i < offsets.size(); ++i) {
+    auto niche = NicheOf(ctx, fields[i]);
+    if (niche.has_value() && (!best.has_value() || niche->count > best->count)) {
+      niche->offset += offsets[i];
+      best = std::move(niche);
+    }
+  }
+  return best;
+}
+
+std::optional<Niche> NicheOf(const cursive0::analysis::ScopeContext& ctx,
+                             const cursive0::analysis::TypeRef& type) {
+  if (!type) {
+    return std::nullopt;
+  }
+  if (const auto* perm = std::get_if<cursive0::analysis::TypePerm>(&type->node)) {
+    return NicheOf(ctx, perm->base);
+  }
+  if (const auto* prim = std::get_if<cursive0::analysis::TypePrim>(&type->node)) {
+    if (prim->name == "bool") {
+      return Niche{0, "u8", 2, 0xFEu};
+    }
+    if (prim->name == "char") {
+      return Niche{0, "u32", 0x110000u, 0xFFFFFFFFu - 0x10FFFFu};
+    }
+    return std::nullopt;
+  }
+  if (const auto* ptr = std::get_if<cursive0::analysis::TypePtr>(&type->node)) {
+    if (ptr->state == cursive0::analysis::PtrState::Valid) {
+      return Niche{0, "u64", 0, 1};
+    }
+    return std::nullopt;
+  }
+  if (const auto* tuple = std::get_if<cursive0::analysis::TypeTuple>(&type->node)) {
+    const auto layout = RecordLayoutOf(ctx, tuple->elements);
+    if (!layout.has_value()) {
+      return std::nullopt;
+    }
+    return FieldsNiche(ctx, tuple->elements, layout->offsets);
+  }
+  if (const auto* array = std::get_if<cursive0::analysis::TypeArray>(&type->node)) {
+    if (array->length == 0) {
+      return std::nullopt;
+    }
+    return NicheOf(ctx, array->element);
+  }
+  const auto* path = std::get_if<cursive0::analysis::TypePathType>(&type->node);
+  if (!path) {
+    return std::nullopt;
+  }
+  cursive0::syntax::Path syntax_path(path->path.begin(), path->path.end());
+  const auto it = ctx.sigma.types.find(cursive0::analysis::PathKeyOf(syntax_path));
+  if (it == ctx.sigma.types.end()) {
+    return std::nullopt;
+  }
+  if (const auto* record = std::get_if<cursive0::syntax::RecordDecl>(&it->second)) {
+    std::vector<cursive0::analysis::TypeRef> fields;
+    for (const auto& member : record->members) {
+      if (const auto* field = std::get_if<cursive0::syntax::FieldDecl>(&member)) {
+        const auto lowered = LowerTypeForLayout(ctx, field->type);
+        if (!lowered.has_value()) {
+          return std::nullopt;
+        }
+        fields.push_back(*lowered);
+      }
+    }
+    const auto layout = RecordDeclLayoutOf(ctx, *record, fields);
+    if (!layout.has_value()) {
+      return std::nullopt;
+    }
+    return FieldsNiche(ctx, fields, layout->offsets);
+  }
+  if (const auto* enum_decl = std::get_if<cursive0::syntax::EnumDecl>(&it->second)) {
+    const auto layout = EnumLayoutOf(ctx, *enum_decl);
+    if (!layout.has_value()) {
+      return std::nullopt;
+    }
+    if (layout->niche) {
+      // What the other variants left of the niche they were placed in.
+      const std::uint64_t used = enum_decl->variants.size() - 1;
+      if (layout->niche_count <= used) {
+        return std::nullopt;
+      }
+      return Niche{layout->niche_offset, layout->niche_type,
+                   layout->niche_start + used, layout->niche_count - used};
+    }
+    const auto discs = cursive0::analysis::EnumDiscriminants(*enum_decl);
+    const auto max = MaxUnsigned(layout->disc_type);
+    if (!discs.ok || discs.max_disc >= max) {
+      return std::nullopt;
+    }
+    return Niche{0, layout->disc_type, discs.max_disc + 1, max - discs.max_disc};
+  }
+  if (const auto* alias = std::get_if<cursive0::syntax::TypeAliasDecl>(&it->second)) {
+    if (alias->generic_params && !alias->generic_params->params.empty()) {
+      return std::nullopt;
+    }
+    const auto lowered = LowerTypeForLayout(ctx, alias->type);
+    if (!lowered.has_value()) {
+      return std::nullopt;
+    }
+    return NicheOf(ctx, *lowered);
+  }
+  return std::nullopt;
+}
+
+// Layout-Enum-Niche: the variant with the largest payload is stored as is,
+// and the others are told apart by values its payload can never hold. Only
+// source enums with implicit discriminants and no layout attributes qualify.
+std::optional<EnumLayout> NicheLayoutOf(
+    const cursive0::analysis::ScopeContext& ctx,
+    const cursive0::syntax::EnumDecl& decl,
+    const std::vector<std::vector<cursive0::analysis::TypeRef>>& payload_types,
+    const std::vector<RecordLayout>& payloads) {
+  if (decl.variants.size() < 2 || KeepsDeclaredLayout(decl.attrs, decl.span) ||
+      EnumNicheDisabled()) {
+    return std::nullopt;
+  }
+  for (const auto& variant : decl.variants) {
+    if (variant.discriminant_opt.has_value()) {
+      return std::nullopt;
+    }
+  }
+
+  std::size_t dataful = 0;
+  for (std::size_t i = 1; i < payloads.size(); ++i) {
+    if (payloads[i].layout.size > payloads[dataful].layout.size) {
+      dataful = i;
+    }
+  }
+  if (payloads[dataful].layout.size == 0) {
+    return std::nullopt;
+  }
+  const auto niche =
+      FieldsNiche(ctx, payload_types[dataful], payloads[dataful].offsets);
+  if (!niche.has_value() || niche->count < decl.variants.size() - 1) {
+    return std::nullopt;
+  }
+  const auto niche_size = PrimSize(niche->type);
+  if (!niche_size.has_value()) {
+    return std::nullopt;
+  }
+
+  // Other payloads go before the niche field when they fit, else after it.
+  EnumLayout out;
+  out.payload_offsets.assign(payloads.size(), 0);
+  std::uint64_t end = payloads[dataful].layout.size;
+  std::uint64_t align = 1;
+  for (std::size_t i = 0; i < payloads.size(); ++i) {
+    const auto& layout = payloads[i].layout;
+    out.payload_size = std::max(out.payload_size, layout.size);
+    align = std::max(align, layout.align);
+    if (i == dataful || layout.size <= niche->offset) {
+      continue;
+    }
+    const std::uint64_t offset = AlignUp(niche->offset + *niche_size, layout.align);
+    out.payload_offsets[i] = offset;
+    end = std::max(end, offset + layout.size);
+  }
+
+  out.layout = Layout{AlignUp(end, align), align};
+  out.payload_align = align;
+  out.niche = true;
+  out.niche_variant = dataful;
+  out.niche_offset = niche->offset;
+  out.niche_type = niche->type;
+  out.niche_start = niche->start;
+  out.niche_count = niche->count;
+  return out;
+}
+
 }  // namespace
 
 std::optional<RecordLayout> RangeLayoutOf(
@@ -79,28 +287,31 @@ std::optional<EnumLayout> EnumLayoutOf(
 
   std::uint64_t payload_size = 0;
   std::uint64_t payload_align = 1;
+  std::vector<std::vector<cursive0::analysis::TypeRef>> payload_types;
+  std::vector<RecordLayout> payloads;
+  payload_types.reserve(decl.variants.size());
+  payloads.reserve(decl.variants.size());
 
   for (const auto& variant : decl.variants) {
     std::optional<RecordLayout> layout;
+    std::vector<cursive0::analysis::TypeRef> fields;
     if (!variant.payload_opt.has_value()) {
       layout = RecordLayout{Layout{0, 1}, {}};
     } else if (const auto* tuple =
                    std::get_if<cursive0::syntax::VariantPayloadTuple>(
                        &*variant.payload_opt)) {
-      std::vector<cursive0::analysis::TypeRef> elems;
-      elems.reserve(tuple->elements.size());
+      fields.reserve(tuple->elements.size());
       for (const auto& elem : tuple->elements) {
         const auto lowered = LowerTypeForLayout(ctx, elem);
         if (!lowered.has_value()) {
           return std::nullopt;
         }
-        elems.push_back(*lowered);
+        fields.push_back(*lowered);
       }
-      layout = RecordLayoutOf(ctx, elems);
+      layout = RecordLayoutOf(ctx, fields);
     } else if (const auto* rec =
                    std::get_if<cursive0::syntax::VariantPayloadRecord>(
                        &*variant.payload_opt)) {
-      std::vector<cursive0::analysis::TypeRef> fields;
       fields.reserve(rec->fields.size());
       for (const auto& field : rec->fields) {
         const auto lowered = LowerTypeForLayout(ctx, field.type);
@@ -117,6 +328,18 @@ std::optional<EnumLayout> EnumLayoutOf(
     }
     payload_size = std::max(payload_size, layout->layout.size);
     payload_align = std::max(payload_align, layout->layout.align);
+    payload_types.push_back(std::move(fields));
+    payloads.push_back(std::move(*layout));
+  }
+
+  if (auto niche = NicheLayoutOf(ctx, decl, payload_types, payloads)) {
+    const std::uint64_t tagged_size =
+        AlignUp(disc_layout->size + payload_size,
+                std::max(disc_layout->align, payload_align));
+    if (niche->layout.size < tagged_size) {
+      SPEC_RULE("Layout-Enum-Niche");
+      return niche;
+    }
   }
 
   SPEC_RULE("Layout-Enum-Tagged");
@@ -129,7 +352,25 @@ std::optional<EnumLayout> EnumLayoutOf(
   out.disc_type = *DiscTypeName(discs.max_disc);
   out.payload_size = payload_size;
   out.payload_align = payload_align;
+  out.payload_offsets.assign(decl.variants.size(),
+                             AlignUp(disc_layout->size, payload_align));
   return out;
 }
 
+std::uint64_t EnumNicheValue(const EnumLayout& layout, std::size_t variant) {
+  const std::size_t rank =
+      variant < layout.niche_variant ? variant : variant - 1;
+  return layout.niche_start + rank;
+}
+
+std::size_t EnumVariantOfNiche(const EnumLayout& layout,
+                               std::size_t variant_count,
+                               std::uint64_t value) {
+  const std::uint64_t rank = value - layout.niche_start;
+  if (variant_count == 0 || rank >= variant_count - 1) {
+    return layout.niche_variant;
+  }
+  return rank < layout.niche_variant ? rank : rank + 1;
+}
+
 }  // namespace cursive0::codegen
@@ -608,7 +608,7 @@ std::optional<Layout> LayoutOf(const cursive0::analysis::ScopeContext& ctx,
           fields.push_back(*lowered);
         }
       }
-      const auto layout = RecordLayoutOf(ctx, fields);
+      const auto layout = RecordDeclLayoutOf(ctx, *record, fields);
       if (!layout.has_value()) {
         return std::nullopt;
       }
@@ -1,8 +1,11 @@
 #include "cursive0/04_codegen/layout/layout.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <numeric>
 
 #include "cursive0/00_core/assert_spec.h"
+#include "cursive0/03_analysis/resolve/scopes.h"
 
 namespace cursive0::codegen {
 namespace {
@@ -18,8 +21,83 @@ std::uint64_t AlignUp(std::uint64_t value, std::uint64_t align) {
   return value + (align - rem);
 }
 
+// Read once: layouts are queried for every field access.
+bool FieldReorderDisabled() {
+  static const bool disabled =
+      std::getenv("CURSIVE0_NO_FIELD_REORDER") != nullptr;
+  return disabled;
+}
+
+bool IsFfiSafeClass(const cursive0::syntax::ClassPath& path) {
+  return !path.empty() && cursive0::analysis::IdEq(path.back(), "FfiSafe");
+}
+
 }  // namespace
 
+bool KeepsDeclaredLayout(const cursive0::syntax::AttributeList& attrs,
+                         const cursive0::core::Span& span) {
+  // Built-in declarations have no source file; the runtime shares them.
+  if (span.file.empty()) {
+    return true;
+  }
+  for (const auto& attr : attrs) {
+    if (cursive0::analysis::IdEq(attr.name, "layout") ||
+        cursive0::analysis::IdEq(attr.name, "packed") ||
+        cursive0::analysis::IdEq(attr.name, "align") ||
+        cursive0::analysis::IdEq(attr.name, "ffi_pass_by_value")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::optional<RecordLayout> RecordDeclLayoutOf(
+    const cursive0::analysis::ScopeContext& ctx,
+    const cursive0::syntax::RecordDecl& decl,
+    const std::vector<cursive0::analysis::TypeRef>& fields) {
+  const bool keep_order =
+      KeepsDeclaredLayout(decl.attrs, decl.span) ||
+      std::any_of(decl.implements.begin(), decl.implements.end(),
+                  IsFfiSafeClass) ||
+      FieldReorderDisabled();
+  auto declared = RecordLayoutOf(ctx, fields);
+  if (keep_order || !declared.has_value() || fields.size() < 2) {
+    return declared;
+  }
+
+  std::vector<std::uint64_t> aligns;
+  aligns.reserve(fields.size());
+  for (const auto& field : fields) {
+    aligns.push_back(AlignOf(ctx, field).value_or(1));
+  }
+  // Decreasing alignment leaves no padding between fields; ties keep
+  // declaration order. The order is only used when it saves space.
+  std::vector<std::size_t> order(fields.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t lhs, std::size_t rhs) {
+                     return aligns[lhs] > aligns[rhs];
+                   });
+
+  std::vector<cursive0::analysis::TypeRef> placed;
+  placed.reserve(fields.size());
+  for (const auto index : order) {
+    placed.push_back(fields[index]);
+  }
+  const auto packed = RecordLayoutOf(ctx, placed);
+  if (!packed.has_value() || packed->layout.size >= declared->layout.size) {
+    return declared;
+  }
+  SPEC_RULE("Layout-Record-Reordered");
+  RecordLayout out;
+  out.layout = packed->layout;
+  out.offsets.resize(fields.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    out.offsets[order[i]] = packed->offsets[i];
+  }
+  return out;
+}
+
 std::optional<RecordLayout> RecordLayoutOf(
     const cursive0::analysis::ScopeContext& ctx,
     const std::vector<cursive0::analysis::TypeRef>& fields) {
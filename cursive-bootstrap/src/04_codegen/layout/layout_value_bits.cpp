@@ -642,6 +642,33 @@ std::vector<std::uint8_t> PadBytes(const std::vector<std::uint8_t>& bytes,
   return out;
 }
 
+// Layout-Enum-Niche value of variant `index`: its payload at its offset,
+// then its niche value unless it is the niche variant.
+std::optional<std::vector<std::uint8_t>> NicheEnumBits(
+    const EnumLayout& layout,
+    std::size_t index,
+    const std::vector<std::uint8_t>& payload_bits) {
+  const std::uint64_t offset = layout.payload_offsets[index];
+  if (offset + payload_bits.size() > layout.layout.size) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> out(layout.layout.size, 0);
+  std::copy(payload_bits.begin(), payload_bits.end(), out.begin() + offset);
+  if (index == layout.niche_variant) {
+    return out;
+  }
+  const auto niche_size = PrimSize(layout.niche_type);
+  if (!niche_size.has_value() ||
+      layout.niche_offset + *niche_size > out.size()) {
+    return std::nullopt;
+  }
+  const auto niche_bits =
+      LEBytesU64(EnumNicheValue(layout, index), *niche_size);
+  std::copy(niche_bits.begin(), niche_bits.end(),
+            out.begin() + layout.niche_offset);
+  return out;
+}
+
 std::optional<std::vector<std::uint8_t>> TaggedBits(
     const std::vector<std::uint8_t>& disc_bits,
     const std::vector<std::uint8_t>& payload_bits,
@@ -784,10 +811,13 @@ std::optional<std::vector<std::pair<std::string, cursive0::analysis::TypeRef>>>
   return fields;
 }
 
+// `record` is the declaration the fields come from, if any; its layout may
+// reorder them.
 std::optional<std::vector<std::uint8_t>> ValueBitsForRecord(
     const cursive0::analysis::ScopeContext& ctx,
     const std::vector<std::pair<std::string, cursive0::analysis::TypeRef>>& fields,
-    const RecordVal& val) {
+    const RecordVal& val,
+    const cursive0::syntax::RecordDecl* record = nullptr) {
   std::vector<std::vector<std::uint8_t>> bits;
   std::vector<cursive0::analysis::TypeRef> types;
   bits.reserve(fields.size());
@@ -810,7 +840,8 @@ std::optional<std::vector<std::uint8_t>> ValueBitsForRecord(
     types.push_back(field.second);
   }
 
-  const auto layout = RecordLayoutOf(ctx, types);
+  const auto layout = record ? RecordDeclLayoutOf(ctx, *record, types)
+                             : RecordLayoutOf(ctx, types);
   if (!layout.has_value()) {
     return std::nullopt;
   }
@@ -1165,6 +1196,14 @@ bool ValidTaggedPayloadBits(const cursive0::analysis::ScopeContext& ctx,
   return ValidValue(ctx, type, *prefix);
 }
 
+bool ValidEnumPayloadBits(const cursive0::analysis::ScopeContext& ctx,
+                          const cursive0::syntax::VariantDecl& variant,
+                          const std::vector<std::uint8_t>& payload_bits);
+bool ValidNicheEnumBits(const cursive0::analysis::ScopeContext& ctx,
+                        const cursive0::syntax::EnumDecl& decl,
+                        const EnumLayout& layout,
+                        const std::vector<std::uint8_t>& bits);
+
 bool ValidEnumBits(const cursive0::analysis::ScopeContext& ctx,
                    const cursive0::syntax::EnumDecl& decl,
                    const std::vector<std::uint8_t>& bits) {
@@ -1175,6 +1214,9 @@ bool ValidEnumBits(const cursive0::analysis::ScopeContext& ctx,
   if (bits.size() != layout->layout.size) {
     return false;
   }
+  if (layout->niche) {
+    return ValidNicheEnumBits(ctx, decl, *layout, bits);
+  }
   const auto disc_size_opt = PrimSize(layout->disc_type);
   const auto disc_align_opt = PrimAlign(layout->disc_type);
   if (!disc_size_opt.has_value() || !disc_align_opt.has_value()) {
@@ -1215,9 +1257,14 @@ bool ValidEnumBits(const cursive0::analysis::ScopeContext& ctx,
   if (!payload_bits.has_value()) {
     return false;
   }
-  const auto& variant = decl.variants[*index];
+  return ValidEnumPayloadBits(ctx, decl.variants[*index], *payload_bits);
+}
+
+bool ValidEnumPayloadBits(const cursive0::analysis::ScopeContext& ctx,
+                          const cursive0::syntax::VariantDecl& variant,
+                          const std::vector<std::uint8_t>& payload_bits) {
   if (!variant.payload_opt.has_value()) {
-    return AllZero(*payload_bits, 0, payload_bits->size());
+    return AllZero(payload_bits, 0, payload_bits.size());
   }
   if (const auto* tuple =
           std::get_if<cursive0::syntax::VariantPayloadTuple>(
@@ -1236,7 +1283,7 @@ bool ValidEnumBits(const cursive0::analysis::ScopeContext& ctx,
       return false;
     }
     return ValidPaddedStructBits(ctx, elems, tuple_layout->offsets,
-                                 tuple_layout->layout.size, *payload_bits);
+                                 tuple_layout->layout.size, payload_bits);
   }
   if (const auto* record =
           std::get_if<cursive0::syntax::VariantPayloadRecord>(
@@ -1255,11 +1302,42 @@ bool ValidEnumBits(const cursive0::analysis::ScopeContext& ctx,
       return false;
     }
     return ValidPaddedStructBits(ctx, types, record_layout->offsets,
-                                 record_layout->layout.size, *payload_bits);
+                                 record_layout->layout.size, payload_bits);
   }
   return false;
 }
 
+// Layout-Enum-Niche: the niche field names the variant; the niche field
+// itself is not part of any other variant's payload.
+bool ValidNicheEnumBits(const cursive0::analysis::ScopeContext& ctx,
+                        const cursive0::syntax::EnumDecl& decl,
+                        const EnumLayout& layout,
+                        const std::vector<std::uint8_t>& bits) {
+  const auto niche_size = PrimSize(layout.niche_type);
+  if (!niche_size.has_value()) {
+    return false;
+  }
+  const auto niche_bits =
+      SliceBytes(bits, static_cast<std::size_t>(layout.niche_offset),
+                 static_cast<std::size_t>(*niche_size));
+  if (!niche_bits.has_value()) {
+    return false;
+  }
+  const auto niche_value = BitsToUInt(*niche_bits);
+  if (!niche_value.has_value()) {
+    return false;
+  }
+  const std::size_t index =
+      EnumVariantOfNiche(layout, decl.variants.size(), *niche_value);
+  std::vector<std::uint8_t> payload_bits(bits);
+  if (index != layout.niche_variant) {
+    std::fill_n(payload_bits.begin() + layout.niche_offset, *niche_size, 0);
+  }
+  const auto offset = static_cast<std::size_t>(layout.payload_offsets[index]);
+  payload_bits.erase(payload_bits.begin(), payload_bits.begin() + offset);
+  return ValidEnumPayloadBits(ctx, decl.variants[index], payload_bits);
+}
+
 bool ValidModalTaggedBits(const cursive0::analysis::ScopeContext& ctx,
                           const cursive0::syntax::ModalDecl& decl,
                           const std::vector<std::uint8_t>& bits) {
@@ -1776,7 +1854,7 @@ bool ValidValue(const cursive0::analysis::ScopeContext& ctx,
           types.push_back(*lowered);
         }
       }
-      const auto layout = RecordLayoutOf(ctx, types);
+      const auto layout = RecordDeclLayoutOf(ctx, *record, types);
       if (!layout.has_value()) {
         return false;
       }
@@ -2055,7 +2133,7 @@ std::optional<std::vector<std::uint8_t>> ValueBits(
           fields.emplace_back(field->name, *lowered);
         }
       }
-      return ValueBitsForRecord(ctx, fields, *v);
+      return ValueBitsForRecord(ctx, fields, *v, record);
     }
     if (const auto* enum_decl =
             std::get_if<cursive0::syntax::EnumDecl>(&it->second)) {
@@ -2083,6 +2161,16 @@ std::optional<std::vector<std::uint8_t>> ValueBits(
       if (!discs.ok || discs.discs.size() <= index) {
         return std::nullopt;
       }
+      if (layout->niche) {
+        const std::uint64_t offset = layout->payload_offsets[index];
+        const auto payload_bits = EnumPayloadBits(
+            ctx, *enum_decl, enum_decl->variants[index], v->payload,
+            layout->layout.size - offset);
+        if (!payload_bits.has_value()) {
+          return std::nullopt;
+        }
+        return NicheEnumBits(*layout, index, *payload_bits);
+      }
       const std::uint64_t disc_value = discs.discs[index];
       const auto disc_bits =
           LEBytesU64(disc_value, PrimSize(layout->disc_type).value_or(1));
@@ -8,6 +8,7 @@
 // LLVM Includes
 #include "llvm/ADT/APInt.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/Module.h"
@@ -129,6 +130,40 @@ llvm::Constant* ConstBytes(llvm::Type* ty,
     return llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(ty));
   }
 
+  // Aggregates from compile-time evaluated statics: split the layout bytes
+  // at the element offsets of the LLVM type (padding is explicit there).
+  const llvm::DataLayout& dl = emitter.GetModule().getDataLayout();
+  if ((ty->isStructTy() || ty->isArrayTy()) &&
+      dl.getTypeAllocSize(ty) == bytes.size()) {
+    auto slice = [&](std::uint64_t offset, llvm::Type* elem_ty) {
+      const std::uint64_t size = dl.getTypeAllocSize(elem_ty);
+      return std::vector<std::uint8_t>(bytes.begin() + offset,
+                                       bytes.begin() + offset + size);
+    };
+    std::vector<llvm::Constant*> elems;
+    if (auto* st = llvm::dyn_cast<llvm::StructType>(ty)) {
+      if (!st->isOpaque()) {
+        const llvm::StructLayout* layout = dl.getStructLayout(st);
+        for (unsigned i = 0; i < st->getNumElements(); ++i) {
+          llvm::Type* elem_ty = st->getElementType(i);
+          const std::uint64_t elem_offset = layout->getElementOffset(i);
+          elems.push_back(
+              ConstBytes(elem_ty, slice(elem_offset, elem_ty), emitter, lower_ctx));
+        }
+        return llvm::ConstantStruct::get(st, elems);
+      }
+    } else {
+      auto* arr = llvm::cast<llvm::ArrayType>(ty);
+      llvm::Type* elem_ty = arr->getElementType();
+      const std::uint64_t stride = dl.getTypeAllocSize(elem_ty);
+      for (std::uint64_t i = 0; i < arr->getNumElements(); ++i) {
+        elems.push_back(
+            ConstBytes(elem_ty, slice(i * stride, elem_ty), emitter, lower_ctx));
+      }
+      return llvm::ConstantArray::get(arr, elems);
+    }
+  }
+
   if (lower_ctx) {
     lower_ctx->ReportCodegenFailure();
   }
@@ -188,7 +223,7 @@ void LLVMEmitter::EmitGlobalConst(const GlobalConst& global) {
   auto* gvar = new llvm::GlobalVariable(
       *module_,
       llvm_ty,
-      is_literal,
+      is_literal || global.read_only,
       is_literal ? llvm::GlobalValue::InternalLinkage
                  : llvm::GlobalValue::ExternalLinkage,
       init,
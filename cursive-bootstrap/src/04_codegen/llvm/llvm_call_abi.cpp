@@ -9,7 +9,11 @@
 #include "llvm/IR/Function.h"
 
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <string>
+#include <utility>
+#include <variant>
 
 namespace cursive0::codegen {
 
@@ -47,12 +51,47 @@ bool IsValidPtrType(const analysis::TypeRef& type) {
 
 }  // namespace
 
+std::size_t LLVMEmitter::CallABIKeyHash::operator()(
+    const CallABIKey& key) const {
+  std::size_t hash = std::hash<const analysis::Type*>{}(key.ret.get());
+  for (const auto& [mode, type] : key.params) {
+    const std::size_t part =
+        std::hash<const analysis::Type*>{}(type.get()) * 3 +
+        (mode.has_value() ? static_cast<std::size_t>(*mode) + 1 : 0);
+    hash ^= part + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
 // T-LLVM-011: Call ABI Mapping
 ABICallResult LLVMEmitter::ComputeCallABI(const std::vector<IRParam>& params,
                                           analysis::TypeRef ret_type) {
   SPEC_RULE("LLVMCall-ByValue");
   SPEC_RULE("LLVMCall-SRet");
 
+  CallABIKey key;
+  key.params.reserve(params.size());
+  for (const auto& param : params) {
+    key.params.emplace_back(param.mode, param.type);
+  }
+  key.ret = ret_type;
+  if (const auto it = call_abi_cache_.find(key); it != call_abi_cache_.end()) {
+    ++call_abi_stats_.hits;
+    return it->second;
+  }
+  ++call_abi_stats_.misses;
+
+  ABICallResult result = ComputeCallABIUncached(params, ret_type);
+  // Failed classifications are not cached so each use reports again.
+  if (!current_ctx_ || !current_ctx_->codegen_failed) {
+    call_abi_cache_.emplace(std::move(key), result);
+  }
+  return result;
+}
+
+ABICallResult LLVMEmitter::ComputeCallABIUncached(
+    const std::vector<IRParam>& params,
+    const analysis::TypeRef& ret_type) {
   ABICallResult result;
 
   const analysis::ScopeContext scope = BuildScope(current_ctx_);
@@ -151,11 +151,11 @@ std::vector<std::string> PoisonSetForInit(const LowerCtx& ctx) {
   std::vector<std::string> out;
   out.reserve(n);
   for (std::size_t i = 0; i < n; ++i) {
-    if (visited[i]) {
+    if (visited[i] && !ctx.PoisonFree(ctx.init_modules[i])) {
       out.push_back(core::StringOfPath(ctx.init_modules[i]));
     }
   }
-  if (out.empty()) {
+  if (out.empty() && !ctx.PoisonFree(module_name)) {
     out.push_back(module_name);
   }
   return out;
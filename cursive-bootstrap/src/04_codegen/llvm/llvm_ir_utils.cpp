@@ -18,8 +18,10 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
 
 #include <algorithm>
 #include <cstring>
@@ -253,6 +255,160 @@ void StoreAtOffset(LLVMEmitter& emitter,
   builder->CreateStore(value, ptr);
 }
 
+std::optional<unsigned> StructElementAt(LLVMEmitter& emitter,
+                                        llvm::Type* agg_ty,
+                                        std::uint64_t offset,
+                                        llvm::Type* field_ty) {
+  auto* struct_ty = llvm::dyn_cast_or_null<llvm::StructType>(agg_ty);
+  if (!struct_ty || struct_ty->isOpaque()) {
+    return std::nullopt;
+  }
+  const llvm::StructLayout* layout =
+      emitter.GetModule().getDataLayout().getStructLayout(struct_ty);
+  for (unsigned i = 0; i < struct_ty->getNumElements(); ++i) {
+    const std::uint64_t elem_offset = layout->getElementOffset(i);
+    if (elem_offset > offset) {
+      break;
+    }
+    if (elem_offset == offset &&
+        (!field_ty || struct_ty->getElementType(i) == field_ty)) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+llvm::Value* FieldGEP(LLVMEmitter& emitter,
+                      llvm::IRBuilder<>* builder,
+                      llvm::Type* agg_ty,
+                      llvm::Value* ptr,
+                      std::uint64_t offset) {
+  if (const auto index = StructElementAt(emitter, agg_ty, offset, nullptr)) {
+    return builder->CreateStructGEP(agg_ty, ptr, *index);
+  }
+  return offset == 0 ? ptr : ByteGEP(emitter, builder, ptr, offset);
+}
+
+namespace {
+
+// Padding members are [N x i8] arrays emitted by AppendPad.
+bool IsPadMember(llvm::Type* ty) {
+  auto* arr = llvm::dyn_cast<llvm::ArrayType>(ty);
+  return arr && arr->getElementType()->isIntegerTy(8);
+}
+
+bool CountScalarLeaves(llvm::Type* ty, std::size_t& count) {
+  if (auto* struct_ty = llvm::dyn_cast<llvm::StructType>(ty)) {
+    if (struct_ty->isOpaque()) {
+      return false;
+    }
+    for (llvm::Type* elem : struct_ty->elements()) {
+      if (IsPadMember(elem)) {
+        continue;
+      }
+      if (!CountScalarLeaves(elem, count)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (auto* arr = llvm::dyn_cast<llvm::ArrayType>(ty)) {
+    for (std::uint64_t i = 0; i < arr->getNumElements(); ++i) {
+      if (!CountScalarLeaves(arr->getElementType(), count)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (!ty->isIntegerTy() && !ty->isFloatingPointTy() && !ty->isPointerTy()) {
+    return false;
+  }
+  return ++count <= kMaxSSAAggregateFields;
+}
+
+}  // namespace
+
+bool IsSmallScalarAggregate(llvm::Type* ty) {
+  if (!ty || !ty->isStructTy()) {
+    return false;
+  }
+  std::size_t count = 0;
+  return CountScalarLeaves(ty, count);
+}
+
+llvm::Value* BuildSmallAggregate(
+    LLVMEmitter& emitter,
+    llvm::IRBuilder<>* builder,
+    llvm::Type* agg_ty,
+    const std::vector<std::pair<std::uint64_t, llvm::Value*>>& fields) {
+  if (!IsSmallScalarAggregate(agg_ty)) {
+    return nullptr;
+  }
+  std::vector<std::pair<unsigned, llvm::Value*>> members;
+  members.reserve(fields.size());
+  for (const auto& [offset, value] : fields) {
+    const auto index = StructElementAt(emitter, agg_ty, offset, value->getType());
+    if (!index.has_value()) {
+      return nullptr;
+    }
+    members.emplace_back(*index, value);
+  }
+  llvm::Value* agg = llvm::Constant::getNullValue(agg_ty);
+  for (const auto& [index, value] : members) {
+    agg = builder->CreateInsertValue(agg, value, {index});
+  }
+  return agg;
+}
+
+void StoreEnumTag(LLVMEmitter& emitter,
+                  llvm::IRBuilder<>* builder,
+                  llvm::Value* ptr,
+                  const EnumLayout& layout,
+                  std::size_t index,
+                  std::uint64_t disc) {
+  if (!layout.niche) {
+    llvm::Type* disc_ty =
+        emitter.GetLLVMType(analysis::MakeTypePrim(layout.disc_type));
+    StoreAtOffset(emitter, builder, ptr, 0, llvm::ConstantInt::get(disc_ty, disc));
+    return;
+  }
+  if (index == layout.niche_variant) {
+    return;
+  }
+  llvm::Type* niche_ty =
+      emitter.GetLLVMType(analysis::MakeTypePrim(layout.niche_type));
+  StoreAtOffset(emitter, builder, ptr, layout.niche_offset,
+                llvm::ConstantInt::get(niche_ty, EnumNicheValue(layout, index)));
+}
+
+llvm::Value* EnumTagMatches(LLVMEmitter& emitter,
+                            llvm::IRBuilder<>* builder,
+                            llvm::Value* ptr,
+                            const EnumLayout& layout,
+                            std::size_t variant_count,
+                            std::size_t index,
+                            std::uint64_t disc) {
+  if (!layout.niche) {
+    llvm::Type* disc_ty =
+        emitter.GetLLVMType(analysis::MakeTypePrim(layout.disc_type));
+    llvm::Value* value = LoadAtOffset(emitter, builder, ptr, 0, disc_ty);
+    return builder->CreateICmpEQ(value, llvm::ConstantInt::get(disc_ty, disc));
+  }
+  llvm::Type* niche_ty =
+      emitter.GetLLVMType(analysis::MakeTypePrim(layout.niche_type));
+  llvm::Value* value =
+      LoadAtOffset(emitter, builder, ptr, layout.niche_offset, niche_ty);
+  if (index != layout.niche_variant) {
+    return builder->CreateICmpEQ(
+        value, llvm::ConstantInt::get(niche_ty, EnumNicheValue(layout, index)));
+  }
+  // Any value outside the other variants' range belongs to the niche variant.
+  llvm::Value* rank = builder->CreateSub(
+      value, llvm::ConstantInt::get(niche_ty, layout.niche_start));
+  return builder->CreateICmpUGE(
+      rank, llvm::ConstantInt::get(niche_ty, variant_count - 1));
+}
+
 llvm::Value* SliceLenFromValue(LLVMEmitter& emitter,
                                llvm::IRBuilder<>* builder,
                                const IRValue& value,
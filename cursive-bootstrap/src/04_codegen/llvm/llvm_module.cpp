@@ -17,6 +17,8 @@
 #include "llvm/IR/Type.h"
 #include "llvm/TargetParser/Triple.h"
 
+#include <cstdlib>
+
 namespace cursive0::codegen {
 
 LLVMEmitter::LLVMEmitter(llvm::LLVMContext& ctx, const std::string& module_name)
@@ -261,7 +263,7 @@ llvm::Module* LLVMEmitter::EmitModule(const IRDecls& decls, LowerCtx& ctx) {
   auto declare_proc = [&](const std::string& sym,
                           const std::vector<IRParam>& params,
                           const analysis::TypeRef& ret,
-                          bool linkonce_drop_glue) {
+                          bool linkonce) {
     if (functions_.count(sym)) {
       return;
     }
@@ -275,7 +277,7 @@ llvm::Module* LLVMEmitter::EmitModule(const IRDecls& decls, LowerCtx& ctx) {
     llvm::Function* f = llvm::Function::Create(
         ft, llvm::GlobalValue::ExternalLinkage, sym, module_.get());
     f->setCallingConv(llvm::CallingConv::C);
-    if (linkonce_drop_glue) {
+    if (linkonce) {
       f->setLinkage(llvm::GlobalValue::LinkOnceODRLinkage);
       f->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
       if (auto* comdat = module_->getOrInsertComdat(sym)) {
@@ -341,15 +343,30 @@ llvm::Module* LLVMEmitter::EmitModule(const IRDecls& decls, LowerCtx& ctx) {
     proc.params.push_back(MakeParam(std::string(kPanicOutName), analysis::ParamMode::Move,
                                     PanicOutType()));
     proc.ret = analysis::MakeTypePrim("()");
+    if (ctx.drop_glue_external.count(sym)) {
+      // Another module of this program owns the definition.
+      declare_proc(sym, proc.params, proc.ret, false);
+      ctx.RegisterProcSig(proc);
+      continue;
+    }
     proc.body = EmitDropGlue(type, ctx);
     ctx.RegisterProcSig(proc);
     expanded.push_back(std::move(proc));
   }
 
+  // Drop glue and generic procedures are emitted linkonce_odr in their own
+  // comdat: one copy survives linking, and one nothing references can go.
+  const bool linkonce_generics =
+      std::getenv("CURSIVE0_NO_GENERIC_LINKONCE") == nullptr;
+  auto is_linkonce = [&](const std::string& sym) {
+    return IsDropGlueSymbol(sym) ||
+           (linkonce_generics && ctx.generic_procs.count(sym) != 0);
+  };
+
   // Pass 1: declare functions
   for (const auto& decl : expanded) {
     if (auto* proc = std::get_if<ProcIR>(&decl)) {
-      declare_proc(proc->symbol, proc->params, proc->ret, IsDropGlueSymbol(proc->symbol));
+      declare_proc(proc->symbol, proc->params, proc->ret, is_linkonce(proc->symbol));
     } else if (auto* ext = std::get_if<ExternProcIR>(&decl)) {
       declare_proc(ext->symbol, ext->params, ext->ret, false);
     }
@@ -363,9 +380,17 @@ llvm::Module* LLVMEmitter::EmitModule(const IRDecls& decls, LowerCtx& ctx) {
     declare_proc(sym, sig.params, sig.ret, false);
   }
 
-  // Pass 2: emit definitions and globals
+  // Pass 2: emit vtables first so dynamic calls can see their initializers,
+  // then the remaining definitions and globals
   for (const auto& decl : expanded) {
-    EmitDecl(decl);
+    if (std::holds_alternative<GlobalVTable>(decl)) {
+      EmitDecl(decl);
+    }
+  }
+  for (const auto& decl : expanded) {
+    if (!std::holds_alternative<GlobalVTable>(decl)) {
+      EmitDecl(decl);
+    }
   }
 
   if (ctx.main_symbol.has_value()) {
@@ -477,7 +502,10 @@ void LLVMEmitter::EmitProc(const ProcIR& proc) {
     llvm::Type* usize_ty = GetLLVMType(analysis::MakeTypePrim("usize"));
     llvm::Value* size_val = llvm::ConstantInt::get(usize_ty, info.frame_size);
     llvm::Value* align_val = llvm::ConstantInt::get(usize_ty, info.frame_align);
-    llvm::Value* frame_ptr = builder->CreateCall(alloc_fn, {size_val, align_val});
+    llvm::Value* class_val = llvm::ConstantInt::get(
+        usize_ty, AsyncFrameSizeClass(info.frame_size, info.frame_align));
+    llvm::Value* frame_ptr =
+        builder->CreateCall(alloc_fn, {size_val, align_val, class_val});
     frame_ptr = CoerceValue(builder, frame_ptr, GetOpaquePtr());
 
     llvm::Value* resume_state_val =
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <numeric>
 
 namespace cursive0::codegen {
 
@@ -72,8 +73,17 @@ void AppendStructElems(std::vector<llvm::Type*>& elems,
     return;
   }
 
+  // Members follow memory order, which a reordered record layout need not
+  // share with its fields.
+  std::vector<std::size_t> order(fields.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t lhs, std::size_t rhs) {
+                     return offsets[lhs] < offsets[rhs];
+                   });
+
   std::uint64_t prev_end = 0;
-  for (std::size_t i = 0; i < fields.size(); ++i) {
+  for (const std::size_t i : order) {
     const std::uint64_t offset = offsets[i];
     if (offset > prev_end) {
       AppendPad(elems, emitter.GetContext(), offset - prev_end);
@@ -746,7 +756,7 @@ llvm::Type* LLVMEmitter::GetLLVMType(analysis::TypeRef type) {
         } else if (const auto* record = std::get_if<syntax::RecordDecl>(&it->second)) {
           SPEC_RULE("LLVMTy-Record");
           const auto fields = RecordFieldTypes(*scope_opt, *record);
-          const auto layout = RecordLayoutOf(*scope_opt, fields);
+          const auto layout = RecordDeclLayoutOf(*scope_opt, *record, fields);
           std::vector<llvm::Type*> elems;
           if (layout.has_value()) {
             AppendStructElems(elems, fields, layout->offsets, layout->layout.size,
@@ -11,6 +11,7 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 
 namespace cursive0::codegen {
@@ -19,6 +20,11 @@ namespace cursive0::codegen {
 
 namespace {
 
+// Same ratio llvm.expect lowers to. The weights are attached directly since
+// no LowerExpectIntrinsic pass runs before instruction selection.
+constexpr std::uint32_t kCheckLikelyWeight = 2000;
+constexpr std::uint32_t kCheckUnlikelyWeight = 1;
+
 analysis::ScopeContext BuildScope(const LowerCtx* ctx) {
   analysis::ScopeContext scope;
   if (ctx && ctx->sigma) {
@@ -132,6 +138,13 @@ llvm::Value* EmitCheckedWithOverflow(LLVMEmitter& emitter,
 
   llvm::Function* func = builder->GetInsertBlock()->getParent();
   llvm::BasicBlock* ok_bb = llvm::BasicBlock::Create(ctx, "op_ok", func);
+  if (emitter.ColdPanicPaths()) {
+    llvm::BasicBlock* fail_bb = emitter.PanicReturnBlock(PanicCode(reason));
+    builder->CreateCondBr(overflow, fail_bb, ok_bb,
+                          emitter.CheckBranchWeights(true));
+    builder->SetInsertPoint(ok_bb);
+    return val;
+  }
   llvm::BasicBlock* fail_bb = llvm::BasicBlock::Create(ctx, "op_fail", func);
   builder->CreateCondBr(overflow, fail_bb, ok_bb);
 
@@ -144,6 +157,50 @@ llvm::Value* EmitCheckedWithOverflow(LLVMEmitter& emitter,
 
 }  // namespace
 
+llvm::MDNode* LLVMEmitter::CheckBranchWeights(bool fail_on_true) {
+  if (!cold_panic_paths_) {
+    return nullptr;
+  }
+  llvm::MDBuilder md(context_);
+  return fail_on_true
+             ? md.createBranchWeights(kCheckUnlikelyWeight, kCheckLikelyWeight)
+             : md.createBranchWeights(kCheckLikelyWeight, kCheckUnlikelyWeight);
+}
+
+llvm::Function* LLVMEmitter::PanicRecordHelper() {
+  if (panic_record_helper_) {
+    return panic_record_helper_;
+  }
+  const auto scope = BuildScope(current_ctx_);
+  std::vector<analysis::TypeRef> fields;
+  fields.push_back(analysis::MakeTypePrim("bool"));
+  fields.push_back(analysis::MakeTypePrim("u32"));
+  const auto layout = RecordLayoutOf(scope, fields);
+  if (!layout.has_value() || layout->offsets.size() < 2) {
+    return nullptr;
+  }
+
+  llvm::Type* ptr_ty = GetOpaquePtr();
+  llvm::Type* i32_ty = llvm::Type::getInt32Ty(context_);
+  auto* fn_ty = llvm::FunctionType::get(llvm::Type::getVoidTy(context_),
+                                        {ptr_ty, i32_ty}, false);
+  llvm::Function* fn = llvm::Function::Create(
+      fn_ty, llvm::Function::InternalLinkage, "cursive0.panic_record",
+      module_.get());
+  fn->addFnAttr(llvm::Attribute::Cold);
+  fn->addFnAttr(llvm::Attribute::NoInline);
+  fn->addFnAttr(llvm::Attribute::NoUnwind);
+
+  llvm::IRBuilder<> body(llvm::BasicBlock::Create(context_, "entry", fn));
+  llvm::Value* out = fn->getArg(0);
+  StoreAtOffset(*this, &body, out, layout->offsets[0],
+                llvm::ConstantInt::get(llvm::Type::getInt8Ty(context_), 1));
+  StoreAtOffset(*this, &body, out, layout->offsets[1], fn->getArg(1));
+  body.CreateRetVoid();
+  panic_record_helper_ = fn;
+  return fn;
+}
+
 llvm::Value* LLVMEmitter::EmitCheckedAdd(llvm::Value* lhs, llvm::Value* rhs, bool is_signed) {
   SPEC_RULE("LLVMUBSafe-Add");
 
@@ -87,16 +87,8 @@ static void MergeMoveStates(LowerCtx& base,
 }
 
 static void MergeLowerCtxTemps(LowerCtx& base, const LowerCtx& branch) {
-  for (const auto& [name, type] : branch.value_types) {
-    if (!base.value_types.count(name)) {
-      base.value_types.emplace(name, type);
-    }
-  }
-  for (const auto& [name, info] : branch.derived_values) {
-    if (!base.derived_values.count(name)) {
-      base.derived_values.emplace(name, info);
-    }
-  }
+  base.value_types.MergeMissing(branch.value_types);
+  base.derived_values.MergeMissing(branch.derived_values);
   for (const auto& [name, type] : branch.static_types) {
     if (!base.static_types.count(name)) {
       base.static_types.emplace(name, type);
@@ -609,6 +601,36 @@ LowerResult LowerMethodCall(const syntax::MethodCallExpr& expr, LowerCtx& ctx) {
       param_modes = ParamModesFromParams(class_method->params);
     }
 
+    if (is_builtin && analysis::IdEq(dyn_type->path[0], "Reactor") &&
+        expr.name == "run" && expr.args.size() == 1 && expr.args[0].value) {
+      // Reactor::run(async) drives the async like `sync`, waiting on the
+      // reactor between resumes instead of spinning.
+      SPEC_RULE("Lower-MethodCall-ReactorRun");
+      auto recv_result = LowerRecvArgExpr(*expr.receiver, ctx);
+      auto async_result = LowerExpr(*expr.args[0].value, ctx);
+
+      IRCall wait;
+      wait.callee = IRValue{IRValue::Kind::Symbol, BuiltinSymReactorWait(), {}};
+      wait.args = {recv_result.value};
+      wait.result = ctx.FreshTempValue("reactor_wait");
+
+      IRSync sync;
+      sync.async_value = async_result.value;
+      sync.result = ctx.FreshTempValue("reactor_run");
+      sync.wait_ir = MakeIR(std::move(wait));
+      if (ctx.expr_type) {
+        sync.async_type = ctx.expr_type(*expr.args[0].value);
+        if (auto sig = analysis::GetAsyncSig(sync.async_type)) {
+          sync.result_type = sig->result;
+          sync.error_type = sig->err;
+        }
+      }
+
+      IRValue run_result = sync.result;
+      return LowerResult{SeqIR({recv_result.ir, async_result.ir, MakeIR(std::move(sync))}),
+                         run_result};
+    }
+
     if (is_builtin) {
       SPEC_RULE("Lower-MethodCall-Capability");
       auto recv_result = LowerRecvArgExpr(*expr.receiver, ctx);
@@ -652,6 +674,7 @@ LowerResult LowerMethodCall(const syntax::MethodCallExpr& expr, LowerCtx& ctx) {
 
       auto dyn_result = LowerDynCall(recv_result.value,
                                      "",
+                                     dyn_type->path,
                                      *class_decl,
                                      expr.name,
                                      arg_values,
@@ -1029,16 +1052,10 @@ LowerResult LowerPropagateExpr(const syntax::PropagateExpr& expr,
     success_type = SuccessMemberType(scope, ctx.proc_ret_type, expr_type);
   }
 
-  std::string suffix = inner_result.value.name;
-  if (suffix.empty()) {
-    suffix = "value";
-  }
-  std::string tag = success_type ? suffix : "unknown_" + suffix;
-
-  IRValue cond = ctx.FreshTempValue("propagate_is_success_" + tag);
+  IRValue cond = ctx.FreshTempValue("propagate_is_success");
   IRValue result_value = ctx.FreshTempValue("propagate_result");
   IRValue success_value = result_value;
-  IRValue error_value = ctx.FreshTempValue("propagate_error_" + tag);
+  IRValue error_value = ctx.FreshTempValue("propagate_error");
 
   std::vector<IRPtr> error_parts;
 
@@ -5,6 +5,7 @@
 #include "cursive0/04_codegen/cleanup.h"
 #include "cursive0/04_codegen/abi/abi.h"
 #include "cursive0/00_core/assert_spec.h"
+#include "cursive0/00_core/symbols.h"
 #include "cursive0/03_analysis/caps/cap_concurrency.h"
 #include "cursive0/03_analysis/types/type_expr.h"
 
@@ -779,7 +780,7 @@ static void MergeMoveStates(LowerCtx& base,
 struct LowerCtxSnapshot {
   std::vector<ScopeInfo> scope_stack;
   std::unordered_map<std::string, std::vector<BindingState>> binding_states;
-  std::unordered_map<std::string, DerivedValueInfo> derived_values;
+  DerivedValueTable derived_values;
   std::vector<TempValue>* temp_sink = nullptr;
   int temp_depth = 0;
   std::optional<int> suppress_temp_at_depth;
@@ -806,9 +807,7 @@ struct LowerCtxSnapshot {
     // Merge derived_values: preserve new values created during the nested
     // lowering (e.g., capture_ptr_N) while restoring values from the snapshot.
     // New derived values are referenced from generated IR and must be preserved.
-    for (const auto& [key, value] : derived_values) {
-      ctx.derived_values[key] = value;
-    }
+    ctx.derived_values.Overwrite(derived_values);
     ctx.temp_sink = temp_sink;
     ctx.temp_depth = temp_depth;
     ctx.suppress_temp_at_depth = suppress_temp_at_depth;
@@ -2703,16 +2702,8 @@ static LowerResult LowerExprImpl(const syntax::Expr& expr, LowerCtx& ctx) {
             ir_arm.handler_ir = SeqIR({bind_ir, handler_result.ir, cleanup_ir});
             ir_arm.handler_result = handler_result.value;
 
-            for (const auto& [name, type] : arm_ctx.value_types) {
-              if (!ctx.value_types.count(name)) {
-                ctx.value_types.emplace(name, type);
-              }
-            }
-            for (const auto& [name, info] : arm_ctx.derived_values) {
-              if (!ctx.derived_values.count(name)) {
-                ctx.derived_values.emplace(name, info);
-              }
-            }
+            ctx.value_types.MergeMissing(arm_ctx.value_types);
+            ctx.derived_values.MergeMissing(arm_ctx.derived_values);
             for (const auto& [name, type] : arm_ctx.static_types) {
               if (!ctx.static_types.count(name)) {
                 ctx.static_types.emplace(name, type);
@@ -3003,18 +2994,14 @@ void LowerCtx::RegisterDerivedValue(const IRValue& value, const DerivedValueInfo
   if (value.kind != IRValue::Kind::Opaque) {
     return;
   }
-  derived_values[value.name] = info;
+  derived_values.Set(value, info);
 }
 
 const DerivedValueInfo* LowerCtx::LookupDerivedValue(const IRValue& value) const {
   if (value.kind != IRValue::Kind::Opaque) {
     return nullptr;
   }
-  auto it = derived_values.find(value.name);
-  if (it == derived_values.end()) {
-    return nullptr;
-  }
-  return &it->second;
+  return derived_values.Find(value);
 }
 
 const CaptureAccess* LowerCtx::LookupCapture(const std::string& name) const {
@@ -3043,10 +3030,11 @@ IRValue LowerCtx::CaptureFieldPtr(const CaptureAccess& access) {
   return ptr;
 }
 
-IRValue LowerCtx::FreshTempValue(std::string_view prefix) {
+IRValue LowerCtx::FreshTempValue(const char* prefix) {
   IRValue value;
   value.kind = IRValue::Kind::Opaque;
-  value.name = std::string(prefix) + "_" + std::to_string(temp_counter++);
+  value.id = static_cast<std::uint32_t>(++temp_counter);
+  value.prefix = prefix;
   return value;
 }
 
@@ -3102,7 +3090,7 @@ void LowerCtx::RegisterValueType(const IRValue& value, analysis::TypeRef type) {
   if (value.kind != IRValue::Kind::Opaque) {
     return;
   }
-  value_types[value.name] = type;
+  value_types.Set(value, type);
 }
 
 analysis::TypeRef LowerCtx::LookupValueType(const IRValue& value) const {
@@ -3118,11 +3106,113 @@ analysis::TypeRef LowerCtx::LookupValueType(const IRValue& value) const {
   if (value.kind != IRValue::Kind::Opaque) {
     return nullptr;
   }
-  auto it = value_types.find(value.name);
-  if (it != value_types.end()) {
-    return it->second;
+  return value_types.Get(value);
+}
+
+void ValueTypeTable::Set(const IRValue& value, analysis::TypeRef type) {
+  if (value.id == 0) {
+    by_name_[value.name] = std::move(type);
+    return;
   }
-  return nullptr;
+  if (value.id >= by_id_.size()) {
+    by_id_.resize(static_cast<std::size_t>(value.id) + 1);
+  }
+  by_id_[value.id] = std::move(type);
+}
+
+analysis::TypeRef ValueTypeTable::Get(const IRValue& value) const {
+  if (value.id != 0) {
+    return value.id < by_id_.size() ? by_id_[value.id] : nullptr;
+  }
+  const auto it = by_name_.find(value.name);
+  return it != by_name_.end() ? it->second : nullptr;
+}
+
+void ValueTypeTable::MergeMissing(const ValueTypeTable& other) {
+  if (other.by_id_.size() > by_id_.size()) {
+    by_id_.resize(other.by_id_.size());
+  }
+  for (std::size_t i = 0; i < other.by_id_.size(); ++i) {
+    if (!by_id_[i] && other.by_id_[i]) {
+      by_id_[i] = other.by_id_[i];
+    }
+  }
+  for (const auto& [name, type] : other.by_name_) {
+    by_name_.emplace(name, type);
+  }
+}
+
+void ValueTypeTable::clear() {
+  by_id_.clear();
+  by_name_.clear();
+}
+
+void DerivedValueTable::Set(const IRValue& value, const DerivedValueInfo& info) {
+  if (value.id == 0) {
+    by_name_[value.name] = info;
+    return;
+  }
+  if (value.id >= slot_by_id_.size()) {
+    slot_by_id_.resize(static_cast<std::size_t>(value.id) + 1, 0);
+  }
+  std::uint32_t& slot = slot_by_id_[value.id];
+  if (slot != 0) {
+    infos_[slot - 1] = info;
+    return;
+  }
+  infos_.push_back(info);
+  slot = static_cast<std::uint32_t>(infos_.size());
+}
+
+const DerivedValueInfo* DerivedValueTable::Find(const IRValue& value) const {
+  if (value.id != 0) {
+    if (value.id >= slot_by_id_.size() || slot_by_id_[value.id] == 0) {
+      return nullptr;
+    }
+    return &infos_[slot_by_id_[value.id] - 1];
+  }
+  const auto it = by_name_.find(value.name);
+  return it != by_name_.end() ? &it->second : nullptr;
+}
+
+void DerivedValueTable::Merge(const DerivedValueTable& other, bool overwrite) {
+  if (other.slot_by_id_.size() > slot_by_id_.size()) {
+    slot_by_id_.resize(other.slot_by_id_.size(), 0);
+  }
+  for (std::size_t id = 0; id < other.slot_by_id_.size(); ++id) {
+    const std::uint32_t theirs = other.slot_by_id_[id];
+    if (theirs == 0) {
+      continue;
+    }
+    std::uint32_t& ours = slot_by_id_[id];
+    if (ours == 0) {
+      infos_.push_back(other.infos_[theirs - 1]);
+      ours = static_cast<std::uint32_t>(infos_.size());
+    } else if (overwrite) {
+      infos_[ours - 1] = other.infos_[theirs - 1];
+    }
+  }
+  for (const auto& [name, info] : other.by_name_) {
+    if (overwrite) {
+      by_name_[name] = info;
+    } else {
+      by_name_.emplace(name, info);
+    }
+  }
+}
+
+void DerivedValueTable::MergeMissing(const DerivedValueTable& other) {
+  Merge(other, false);
+}
+
+void DerivedValueTable::Overwrite(const DerivedValueTable& other) {
+  Merge(other, true);
+}
+
+void DerivedValueTable::clear() {
+  slot_by_id_.clear();
+  infos_.clear();
+  by_name_.clear();
 }
 
 void LowerCtx::RegisterStaticType(const std::string& sym, analysis::TypeRef type) {
@@ -3210,6 +3300,15 @@ const std::vector<std::string>* LowerCtx::LookupProcModule(const std::string& sy
   return nullptr;
 }
 
+bool LowerCtx::PoisonFree(const std::string& module) const {
+  return poison_free_modules.count(module) != 0;
+}
+
+bool LowerCtx::PoisonFree(const std::vector<std::string>& module) const {
+  return !poison_free_modules.empty() &&
+         PoisonFree(core::StringOfPath(module));
+}
+
 const LowerCtx::AsyncProcInfo* LowerCtx::LookupAsyncProc(const std::string& sym) const {
   auto it = async_procs.find(sym);
   if (it != async_procs.end()) {
@@ -598,9 +598,11 @@ IRPtr LowerWritePlaceImpl(const syntax::Expr& place,
           SPEC_RULE(allow_drop ? "Lower-WritePlace-Ident-Path"
                                : "LowerWriteSub-Ident-Path");
           IRPtr poison_ir = EmptyIR();
-          IRCheckPoison check;
-          check.module = ModulePathString(full);
-          poison_ir = MakeIR(std::move(check));
+          if (!ctx.PoisonFree(full)) {
+            IRCheckPoison check;
+            check.module = ModulePathString(full);
+            poison_ir = MakeIR(std::move(check));
+          }
 
           IRPtr drop_ir = EmptyIR();
           if (allow_drop) {
@@ -977,9 +979,11 @@ LowerResult LowerAddrOf(const syntax::Expr& place, LowerCtx& ctx) {
           ctx.RegisterDerivedValue(ptr_value, info);
 
           IRPtr poison_ir = EmptyIR();
-          IRCheckPoison check;
-          check.module = ModulePathString(full);
-          poison_ir = MakeIR(std::move(check));
+          if (!ctx.PoisonFree(full)) {
+            IRCheckPoison check;
+            check.module = ModulePathString(full);
+            poison_ir = MakeIR(std::move(check));
+          }
           if (poison_ir && !std::holds_alternative<IROpaque>(poison_ir->node)) {
             return LowerResult{SeqIR(std::vector<IRPtr>{poison_ir,
                                                         PanicCheck(ctx),
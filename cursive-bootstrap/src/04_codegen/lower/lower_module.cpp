@@ -422,6 +422,9 @@ IRDecls LowerModule(const syntax::ASTModule& module, LowerCtx& ctx) {
             if (node.name == "main") {
               ctx.main_symbol = proc.symbol;
             }
+            if (node.generic_params.has_value()) {
+              ctx.generic_procs.insert(proc.symbol);
+            }
             decls.push_back(std::move(proc));
             return;
           } else if constexpr (std::is_same_v<T, syntax::RecordDecl>) {
@@ -709,16 +709,8 @@ LowerResult LowerMatch(const syntax::Expr& scrutinee,
     LowerCtx arm_ctx = ctx;
     auto arm_result = LowerMatchArm(arm, scrutinee_result.value, scrutinee_type,
                                     scrutinee_prov, scrutinee_region, arm_ctx);
-    for (const auto& [name, type] : arm_ctx.value_types) {
-      if (!ctx.value_types.count(name)) {
-        ctx.value_types.emplace(name, type);
-      }
-    }
-    for (const auto& [name, info] : arm_ctx.derived_values) {
-      if (!ctx.derived_values.count(name)) {
-        ctx.derived_values.emplace(name, info);
-      }
-    }
+    ctx.value_types.MergeMissing(arm_ctx.value_types);
+    ctx.derived_values.MergeMissing(arm_ctx.derived_values);
     for (const auto& [name, type] : arm_ctx.static_types) {
       if (!ctx.static_types.count(name)) {
         ctx.static_types.emplace(name, type);
@@ -1,7 +1,9 @@
 #include "cursive0/04_codegen/lower/lower_proc.h"
 
 #include "cursive0/04_codegen/abi/abi.h"
+#include "cursive0/04_codegen/check_elim.h"
 #include "cursive0/04_codegen/checks.h"
+#include "cursive0/04_codegen/escape.h"
 #include "cursive0/04_codegen/cleanup.h"
 #include "cursive0/04_codegen/globals.h"
 #include "cursive0/04_codegen/lower/lower_expr.h"
@@ -13,6 +15,7 @@
 #include "cursive0/03_analysis/memory/regions.h"
 #include "cursive0/03_analysis/types/types.h"
 
+#include <cstdlib>
 #include <unordered_map>
 
 namespace cursive0::codegen {
@@ -324,6 +327,19 @@ ProcIR LowerProc(const ProcedureDecl& decl,
 
   ir.body = SeqIR(std::move(body_seq));
 
+  // Async bodies are split into resume states below; their checks stay.
+  if (!IsAsyncProc(ir.ret) && std::getenv("CURSIVE0_NO_CHECK_ELIM") == nullptr) {
+    // The precondition is only a fact inside the body when the [[dynamic]]
+    // entry check enforces it.
+    const syntax::ExprPtr precondition =
+        precond_ir ? decl.contract->precondition : nullptr;
+    EliminateChecks(ir, ctx, precondition, precond_ir.get());
+  }
+  // Async frames outlive the resume call, so their allocations stay put.
+  if (!IsAsyncProc(ir.ret) && std::getenv("CURSIVE0_NO_ESCAPE") == nullptr) {
+    PromoteNonEscapingAllocs(ir, ctx);
+  }
+
   if (IsAsyncProc(ir.ret)) {
     const auto sig = analysis::GetAsyncSig(ir.ret);
     if (sig.has_value()) {
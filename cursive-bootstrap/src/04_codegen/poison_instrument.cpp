@@ -160,8 +160,7 @@ void LLVMEmitter::EmitPoisonCheck(const std::string& module_name) {
   llvm::Function* func = current->getParent();
   if (!func) return;
 
-  llvm::Type* bool_ty = GetLLVMType(analysis::MakeTypePrim("bool"));
-  llvm::Value* flag_val = builder->CreateLoad(bool_ty, flag);
+  llvm::Value* flag_val = PoisonFlagValue(flag);
   llvm::Value* poisoned = builder->CreateICmpNE(
       flag_val, llvm::Constant::getNullValue(flag_val->getType()));
 
@@ -149,6 +149,11 @@ std::string BuiltinSymFileSystemWriteStderr() {
   return core::PathSig({"cursive", "runtime", "fs", "write_stderr"});
 }
 
+std::string BuiltinSymFileSystemFlushStd() {
+  SPEC_RULE("BuiltinSym-FileSystem-FlushStd");
+  return core::PathSig({"cursive", "runtime", "fs", "flush_std"});
+}
+
 std::string BuiltinSymFileSystemExists() {
   SPEC_RULE("BuiltinSym-FileSystem-Exists");
   return core::PathSig({"cursive", "runtime", "fs", "exists"});
@@ -370,6 +375,26 @@ std::string BuiltinSymReactorRegister() {
   return core::PathSig({"cursive", "runtime", "reactor", "register"});
 }
 
+std::string BuiltinSymReactorRead() {
+  SPEC_DEF("BuiltinSym-Reactor-Read", "§19");
+  return core::PathSig({"cursive", "runtime", "reactor", "read"});
+}
+
+std::string BuiltinSymReactorWrite() {
+  SPEC_DEF("BuiltinSym-Reactor-Write", "§19");
+  return core::PathSig({"cursive", "runtime", "reactor", "write"});
+}
+
+std::string BuiltinSymReactorOpenRead() {
+  SPEC_DEF("BuiltinSym-Reactor-OpenRead", "§19");
+  return core::PathSig({"cursive", "runtime", "reactor", "open_read"});
+}
+
+std::string BuiltinSymReactorWait() {
+  SPEC_DEF("BuiltinSym-Reactor-Wait", "§19");
+  return core::PathSig({"cursive", "runtime", "reactor", "wait"});
+}
+
 // ============================================================================
 // §19 Async builtins
 // ============================================================================
@@ -443,6 +468,15 @@ std::string ContextInitSym() {
   return core::PathSig({"cursive", "runtime", "context_init"});
 }
 
+// ============================================================================
+// Runtime shutdown symbol
+// ============================================================================
+
+std::string RuntimeShutdownSym() {
+  SPEC_RULE("RuntimeShutdownSym-Decl");
+  return core::PathSig({"cursive", "runtime", "shutdown"});
+}
+
 // ============================================================================
 // Spec trace emission symbol
 // ============================================================================
@@ -468,6 +502,7 @@ std::string BuiltinSym(const std::string& qualified_name) {
   if (qualified_name == "FileSystem::write_file") return BuiltinSymFileSystemWriteFile();
   if (qualified_name == "FileSystem::write_stdout") return BuiltinSymFileSystemWriteStdout();
   if (qualified_name == "FileSystem::write_stderr") return BuiltinSymFileSystemWriteStderr();
+  if (qualified_name == "FileSystem::flush_std") return BuiltinSymFileSystemFlushStd();
   if (qualified_name == "FileSystem::exists") return BuiltinSymFileSystemExists();
   if (qualified_name == "FileSystem::remove") return BuiltinSymFileSystemRemove();
   if (qualified_name == "FileSystem::open_dir") return BuiltinSymFileSystemOpenDir();
@@ -496,6 +531,9 @@ std::string BuiltinSym(const std::string& qualified_name) {
   // Reactor builtins (§19)
   if (qualified_name == "Reactor::run") return BuiltinSymReactorRun();
   if (qualified_name == "Reactor::register") return BuiltinSymReactorRegister();
+  if (qualified_name == "Reactor::read") return BuiltinSymReactorRead();
+  if (qualified_name == "Reactor::write") return BuiltinSymReactorWrite();
+  if (qualified_name == "Reactor::open_read") return BuiltinSymReactorOpenRead();
   
   // String builtins
   if (qualified_name == "string::from") return BuiltinSymStringFrom();
@@ -569,6 +607,7 @@ void AnchorRuntimeInterfaceRules() {
   SPEC_RULE("BuiltinSym-FileSystem-WriteFile");
   SPEC_RULE("BuiltinSym-FileSystem-WriteStdout");
   SPEC_RULE("BuiltinSym-FileSystem-WriteStderr");
+  SPEC_RULE("BuiltinSym-FileSystem-FlushStd");
   SPEC_RULE("BuiltinSym-FileSystem-Exists");
   SPEC_RULE("BuiltinSym-FileSystem-Remove");
   SPEC_RULE("BuiltinSym-FileSystem-OpenDir");
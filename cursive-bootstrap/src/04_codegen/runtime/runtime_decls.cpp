@@ -164,6 +164,12 @@ void LLVMEmitter::DeclareRuntime() {
     declare_fn(ContextInitSym(), params, TypePath({"Context"}), false);
   }
 
+  // Runtime shutdown
+  {
+    std::vector<IRParam> params;
+    declare_fn(RuntimeShutdownSym(), params, TypePrim("()"), false);
+  }
+
   // Spec trace emit
   {
     std::vector<IRParam> params;
@@ -335,7 +341,7 @@ void LLVMEmitter::DeclareRuntime() {
     const std::vector<std::string> names = {
         "open_read", "open_write", "open_append", "create_write",
         "read_file", "read_bytes", "write_file", "write_stdout",
-        "write_stderr", "exists", "remove", "open_dir", "create_dir",
+        "write_stderr", "flush_std", "exists", "remove", "open_dir", "create_dir",
         "ensure_dir", "kind", "restrict",
     };
 
@@ -373,6 +379,49 @@ void LLVMEmitter::DeclareRuntime() {
     }
   }
 
+  // Reactor builtins
+  {
+    const std::vector<std::string> names = {"read", "write", "open_read"};
+
+    for (const auto& name : names) {
+      const auto sig = analysis::LookupReactorMethodSig(name);
+      if (!sig.has_value()) {
+        if (current_ctx_) {
+          current_ctx_->ReportCodegenFailure();
+        }
+        continue;
+      }
+
+      std::vector<IRParam> params;
+      auto self_ty = analysis::MakeTypePerm(sig->recv_perm,
+                                        analysis::MakeTypeDynamic({"Reactor"}));
+      params.push_back(MakeParam("self", std::nullopt, self_ty));
+
+      for (const auto& param : sig->params) {
+        if (!param.type) {
+          continue;
+        }
+        auto lowered = LowerTypeForLayout(scope, param.type);
+        if (!lowered.has_value()) {
+          if (current_ctx_) {
+            current_ctx_->ReportCodegenFailure();
+          }
+          continue;
+        }
+        params.push_back(MakeParam(param.name, param.mode.has_value()
+                                                ? std::optional<analysis::ParamMode>(analysis::ParamMode::Move)
+                                                : std::nullopt,
+                                   *lowered));
+      }
+      declare_fn(BuiltinSym("Reactor::" + name), params, sig->ret, false);
+    }
+
+    std::vector<IRParam> params;
+    params.push_back(MakeParam("self", std::nullopt,
+                               analysis::MakeTypeDynamic({"Reactor"})));
+    declare_fn(BuiltinSymReactorWait(), params, TypePrim("()"), false);
+  }
+
   // HeapAllocator builtins
   {
     const std::vector<std::string> names = {
@@ -492,6 +541,7 @@ void LLVMEmitter::DeclareRuntime() {
     std::vector<IRParam> params;
     params.push_back(MakeParam("size", analysis::ParamMode::Move, TypePrim("usize")));
     params.push_back(MakeParam("align", analysis::ParamMode::Move, TypePrim("usize")));
+    params.push_back(MakeParam("size_class", analysis::ParamMode::Move, TypePrim("usize")));
     declare_fn(BuiltinSymAsyncAllocFrame(), params, TypePtrU8(), false);
   }
   {
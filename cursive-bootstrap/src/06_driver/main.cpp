@@ -11,6 +11,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cursive0/00_core/assert_spec.h"
@@ -41,6 +42,9 @@
 #include "cursive0/04_codegen/ir_dump.h"
 
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -82,6 +86,7 @@ struct CliOptions {
   std::optional<std::string> assembly_target;
   std::string input_path;
   bool emit_ir = false;
+  std::optional<std::string> lto;
 };
 
 
@@ -166,6 +171,17 @@ static std::optional<CliOptions> ParseArgs(int argc, char** argv) {
       opts.emit_ir = true;
       continue;
     }
+    if (arg == "--lto") {
+      if (i + 1 >= argc) {
+        return std::nullopt;
+      }
+      opts.lto = std::string(argv[++i]);
+      continue;
+    }
+    if (StartsWith(arg, "--lto=")) {
+      opts.lto = std::string(arg.substr(std::string_view("--lto=").size()));
+      continue;
+    }
     if (arg == "build") {
       continue;
     }
@@ -183,6 +199,9 @@ static std::optional<CliOptions> ParseArgs(int argc, char** argv) {
   if (opts.input_path.empty()) {
     return std::nullopt;
   }
+  if (opts.lto.has_value() && *opts.lto != "thin" && *opts.lto != "full") {
+    return std::nullopt;
+  }
   return opts;
 }
 
@@ -325,10 +344,11 @@ struct ModuleCodegen {
   cursive0::syntax::ModulePath path;
   std::string path_key;
   cursive0::codegen::IRDecls decls;
-  std::unordered_map<std::string, cursive0::analysis::TypeRef> value_types;
-  std::unordered_map<std::string, cursive0::codegen::DerivedValueInfo> derived_values;
+  cursive0::codegen::ValueTypeTable value_types;
+  cursive0::codegen::DerivedValueTable derived_values;
   std::uint64_t temp_counter = 0;
   std::unordered_map<std::string, cursive0::analysis::TypeRef> drop_glue_types;
+  std::unordered_set<std::string> drop_glue_external;
   std::optional<std::string> main_symbol;
 };
 
@@ -381,6 +401,28 @@ static bool WriteFile(const std::filesystem::path& path, std::string_view bytes)
   return true;
 }
 
+// Modules whose poison checks can be omitted (CURSIVE0_NO_POISON_ELIDE keeps
+// every check).
+static std::unordered_set<std::string> PoisonFreeModules(
+    const cursive0::analysis::InitPlan& plan) {
+  std::unordered_set<std::string> out;
+  if (std::getenv("CURSIVE0_NO_POISON_ELIDE") != nullptr) {
+    return out;
+  }
+  const auto& modules = plan.graph.modules;
+  for (std::size_t i = 0; i < modules.size() && i < plan.poison_free.size();
+       ++i) {
+    if (plan.poison_free[i]) {
+      out.insert(cursive0::core::StringOfPath(modules[i]));
+    }
+  }
+  if (std::getenv("CURSIVE0_POISON_ELIDE_STATS") != nullptr) {
+    std::cerr << "[cursivec0] poison_elide modules=" << modules.size()
+              << " poison_free=" << out.size() << "\n";
+  }
+  return out;
+}
+
 static std::optional<LLVMModuleBundle> EmitLLVMModule(
     CodegenCache& cache,
     const ModuleCodegen& module,
@@ -390,6 +432,7 @@ static std::optional<LLVMModuleBundle> EmitLLVMModule(
   cache.ctx.derived_values = module.derived_values;
   cache.ctx.temp_counter = module.temp_counter;
   cache.ctx.drop_glue_types = module.drop_glue_types;
+  cache.ctx.drop_glue_external = module.drop_glue_external;
   cache.ctx.main_symbol.reset();
   if (module.path_key == project.assembly.name) {
     cache.ctx.main_symbol = module.main_symbol;
@@ -402,7 +445,15 @@ static std::optional<LLVMModuleBundle> EmitLLVMModule(
   cursive0::codegen::LLVMEmitter emitter(
       *bundle.ctx,
       module.path_key.empty() ? "cursive_module" : module.path_key);
+  if (std::getenv("CURSIVE0_NO_COLD_PANIC") != nullptr) {
+    emitter.SetColdPanicPaths(false);
+  }
   llvm::Module* raw = emitter.EmitModule(module.decls, cache.ctx);
+  if (std::getenv("CURSIVE0_ABI_CACHE_STATS") != nullptr) {
+    const auto& stats = emitter.GetCallABICacheStats();
+    std::cerr << "[cursivec0] call_abi_cache module=" << module.path_key
+              << " hits=" << stats.hits << " misses=" << stats.misses << "\n";
+  }
   bundle.module = emitter.ReleaseModule();
   if (!raw || !bundle.module || cache.ctx.codegen_failed) {
     SPEC_RULE("LowerIR-Err");
@@ -487,6 +538,25 @@ static std::optional<std::string> EmitObjForModule(
 
   llvm::SmallVector<char, 0> buffer;
   llvm::raw_svector_ostream dest(buffer);
+
+  // LTO objects are bitcode; lld-link optimizes and generates code for the
+  // whole program. Thin objects carry a module summary so the linker can run
+  // ThinLTO (cross-module importing, parallel backends).
+  const std::string_view lto = cursive0::project::LtoMode(project);
+  if (lto != "none") {
+    if (lto == "thin") {
+      llvm::ProfileSummaryInfo psi(*bundle->module);
+      const llvm::ModuleSummaryIndex index =
+          llvm::buildModuleSummaryIndex(*bundle->module, nullptr, &psi);
+      llvm::WriteBitcodeToFile(*bundle->module, dest, false, &index,
+                               /*GenerateHash=*/true);
+    } else {
+      llvm::WriteBitcodeToFile(*bundle->module, dest);
+    }
+    SPEC_RULE("EmitObj-Ok");
+    return std::string(buffer.begin(), buffer.end());
+  }
+
   llvm::legacy::PassManager pass;
   if (machine->addPassesToEmitFile(pass, dest, nullptr,
                                    llvm::CodeGenFileType::ObjectFile)) {
@@ -572,6 +642,7 @@ static std::shared_ptr<CodegenCache> BuildCodegenCache(
     cache->ctx.init_order = typechecked.init_plan->init_order;
     cache->ctx.init_modules = typechecked.init_plan->graph.modules;
     cache->ctx.init_eager_edges = typechecked.init_plan->graph.eager_edges;
+    cache->ctx.poison_free_modules = PoisonFreeModules(*typechecked.init_plan);
   }
 
   cache->modules.reserve(sema_ctx.sigma.mods.size());
@@ -614,6 +685,21 @@ static std::shared_ptr<CodegenCache> BuildCodegenCache(
     }
   }
 
+  // Every project module is emitted and linked into one image, so each drop
+  // glue is defined by the first of them that references it and only
+  // declared by the rest.
+  if (cache->ok && std::getenv("CURSIVE0_NO_DROP_GLUE_PLAN") == nullptr) {
+    std::unordered_set<std::string> owned;
+    for (const auto& module : project.modules) {
+      auto& entry = cache->modules[cache->index[module.path]];
+      for (const auto& glue : entry.drop_glue_types) {
+        if (!owned.insert(glue.first).second) {
+          entry.drop_glue_external.insert(glue.first);
+        }
+      }
+    }
+  }
+
   return cache;
 }
 
@@ -624,11 +710,11 @@ int main(int argc, char** argv) {
 
   const auto opts = ParseArgs(argc, argv);
   if (!opts.has_value()) {
-    std::cerr << "usage: cursivec0 build <file> [--assembly <name>] [--diag-json] [--dump] [--spec-trace <path>]\n";
+    std::cerr << "usage: cursivec0 build <file> [--assembly <name>] [--lto=thin|full] [--diag-json] [--dump] [--spec-trace <path>]\n";
     return 2;
   }
   if (opts->show_help) {
-    std::cout << "cursivec0 build <file> [--assembly <name>] [--diag-json] [--dump] [--spec-trace <path>]\n";
+    std::cout << "cursivec0 build <file> [--assembly <name>] [--lto=thin|full] [--diag-json] [--dump] [--spec-trace <path>]\n";
     return 0;
   }
 
@@ -661,7 +747,8 @@ int main(int argc, char** argv) {
   }
 
   if (!HasError(diags) && project_result.project.has_value()) {
-    const auto& project = *project_result.project;
+    cursive0::project::Project project = *project_result.project;
+    project.assembly.lto = opts->lto;
     if (opts->dump_project) {
       const auto lines = cursive0::project::DumpProject(project, true);
       for (const auto& line : lines) {
@@ -812,6 +899,8 @@ int main(int argc, char** argv) {
               lower_ctx.init_order = typechecked.init_plan->init_order;
               lower_ctx.init_modules = typechecked.init_plan->graph.modules;
               lower_ctx.init_eager_edges = typechecked.init_plan->graph.eager_edges;
+              lower_ctx.poison_free_modules =
+                  PoisonFreeModules(*typechecked.init_plan);
             }
 
             if (opts->emit_ir) {
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Decoder for binary runtime spec traces.
+
+The runtime writes CURSIVE_SPEC_TRACE_RUNTIME files as batches of fixed-size
+records (see runtime/src/spec_trace.c). This script converts such a file to
+spec_trace_v1 text, ordering records by timestamp and keeping each thread's
+records in emission order.
+
+Usage:
+  python tools/spec_trace_decode.py TRACE [OUT] [--timing] [--help]
+
+Options:
+  --timing   Append the thread id and the time since the first record (in
+             microseconds) as payload fields
+  --help     Show this help message
+"""
+
+from __future__ import annotations
+
+import struct
+import sys
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+MAGIC = b"C0RTRACE"
+VERSION = 1
+BLOCK_STRING = 1
+BLOCK_RECORDS = 2
+NO_PAYLOAD = 0xFFFFFFFF
+
+HEADER = struct.Struct("<8sIIQ")
+BLOCK = struct.Struct("<IIII")
+RECORD = struct.Struct("<IIIIQ")
+
+# (ticks, sequence, thread, rule, payload)
+Record = Tuple[int, int, int, int, int]
+
+
+def encode_payload(payload: str) -> str:
+    """Escapes payload text the way core::SpecTrace does."""
+    out = []
+    for c in payload:
+        if c in "\t\n%;=":
+            out.append("%{:02X}".format(ord(c)))
+        else:
+            out.append(c)
+    return "".join(out)
+
+
+def read_trace(data: bytes) -> Tuple[int, Dict[int, str], List[Record]]:
+    if len(data) < HEADER.size:
+        raise ValueError("truncated header")
+    magic, version, record_size, freq = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("not a runtime spec trace")
+    if version != VERSION or record_size != RECORD.size:
+        raise ValueError(f"unsupported trace version {version}")
+
+    strings: Dict[int, str] = {}
+    records: List[Record] = []
+    pos = HEADER.size
+    while pos + BLOCK.size <= len(data):
+        kind, a, b, _ = BLOCK.unpack_from(data, pos)
+        pos += BLOCK.size
+        if kind == BLOCK_STRING:
+            raw = data[pos:pos + b]
+            if len(raw) != b:
+                break
+            strings[a] = raw.decode("utf-8", errors="replace")
+            pos += b
+        elif kind == BLOCK_RECORDS:
+            # a = record count; the remaining eight bytes are reserved
+            end = pos + a * RECORD.size
+            if end > len(data):
+                break
+            for off in range(pos, end, RECORD.size):
+                rule, payload, thread, _, ticks = RECORD.unpack_from(data, off)
+                records.append((ticks, len(records), thread, rule, payload))
+            pos = end
+        else:
+            raise ValueError(f"unknown block kind {kind} at offset {pos}")
+    # A partially written tail (e.g. a killed process) is dropped silently.
+    records.sort()
+    return freq, strings, records
+
+
+def format_trace(freq: int,
+                 strings: Dict[int, str],
+                 records: List[Record],
+                 timing: bool) -> str:
+    lines = ["spec_trace_v1"]
+    base = records[0][0] if records else 0
+    for ticks, _, thread, rule, payload in records:
+        rule_id = strings.get(rule, f"<unknown:{rule}>")
+        text = strings.get(payload, "") if payload != NO_PAYLOAD else ""
+        encoded = encode_payload(text)
+        if timing:
+            micros = (ticks - base) * 1_000_000 // freq if freq else ticks - base
+            extra = f"thread={thread};t_us={micros}"
+            encoded = f"{encoded};{extra}" if encoded else extra
+        lines.append(
+            f"runtime\truntime\t{rule_id}\t-\t0\t0\t0\t0\t{encoded}")
+    return "\n".join(lines) + "\n"
+
+
+def main() -> int:
+    args = sys.argv[1:]
+    if "--help" in args or not args:
+        print(__doc__)
+        return 0 if args else 1
+    timing = "--timing" in args
+    paths = [a for a in args if not a.startswith("--")]
+    if len(paths) not in (1, 2):
+        print(__doc__, file=sys.stderr)
+        return 1
+
+    try:
+        freq, strings, records = read_trace(Path(paths[0]).read_bytes())
+    except (OSError, ValueError) as e:
+        print(f"Error: {paths[0]}: {e}", file=sys.stderr)
+        return 1
+
+    text = format_trace(freq, strings, records, timing)
+    if len(paths) == 2:
+        Path(paths[1]).write_text(text, encoding="utf-8", newline="\n")
+    else:
+        sys.stdout.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())